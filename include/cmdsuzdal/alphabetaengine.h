@@ -0,0 +1,157 @@
+#if !defined CSZD_ALPHABETAENGINE_HEADER
+#define CSZD_ALPHABETAENGINE_HEADER
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "cmdsuzdal/chessengine.h"
+#include "cmdsuzdal/movepicker.h"
+#include "cmdsuzdal/nnue.h"
+#include "cmdsuzdal/threadpool.h"
+#include "cmdsuzdal/timemanager.h"
+#include "cmdsuzdal/transpositiontable.h"
+
+namespace cSzd
+{
+
+    // ------------------------------------------------------------------------
+    // AlphaBetaEngine: a chess engine that selects the move searching the
+    // tree of the legal moves with:
+    //   - iterative deepening: the position is searched at depth 1, 2, 3...
+    //     until one of the limits of the search (depth, nodes, time, mate)
+    //     is reached. The best move of the last completed iteration is played
+    //   - a negamax alpha-beta core, with the moves generated lazily and
+    //     ordered by a MovePicker (see movepicker.h): transposition table
+    //     move, captures not losing material, killer moves, quiet moves by
+    //     history score, losing captures
+    //   - a quiescence search of the captures at the leaves, to evaluate
+    //     only quiet positions (the captures losing material are skipped)
+    // The positions are evaluated by a pluggable evaluation function that
+    // returns a score in centipawns from the point of view of the side to
+    // move (by default, the incremental PeSTO evaluation, see evaluation.h).
+    // If a NNUE network is set, it replaces the evaluation function: each
+    // thread keeps a stack of NNUE accumulators, updated at each move.
+    // After each iteration, the search information (depth, nodes, nps, PV,
+    // etc.) are reported to the info callback, if any.
+    //
+    // The search can use more threads (Lazy SMP): the main thread performs
+    // the search described above, while the helper threads search the same
+    // root position at staggered depths. The threads do not communicate
+    // directly, they only share the transposition table: the helpers fill it
+    // with results that the main thread uses for its cut-offs and move
+    // ordering. The search stops when the main thread completes its search.
+    // N.B.: with more threads, the evaluation function is called
+    // concurrently by all the threads, so it shall be thread safe.
+    //
+    // The move() method searches synchronously. The startSearch() method
+    // starts the search in a background thread and returns immediately a
+    // future of the selected move; the search can be interrupted at any
+    // time with stop() (the stop flag is checked at each node), and the
+    // best move found so far is then returned. The engine shall not be
+    // used for other searches until the future is ready.
+    // The search time is allocated by a TimeManager, using the clock
+    // specified in the SearchLimits (see timemanager.h).
+    // ------------------------------------------------------------------------
+
+    // --- Scores -------------------------------------
+    constexpr int MateScore = 32000;
+    constexpr int InfiniteScore = 32001;
+    constexpr unsigned int MaxSearchDepth = 64;
+
+    // A mate score is MateScore minus the distance (in plies) of the mate
+    inline bool isMateScore(int score) { return (score > MateScore - 1000) || (score < -MateScore + 1000); }
+
+    // Simple evaluation function: the material balance
+    int materialEvaluation(const ChessBoard &cb);
+
+    // --- Search information --------------------------
+    struct SearchInfo {
+        unsigned int depth = 0;
+        int score = 0;
+        std::uint64_t nodes = 0;
+        std::uint64_t nps = 0;
+        std::chrono::milliseconds time {0};
+        std::vector<ChessMove> pv;
+        std::vector<std::uint64_t> threadNodes;     // nodes searched by each thread
+    };
+
+    // --- The engine ----------------------------------
+    class AlphaBetaEngine: public ChessEngine
+    {
+        public:
+            explicit AlphaBetaEngine(std::size_t hashSizeMB = 16, unsigned int numThreads = 1);
+            ~AlphaBetaEngine();
+
+            ChessMove move(const ChessBoard &cb);
+            std::future<ChessMove> startSearch(const ChessBoard &cb);
+            void stop() { stopSearch = true; }
+
+            void setThreads(unsigned int numThreads);
+            unsigned int threads() const { return static_cast<unsigned int>(states.size()); }
+
+            void setLimits(const SearchLimits &l) { limits = l; }
+            const SearchLimits &searchLimits() const { return limits; }
+            void setEvaluator(int (*e)(const ChessBoard &)) { evaluator = e; }
+            // The network is not owned by the engine (nullptr to use the
+            // evaluation function again)
+            void setNetwork(const NNUE *n) { network = (n && n->isLoaded()) ? n : nullptr; }
+            void setInfoCallback(std::function<void(const SearchInfo &)> cb) { infoCallback = cb; }
+
+            // Information about the last completed iteration of the last search
+            const SearchInfo &lastSearchInfo() const { return info; }
+            TranspositionTable &transpositionTable() { return tt; }
+
+        private:
+            // The state of the search of a thread: the board is modified
+            // executing and undoing the moves. The nodes counter is written
+            // only by its thread, but it is read also by the other ones
+            struct SearchState {
+                ChessBoard board;
+                std::atomic<std::uint64_t> nodes {0};
+                std::uint64_t keys[MaxSearchDepth + 1] = {};
+                ChessMove pv[MaxSearchDepth + 1][MaxSearchDepth + 1];
+                unsigned int pvLength[MaxSearchDepth + 1] = {};
+                NNUEAccumulator accumulators[MaxSearchDepth + 1];
+                ChessMove killers[MaxSearchDepth + 1][NumKillers];
+                HistoryTable history;
+
+                void countNode() { nodes.store(nodes.load(std::memory_order_relaxed) + 1,
+                                               std::memory_order_relaxed); }
+            };
+
+            void prepareSearch(const ChessBoard &cb);
+            ChessMove searchMove(const ChessBoard &cb);
+            ChessMove iterativeDeepening(SearchState &s, unsigned int threadNdx, ChessMove bestMove);
+            int search(SearchState &s, int alpha, int beta, unsigned int depth, unsigned int ply);
+            int quiescence(SearchState &s, int alpha, int beta, unsigned int ply);
+            UndoInfo doMove(SearchState &s, const ChessMove &m, unsigned int ply) const;
+            void updateQuietMoveStats(SearchState &s, const ChessMove &m, unsigned int depth, unsigned int ply) const;
+            int evaluate(const SearchState &s, unsigned int ply) const;
+            bool isRepetition(const SearchState &s, unsigned int ply) const;
+            void checkLimits(const SearchState &s);
+            std::uint64_t totalNodes() const;
+
+            SearchLimits limits;
+            int (*evaluator)(const ChessBoard &) = pestoEvaluation;
+            const NNUE *network = nullptr;
+            std::function<void(const SearchInfo &)> infoCallback;
+            TranspositionTable tt;
+            SearchInfo info;
+            std::vector<std::unique_ptr<SearchState>> states;
+            std::unique_ptr<ThreadPool> helpers;
+
+            TimeManager timeManager;
+            std::atomic<bool> stopSearch {false};
+            std::thread searchThread;
+    };
+
+}  // namespace cSzd
+
+#endif // #if !defined CSZD_ALPHABETAENGINE_HEADER
@@ -1,12 +1,19 @@
 #if !defined CSZD_BBDEFINES_HEADER
 #define CSZD_BBDEFINES_HEADER
 
-#include <bitset>
+#include <array>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace cSzd
 {
 
-    using BitBoardState = std::bitset<64>;
+    // The state of a BitBoard is a plain 64 bit word: bit n represents
+    // the cell n (a1 = bit 0, h8 = bit 63, see the Cell enum below)
+    using BitBoardState = std::uint64_t;
 
     // These enums could be moved inside the BitBoard class, but we prefer to
     // avoid this for the moment to simplify code development. If for example
@@ -49,7 +56,7 @@ namespace cSzd
     };
 
     // Bitboard important definitions
-    const BitBoardState EmptyBB{};
+    constexpr BitBoardState EmptyBB{};
 
     // Ranks Masks --- These are the rank indexes of the board:
     //     _________________________
@@ -63,7 +70,7 @@ namespace cSzd
     // r1|  0  0  0  0  0  0  0  0 |
     //     -------------------------
     //     fa fb fc fd fe ff fg fh
-    const BitBoardState RanksBB[]{
+    constexpr BitBoardState RanksBB[]{
         0x00000000000000FFULL,
         0x00000000000000FFULL << 8,
         0x00000000000000FFULL << 16,
@@ -87,7 +94,7 @@ namespace cSzd
     // r1|  0  1  2  3  4  5  6  7 |
     //    -------------------------
     //     fa fb fc fd fe ff fg fh
-    const BitBoardState FilesBB[]{
+    constexpr BitBoardState FilesBB[]{
         0x0101010101010101ULL,
         0x0101010101010101ULL << 1,
         0x0101010101010101ULL << 2,
@@ -113,7 +120,7 @@ namespace cSzd
     //     fa fb fc fd fe ff fg fh
     // and can be computed with the following formula:
     //   file_index - rank_index + 7
-    const BitBoardState DiagsBB[]{
+    constexpr BitBoardState DiagsBB[]{
         0x0100000000000000ULL, //  0
         0x0201000000000000ULL, //  1
         0x0402010000000000ULL, //  2
@@ -146,7 +153,7 @@ namespace cSzd
     //     fa fb fc fd fe ff fg fh
     // and can be computed with the following formula:
     //   file_index + rank_index
-    const BitBoardState AntiDiagsBB[]{
+    constexpr BitBoardState AntiDiagsBB[]{
         0x0000000000000001ULL, //  0
         0x0000000000000102ULL, //  1
         0x0000000000010204ULL, //  2
@@ -165,21 +172,21 @@ namespace cSzd
         0 // for invalid antidiagonal
     };
 
-    const BitBoardState DiagonalBB{0x8040201008040201ULL};
-    const BitBoardState AntiDiagonalBB{0x0102040810204080ULL};
-    const BitBoardState BothDiagonalsBB{DiagonalBB | AntiDiagonalBB};
+    constexpr BitBoardState DiagonalBB{0x8040201008040201ULL};
+    constexpr BitBoardState AntiDiagonalBB{0x0102040810204080ULL};
+    constexpr BitBoardState BothDiagonalsBB{DiagonalBB | AntiDiagonalBB};
 
-    const BitBoardState AllCellsBB{0xFFFFFFFFFFFFFFFFULL};
-    const BitBoardState AllBlackCellsBB{0xAA55AA55AA55AA55ULL};
-    const BitBoardState AllWhiteCellsBB = ~AllBlackCellsBB;
+    constexpr BitBoardState AllCellsBB{0xFFFFFFFFFFFFFFFFULL};
+    constexpr BitBoardState AllBlackCellsBB{0xAA55AA55AA55AA55ULL};
+    constexpr BitBoardState AllWhiteCellsBB = ~AllBlackCellsBB;
 
     // ------
     // center of board can be defined with the intersection of files d,e and ranks 4,5
-    const BitBoardState BoardCenterBB = (RanksBB[r_4] | RanksBB[r_5]) &
+    constexpr BitBoardState BoardCenterBB = (RanksBB[r_4] | RanksBB[r_5]) &
                                           (FilesBB[f_d] | FilesBB[f_e]);
 
     // West shift clear matrix
-    const BitBoardState WestShiftClearMask[]{
+    constexpr BitBoardState WestShiftClearMask[]{
         FilesBB[0] | FilesBB[1] | FilesBB[2] | FilesBB[3] | FilesBB[4] | FilesBB[5] | FilesBB[6],
         FilesBB[0] | FilesBB[1] | FilesBB[2] | FilesBB[3] | FilesBB[4] | FilesBB[5],
         FilesBB[0] | FilesBB[1] | FilesBB[2] | FilesBB[3] | FilesBB[4],
@@ -188,7 +195,7 @@ namespace cSzd
         FilesBB[0] | FilesBB[1],
         FilesBB[0]};
     // East shift clear matrix
-    const BitBoardState EastShiftClearMask[]{
+    constexpr BitBoardState EastShiftClearMask[]{
         FilesBB[1] | FilesBB[2] | FilesBB[3] | FilesBB[4] | FilesBB[5] | FilesBB[6] | FilesBB[7],
         FilesBB[2] | FilesBB[3] | FilesBB[4] | FilesBB[5] | FilesBB[6] | FilesBB[7],
         FilesBB[3] | FilesBB[4] | FilesBB[5] | FilesBB[6] | FilesBB[7],
@@ -197,7 +204,7 @@ namespace cSzd
         FilesBB[6] | FilesBB[7],
         FilesBB[7]};
     // North shift clear matrix
-    const BitBoardState NorthShiftClearMask[]{
+    constexpr BitBoardState NorthShiftClearMask[]{
         RanksBB[1] | RanksBB[2] | RanksBB[3] | RanksBB[4] | RanksBB[5] | RanksBB[6] | RanksBB[7],
         RanksBB[2] | RanksBB[3] | RanksBB[4] | RanksBB[5] | RanksBB[6] | RanksBB[7],
         RanksBB[3] | RanksBB[4] | RanksBB[5] | RanksBB[6] | RanksBB[7],
@@ -206,7 +213,7 @@ namespace cSzd
         RanksBB[6] | RanksBB[7],
         RanksBB[7]};
     // South shift clear matrix
-    const BitBoardState SouthShiftClearMask[]{
+    constexpr BitBoardState SouthShiftClearMask[]{
         RanksBB[0] | RanksBB[1] | RanksBB[2] | RanksBB[3] | RanksBB[4] | RanksBB[5] | RanksBB[6],
         RanksBB[0] | RanksBB[1] | RanksBB[2] | RanksBB[3] | RanksBB[4] | RanksBB[5],
         RanksBB[0] | RanksBB[1] | RanksBB[2] | RanksBB[3] | RanksBB[4],
@@ -215,6 +222,120 @@ namespace cSzd
         RanksBB[0] | RanksBB[1],
         RanksBB[0]};
 
+    // -------------------------------------------------------------------------
+    // Leaper attack tables (King, Knight, Pawns). The tables are generated at
+    // compile time: each entry is the BitBoard state of the cells attacked by
+    // the piece placed in the cell used as index. The first index of the
+    // PawnAttacks table is the color of the pawn (0 = white pawns, attacking
+    // towards north, 1 = black pawns, attacking towards south, the same values
+    // of the ArmyColor enum)
+    using AttacksTable = std::array<BitBoardState, 64>;
+
+    // Returns the state with the cells reached from c using the given steps
+    // (each step is a pair {stepNorth, stepEast}). Steps that go outside
+    // the board are ignored
+    template <std::size_t N>
+    constexpr BitBoardState leaperAttacks(unsigned int c, const int (&steps)[N][2])
+    {
+        BitBoardState bbs = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+            int r = static_cast<int>(c >> 3) + steps[i][0];
+            int f = static_cast<int>(c & 7) + steps[i][1];
+            if ((r >= 0) && (r < 8) && (f >= 0) && (f < 8))
+                bbs |= 1ULL << (r * 8 + f);
+        }
+        return bbs;
+    }
+
+    template <std::size_t N>
+    constexpr AttacksTable leaperAttacksTable(const int (&steps)[N][2])
+    {
+        AttacksTable table{};
+        for (unsigned int c = 0; c < 64; ++c)
+            table[c] = leaperAttacks(c, steps);
+        return table;
+    }
+
+    constexpr int KingSteps[8][2]{
+        {1, -1}, {1, 0}, {1, 1}, {0, -1}, {0, 1}, {-1, -1}, {-1, 0}, {-1, 1}};
+    constexpr int KnightSteps[8][2]{
+        {2, 1}, {1, 2}, {-1, 2}, {-2, 1}, {-2, -1}, {-1, -2}, {1, -2}, {2, -1}};
+    constexpr int WhitePawnSteps[2][2]{{1, -1}, {1, 1}};
+    constexpr int BlackPawnSteps[2][2]{{-1, -1}, {-1, 1}};
+
+    inline constexpr AttacksTable KingAttacks = leaperAttacksTable(KingSteps);
+    inline constexpr AttacksTable KnightAttacks = leaperAttacksTable(KnightSteps);
+    inline constexpr std::array<AttacksTable, 2> PawnAttacks{
+        leaperAttacksTable(WhitePawnSteps),
+        leaperAttacksTable(BlackPawnSteps)};
+
+    // -------------------------------------------------------------------------
+    // Bit manipulation primitives. These are built on the compiler
+    // intrinsics (popcnt, tzcnt/bsf, lzcnt/bsr) when available, with a
+    // portable fallback for the other compilers.
+    // N.B.: lsb() and msb() shall not be called with an empty state
+    inline unsigned int popCount(BitBoardState bbs)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned int>(__builtin_popcountll(bbs));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        return static_cast<unsigned int>(__popcnt64(bbs));
+#else
+        // SWAR population count
+        bbs = bbs - ((bbs >> 1) & 0x5555555555555555ULL);
+        bbs = (bbs & 0x3333333333333333ULL) + ((bbs >> 2) & 0x3333333333333333ULL);
+        bbs = (bbs + (bbs >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return static_cast<unsigned int>((bbs * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    // Index of the least significant active bit
+    inline unsigned int lsb(BitBoardState bbs)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned int>(__builtin_ctzll(bbs));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long ndx;
+        _BitScanForward64(&ndx, bbs);
+        return static_cast<unsigned int>(ndx);
+#else
+        // De Bruijn multiplication on the isolated least significant bit
+        constexpr unsigned int DeBruijnIndex[64] = {
+             0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+            62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+            63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+            46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+        };
+        return DeBruijnIndex[((bbs & (~bbs + 1)) * 0x03F79D71B4CB0A89ULL) >> 58];
+#endif
+    }
+
+    // Index of the most significant active bit
+    inline unsigned int msb(BitBoardState bbs)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - static_cast<unsigned int>(__builtin_clzll(bbs));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long ndx;
+        _BitScanReverse64(&ndx, bbs);
+        return static_cast<unsigned int>(ndx);
+#else
+        unsigned int ndx = 0;
+        while (bbs >>= 1)
+            ++ndx;
+        return ndx;
+#endif
+    }
+
+    // Returns the index of the least significant active bit, and
+    // resets it in the passed state
+    inline unsigned int popLsb(BitBoardState &bbs)
+    {
+        unsigned int ndx = lsb(bbs);
+        bbs &= bbs - 1;
+        return ndx;
+    }
+
     // Given file and rank returns the cell
     Cell toCell(File f, Rank r);
 
@@ -255,17 +376,15 @@ namespace cSzd
     BitBoardState diagonalsMask(const Cell &c);
     BitBoardState queenMask(const Cell &c);
 
-    // conversion from string functions
+    // conversion from string functions (the conversions of the cell names
+    // are in cellnames.h)
     File toFile(const char &f);
     Rank toRank(const char &r);
-    Cell toCell(const std::string_view c);
     File prevFile(File f);
     File nextFile(File f);
     Rank prevRank(Rank r);
     Rank nextRank(Rank r);
 
-    std::string cellName(const Cell &c);
-
 } // namespace cSzd
 
 #endif // if !defined CSZD_BBDEFINES_HEADER
@@ -1,7 +1,9 @@
 #if !defined CSZD_BITBOARD_HEADER
 #define CSZD_BITBOARD_HEADER
 
+#include <cstddef>
 #include <iostream>
+#include <iterator>
 #include <vector>
 
 #include "cmdsuzdal/bbdefines.h"
@@ -25,6 +27,12 @@ namespace cSzd
     //     - Intersection operator ( & ): exists in two flavour:
     //     - Exclusive OR operator ( ^ ): exists in two flavour:
     //     - Equality operator ( == ): with the usual two flavour
+    // - Bit scan methods:
+    //     - popCount(), lsb(), msb(), popLsb(): built on the hardware
+    //         population count / bit scan instructions (see bbdefines.h)
+    // - Iteration over the active cells:
+    //     - for (Cell c : bb) { ... } visits only the active cells of the
+    //         BitBoard, from a1 to h8
     //
     struct BitBoard
     {
@@ -76,11 +84,52 @@ namespace cSzd
         }
 
         // Population count
-        unsigned int popCount() const { return bbs.count(); }
+        unsigned int popCount() const { return cSzd::popCount(bbs); }
 
         // Returns the active cell of the Bitboard (Assuming only one cell is active)
         Cell activeCell() const;
 
+        // Bit scan methods: return the least/most significant active
+        // cell of the BitBoard (InvalidCell if the BitBoard is empty).
+        // popLsb() also resets the returned cell in the BitBoard
+        Cell lsb() const { return (bbs != EmptyBB) ? static_cast<Cell>(cSzd::lsb(bbs)) : InvalidCell; }
+        Cell msb() const { return (bbs != EmptyBB) ? static_cast<Cell>(cSzd::msb(bbs)) : InvalidCell; }
+        Cell popLsb() { return (bbs != EmptyBB) ? static_cast<Cell>(cSzd::popLsb(bbs)) : InvalidCell; }
+
+        // Returns the raw state of the BitBoard
+        BitBoardState state() const { return bbs; }
+
+        // Forward iterator over the active cells of the BitBoard. Each step
+        // is a bit scan plus a reset of the least significant bit, so the
+        // cost of a complete iteration is proportional to popCount()
+        struct CellIterator
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Cell;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Cell *;
+            using reference = Cell;
+
+            BitBoardState toVisit;
+
+            Cell operator*() const { return static_cast<Cell>(cSzd::lsb(toVisit)); }
+            CellIterator &operator++()
+            {
+                toVisit &= toVisit - 1;
+                return *this;
+            }
+            CellIterator operator++(int)
+            {
+                CellIterator it = *this;
+                ++(*this);
+                return it;
+            }
+            friend bool operator==(const CellIterator &lhs, const CellIterator &rhs) { return lhs.toVisit == rhs.toVisit; }
+            friend bool operator!=(const CellIterator &lhs, const CellIterator &rhs) { return lhs.toVisit != rhs.toVisit; }
+        };
+        CellIterator begin() const { return CellIterator{bbs}; }
+        CellIterator end() const { return CellIterator{EmptyBB}; }
+
         // -------------------------------------------------------------------------------
         // Bitboard modification methods
         //
@@ -101,7 +150,11 @@ namespace cSzd
                 setCell(c);
         }
         void resetCell(File f, Rank r) { bbs &= ~(1ULL << (r * 8 + f)); }
-        void resetCell(Cell c) { bbs &= ~(1ULL << c); }
+        void resetCell(Cell c)
+        {
+            if (c != InvalidCell)
+                bbs &= ~(1ULL << c);
+        }
         void resetCell(const std::vector<Cell> &cells)
         {
             for (auto &c : cells)
@@ -136,7 +189,7 @@ namespace cSzd
         // -------------------------------------------------------------------------------
 
         // Check functions: return a boolean check on various conditions
-        bool isActive(Cell c) const { return ((bbs & BitBoard(c).bbs) != EmptyBB); }
+        bool isActive(Cell c) const { return (c != InvalidCell) && ((bbs >> c) & 1ULL); }
         bool isActive(File f, Rank r) const { return isActive(toCell(f, r)); }
 
         // iostream << operator
@@ -151,8 +204,7 @@ namespace cSzd
         // to allow compilation in OSX environment (Travis) with AppleCLang 9
         friend inline bool operator==(const BitBoard &lhs, const BitBoard &rhs) { return lhs.bbs == rhs.bbs; }
         friend inline bool operator!=(const BitBoard &lhs, const BitBoard &rhs) { return !operator==(lhs, rhs); }
-        // Note that we do not implement the <, <=, >= and > operators because them are not defined for bitset
-        // and because it is not clear what is the meaning of these operators for a generic BitBoard:
+        // Note that we do not implement the <, <=, >= and > operators because it is not clear what is the meaning of these operators for a generic BitBoard:
         //   - a BitBoard can be considered "less than" a second one if it has less active cells
         //     than the second, but in this case it possible to have different BitBoards
         //     that are != followind the definition of the == operator above, but that are not "<" nor ">"
@@ -0,0 +1,20 @@
+#if !defined CSZD_CELLNAMES_HEADER
+#define CSZD_CELLNAMES_HEADER
+
+#include <string>
+#include <string_view>
+
+#include "cmdsuzdal/bbdefines.h"
+
+namespace cSzd
+{
+
+    // Conversions between the cells and their names in algebraic notation
+    // (e.g. "e4"): kept apart from the bit primitives of bbdefines.h, that
+    // do not depend on the strings
+    Cell toCell(const std::string_view c);
+    std::string cellName(const Cell &c);
+
+} // namespace cSzd
+
+#endif // if !defined CSZD_CELLNAMES_HEADER
@@ -1,9 +1,14 @@
 #if !defined CSZD_CHESSBOARD_HEADER
 #define CSZD_CHESSBOARD_HEADER
 
+#include <cstdint>
+#include <string_view>
+
 #include "cmdsuzdal/army.h"
+#include "cmdsuzdal/evaluation.h"
 #include "cmdsuzdal/fenrecord.h"
 #include "cmdsuzdal/chessmove.h"
+#include "cmdsuzdal/movelist.h"
 
 // ChessBoard: initial Position!
 //   _ _ _ _ _ _ _ _
@@ -47,10 +52,42 @@ namespace cSzd
     //   ├─ BitBoard enPassantMove;
     //   ├─ ArmyColor sideToMove;
     //   ├─ unsigned int halfMoveClock;
-    //   └─ unsigned int fullMoves;
+    //   ├─ unsigned int fullMoves;
+    //   ├─ std::uint64_t hashKey;
+    //   └─ EvalAccumulator evalAccumulator;
     //
+    // The hashKey is the Zobrist key of the position (see zobrist.h): it is
+    // computed when a position is loaded and then updated incrementally by
+    // doMove() and undoMove(). If the other members are modified directly,
+    // updateHashKey() shall be called to recompute it (the key is not
+    // compared by the equality operator).
+    // The evalAccumulator (see evaluation.h) is maintained in the same way,
+    // and updateEvalAccumulator() recomputes it.
     // ------------------------------------------------------------------------
 
+    // --- Undo information ---------------------------
+    // The part of the state of a ChessBoard that is lost executing a move
+    // (and that cannot be derived from the move itself, or that is cheaper
+    // to save than to compute again): it is returned by
+    // ChessBoard::doMove() and used by ChessBoard::undoMove() to restore the
+    // position, so the moves tree can be explored without copying boards
+    struct UndoInfo {
+        BitBoardState castlingAvailability;
+        BitBoardState enPassantTargetSquare;
+        unsigned int halfMoveClock;
+        std::uint64_t hashKey;
+        EvalAccumulator evalAccumulator;
+    };
+
+    // --- Static exchange evaluation ------------------
+    // Values of the pieces (in centipawns) used to evaluate the exchanges
+    constexpr int SEEPieceValues[NumPieceTypes] = {20000, 900, 330, 320, 500, 100};   // K, Q, B, N, R, P
+
+    // --- Types of moves to generate ------------------
+    // CaptureMoves: the captures (en passant included) and the promotions
+    // QuietMoves: the other moves (castling included)
+    enum MoveGenType : unsigned int { AllMoves, CaptureMoves, QuietMoves };
+
     // --- The ChessBoard -----------------------------
     struct ChessBoard {
         // --------------------------
@@ -60,10 +97,15 @@ namespace cSzd
         BitBoard enPassantTargetSquare;
         unsigned int halfMoveClock = 0;
         unsigned int fullMoves = 1;
+        std::uint64_t hashKey = 0;
+        EvalAccumulator evalAccumulator;
 
         // --------------------------
-        explicit ChessBoard() = default;
+        explicit ChessBoard();
         explicit ChessBoard(const FENRecord &fen);
+        // If fenStr is not a valid FEN string, the chessboard is empty, with
+        // no active army (InvalidArmy), so the failure can be detected with
+        // isValid(). Use loadPosition() to get the parsing error
         explicit ChessBoard(const std::string_view fenStr);
 
         BitBoard wholeArmyBitBoard(ArmyColor a = InvalidArmy) const;
@@ -81,25 +123,60 @@ namespace cSzd
         bool isDrawnPosition() const;
         bool drawnCanBeCalledAndCannotBeRefused() const;
 
+        // Returns the cells occupied by the pieces of both the armies that
+        // attack the cell c, given the occupancy of the board: the sliders
+        // are blocked only by the cells in occupancy
+        BitBoardState attackersTo(Cell c, BitBoardState occupancy) const;
+        // Returns true if the cell c is attacked by at least one piece of
+        // the army a, with the current occupancy of the board
+        bool isAttacked(Cell c, ArmyColor a) const;
+
+        // Static Exchange Evaluation: the material balance of the sequence
+        // of captures on the destination cell of the move, started by the
+        // move. The captures are made by the least valuable attacker of
+        // each side (the sliders behind the pieces that captured join the
+        // sequence), and each side can stop the sequence when capturing
+        // again would lose material. The pins are not considered.
+        // seeGE() returns see(m) >= threshold, without computing the
+        // whole sequence
+        int see(const ChessMove &m) const;
+        bool seeGE(const ChessMove &m, int threshold) const;
+
         // --------------------------
-        void loadPosition(const FENRecord &fen);
-        void loadPosition(const std::string_view fenStr);
+        FENError loadPosition(const FENRecord &fen);
+        void loadPosition(const FENPosition &pos);
+        FENError loadPosition(const std::string_view fenStr);
+        // Writes the FEN string of the position in buf (that shall have
+        // room for MaxFENLength characters) and returns its length (the
+        // terminator excluded). The active army of the empty chessboard
+        // (InvalidArmy) is written as "-"
+        std::size_t toFEN(char *buf) const;
+        std::string toFEN() const;
+        void updateHashKey();
+        void updateEvalAccumulator();
         bool isValid() const;
 
+        void generateLegalMoves(MoveList &moves, Piece pType = InvalidPiece) const;
+        void generateLegalMoves(MoveList &moves, MoveGenType genType, Piece pType = InvalidPiece) const;
         void generateLegalMoves(std::vector<ChessMove> &moves, Piece pType = InvalidPiece) const;
-        void addPromotionMoves(std::vector<ChessMove> &moves, Cell startPos,
+        void addPromotionMoves(MoveList &moves, Cell startPos,
                                 Cell destPos, Piece takenPiece) const;
 
-        void checkForEnPassant(Cell c, std::vector<ChessMove> &moves) const;
-        void checkForCastlingMoves(std::vector<ChessMove> &moves) const;
+        void checkForEnPassant(Cell c, MoveList &moves) const;
+        void checkForCastlingMoves(MoveList &moves) const;
+        bool isLegal(const ChessMove &m) const;
 
-        void doMove(const ChessMove &m);
+        UndoInfo doMove(const ChessMove &m);
+        void undoMove(const ChessMove &m, const UndoInfo &undo);
 
         // iostream << operator
         friend std::ostream &operator<<(std::ostream &os, const ChessBoard &cb);
 
     private:
+        Cell leastValuableAttacker(BitBoardState attackers, ArmyColor a, Piece &p) const;
+        BitBoardState seeInitialOccupancy(const ChessMove &m) const;
         bool checkEnPassantTargetSquareValidity() const;
+        bool enPassantCaptureIsLegal(Cell from, Cell to) const;
 
     };
     // -----------------------------------------------
@@ -122,6 +199,11 @@ namespace cSzd
     }
     inline bool operator!=(const ChessBoard &lhs, const ChessBoard &rhs) { return !operator==(lhs, rhs); }
 
+    // Converts a SAN move (e.g. "Nbd7", "exd6", "e8=Q+", "O-O-O" or "0-0")
+    // in the only legal move that matches it (InvalidMove if no legal move
+    // or more than one matches it). The legal moves are the ones of cb
+    ChessMove resolveSANMove(const ChessBoard &cb, const MoveList &legalMoves, std::string_view san);
+
 } // namespace cSzd
 
 #endif // #if !defined CSZD_CHESSBOARD_HEADER
\ No newline at end of file
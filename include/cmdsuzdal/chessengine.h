@@ -11,6 +11,8 @@ namespace cSzd
     class ChessEngine
     {
         public:
+            virtual ~ChessEngine() = default;
+
             // Given a chess board, selects a valid move
             virtual ChessMove move(const ChessBoard &cb) = 0;
     };
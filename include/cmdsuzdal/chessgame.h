@@ -29,8 +29,8 @@ namespace cSzd
     // analysis scenario.
     //
     // The other additional requirement that we will address somewhere in the
-    // future, is the support of the PGN format for both import and export
-    // operations.
+    // future, is the support of the PGN format for export operations (the
+    // import of PGN files is provided by PGNFile, see pgnfile.h).
     //
     // ChessGame
     //   |
@@ -40,7 +40,7 @@ namespace cSzd
     //   |    The board rapresentation of the current position of the game.
     //   |    This can be the last position in a real time game, or any
     //   |    position of a game under analysis.
-    //   ├─ std::vector<ChessMove> possibleMoves
+    //   ├─ MoveList possibleMoves
     //   |    The legal moves available in the current position
     //   |
     //   |
@@ -58,7 +58,7 @@ namespace cSzd
         // -----------------------------------------------------
         FENRecord initialPosition;
         ChessBoard board;
-        std::vector<ChessMove> possibleMoves;
+        MoveList possibleMoves;
         // -----------------------------------------------------
 
         // --- Constructor(s) ----------------------------------
@@ -66,7 +66,16 @@ namespace cSzd
         return false;
     }
 
+    inline bool isACaptureOrPromotion(ChessMove cm)
+    {
+        return (chessMoveGetTakenPiece(cm) != InvalidPiece) || (chessMoveGetPromotedPiece(cm) != InvalidPiece);
+    }
+
     std::ostream &printChessMove(std::ostream &os, const ChessMove &cm);
+    // Prints the move in the UCI (long algebraic) format: start and destination
+    // cells followed by the promoted piece, if any (e.g. "e2e4", "e7e8q").
+    // InvalidMove is printed as the UCI null move ("0000")
+    std::ostream &printUCIMove(std::ostream &os, const ChessMove &cm);
 
 }
 
@@ -0,0 +1,92 @@
+#if !defined CSZD_EPD_HEADER
+#define CSZD_EPD_HEADER
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cmdsuzdal/chessboard.h"
+#include "cmdsuzdal/fenrecord.h"
+
+// Extended Position Description (EPD), from the "Portable Game Notation
+// Specification and Implementation Guide" (section 16.2):
+// an EPD record is a text line with the first four fields of the FEN record
+// (piece placement, active color, castling availability and en passant
+// target square), followed by zero or more operations. Each operation is
+// an opcode (a letter followed by letters, digits and underscores) and zero
+// or more operands separated by blanks, terminated by a semicolon. The
+// operands can be strings (between double quotes), SAN moves, numbers, etc.
+// The most used opcodes are:
+//   - bm: best moves (the moves that solve a test position)
+//   - am: avoid moves (the moves that fail a test position)
+//   - id: the identifier of the record
+//   - c0..c9: comments
+//   - hmvc and fmvn: half move clock and full move number
+//   - D1..Dn: the perft counts (number of leaf nodes of the moves tree of
+//     depth 1..n), used by the perft suites
+// e.g.:
+//   r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - bm Bxa6; id "kiwipete";
+//
+namespace cSzd
+{
+    struct EPDOperation {
+        std::string opcode;
+        std::vector<std::string> operands;  // the quotes of the strings are removed
+    };
+    inline bool operator==(const EPDOperation &lhs, const EPDOperation &rhs)
+    {
+        return (lhs.opcode == rhs.opcode) && (lhs.operands == rhs.operands);
+    }
+
+    struct EPDPerftCount {
+        unsigned int depth;
+        std::uint64_t nodes;
+    };
+
+    // -------------------------------------------------------------------------
+    // EPD record: the position and the operations of an EPD line.
+    // The operations are parsed leniently, as found in the published suites:
+    // the semicolon of the last operation can be omitted, and the records
+    // starting with a semicolon (";D1 20 ;D2 400") are accepted.
+    // The moves of the bm and am operations are in SAN (the castling can be
+    // written as O-O or 0-0) or in long algebraic notation (e2e4); the moves
+    // that are not legal in the position are ignored.
+    struct EPDRecord
+    {
+        // -------------------------------------------------------------------
+        FENPosition position {};
+        std::vector<EPDOperation> operations;
+        // -------------------------------------------------------------------
+
+        EPDRecord() = default;
+        explicit EPDRecord(const std::string_view epd) { loadRecord(epd); }
+
+        // Returns the error of the position fields, or EPDInvalidOperation
+        // (the record is then empty: no operations and no pieces)
+        FENError loadRecord(const std::string_view epd);
+
+        // The board of the position (the hmvc and fmvn operations, if
+        // present, set the move counters)
+        ChessBoard board() const;
+
+        // The first operation with the opcode, nullptr if not present
+        const EPDOperation *operation(const std::string_view opcode) const;
+        std::string id() const;
+        std::string comment(unsigned int n = 0) const;
+        std::vector<ChessMove> bestMoves() const;
+        std::vector<ChessMove> avoidMoves() const;
+        // The perft counts of the D1..Dn operations, ordered by depth
+        std::vector<EPDPerftCount> perftCounts() const;
+    };
+
+    // Converts a move in SAN (see resolveSANMove() in chessboard.h) or in
+    // long algebraic notation in a legal move of the position (InvalidMove
+    // if it is not legal or not recognized). The legal moves are the ones
+    // of cb, so that they are generated once for all the moves of a record
+    ChessMove epdMove(const ChessBoard &cb, const MoveList &legalMoves, const std::string_view move);
+    ChessMove epdMove(const ChessBoard &cb, const std::string_view move);
+
+} // namespace cSzd
+
+#endif // #if !defined CSZD_EPD_HEADER
@@ -60,6 +60,56 @@ namespace cSzd
     constexpr std::string_view FENEmptyChessBoard
        {"8/8/8/8/8/8/8/8 - - - 0 1"};
 
+    // -------------------------------------------------------------------------
+    // Single pass FEN parser: parseFEN() reads the FEN string once, filling
+    // the bitboards of the twelve piece sets and the state fields of a
+    // FENPosition, without allocating memory (the FENPosition is a plain
+    // struct). The fields can be separated by more than one blank and the
+    // half move clock and full move number can be omitted (they are then
+    // 0 and 1, as in the EPD records). The active army "-" is accepted for
+    // the empty chessboard (see FENEmptyChessBoard) and gives InvalidArmy.
+    // The en passant cell is any cell in algebraic notation (or "-").
+    // The position is not validated (see ChessBoard::isValid()): only the
+    // syntax of the string is checked. When an error is returned, the
+    // content of the FENPosition is unspecified.
+    enum FENError : unsigned int {
+        FENNoError,
+        FENMissingField,            // the string ends before the en passant field
+        FENInvalidPiece,            // invalid character in the piece placement
+        FENInvalidRank,             // a rank does not describe 8 cells
+        FENInvalidNumberOfRanks,    // the piece placement does not describe 8 ranks
+        FENInvalidActiveArmy,
+        FENInvalidCastling,
+        FENInvalidEnPassant,
+        FENInvalidHalfMoveClock,
+        FENInvalidFullMoves,
+        FENTrailingCharacters,      // unexpected characters after the last field
+        EPDInvalidOperation         // invalid operation of an EPD record (see epdrecord.h)
+    };
+    const char *fenErrorDescription(FENError e);
+
+    struct FENPosition {
+        BitBoardState pieces[2][NumPieceTypes];
+        ArmyColor sideToMove;
+        BitBoardState castlingAvailability;     // c1, g1, c8, g8 as in the ChessBoard
+        BitBoardState enPassantTargetSquare;
+        unsigned int halfMoveClock;
+        unsigned int fullMoves;
+    };
+
+    FENError parseFEN(std::string_view f, FENPosition &pos);
+    // EPD records (Extended Position Description) share the first four
+    // fields with the FEN, followed by the operations instead of the move
+    // counters: parseEPDPosition() parses the four fields (the counters are
+    // set to 0 and 1) and returns the operations, not parsed, in operations
+    FENError parseEPDPosition(std::string_view epd, FENPosition &pos, std::string_view &operations);
+
+    // Size of the buffer needed by ChessBoard::toFEN(): piece placement
+    // (64 cells and 7 separators), active army, castling, en passant, two
+    // move counters of up to 10 digits, 5 blanks and the terminator
+    constexpr std::size_t MaxFENLength = 71 + 1 + 4 + 2 + 10 + 10 + 5 + 1;
+    FENError parseFENPiecePlacement(std::string_view pp, BitBoardState (&pieces)[2][NumPieceTypes]);
+
     // -------------------------------------------------------------------------
     // base struct for FEN Record representation
     struct FENRecord
@@ -77,7 +127,7 @@ namespace cSzd
         // -------------------------
         explicit FENRecord(const std::string_view f = FENInitialStandardPosition);
 
-        void loadPosition(const std::string_view f);
+        FENError loadPosition(const std::string_view f);
 
         // -------------------------
         const std::string_view value() { return std::string_view {fen.c_str()}; }
@@ -89,10 +139,10 @@ namespace cSzd
         unsigned int fullMoves() const { return fm; }
 
         const BitBoard extractBitBoard(ArmyColor color = InvalidArmy, Piece piece = InvalidPiece) const;
-
-    private:
-        static const std::string pieceSetFENCharacters(ArmyColor c, Piece p);
-
+        // Fills all the piece sets and the state fields in one pass. If the
+        // FEN string is not valid, the position is the empty chessboard
+        // and the error is returned
+        FENError extractPosition(FENPosition &pos) const;
     };
     inline bool operator==(const FENRecord &lhs, const FENRecord &rhs)
     {
@@ -0,0 +1,72 @@
+#if !defined CSZD_MOVELIST_HEADER
+#define CSZD_MOVELIST_HEADER
+
+#include <cassert>
+#include <cstddef>
+
+#include "cmdsuzdal/chessmove.h"
+
+namespace cSzd
+{
+
+    // ------------------------------------------------------------------------
+    // MoveList is a list of ChessMoves with a fixed capacity and inline
+    // storage: it can be allocated on the stack and its usage never involves
+    // the heap. The capacity (256) is above the maximum number of legal
+    // moves in a chess position (218), so a MoveList can always contain all
+    // the moves generated by the ChessBoard::generateLegalMoves() method.
+    // The interface is a subset of the std::vector one (push_back(), size(),
+    // operator[], iterators...), so a MoveList can be used in range-for
+    // loops and with the standard algorithms.
+    // N.B.: the capacity is checked (with an assert, so only in the debug
+    // builds) when a move is added.
+    // ------------------------------------------------------------------------
+
+    // --- The MoveList ------------------------------
+    struct MoveList {
+        // --------------------------
+        using value_type = ChessMove;
+        using size_type = std::size_t;
+        using iterator = ChessMove *;
+        using const_iterator = const ChessMove *;
+
+        static constexpr size_type Capacity = 256;
+
+        // --------------------------
+        // The moves storage is intentionally left uninitialized: only
+        // the first numMoves elements are meaningful
+        MoveList() {}
+
+        // --------------------------
+        void push_back(const ChessMove &m)
+        {
+            assert(numMoves < Capacity);
+            moves[numMoves++] = m;
+        }
+        void pop_back() { --numMoves; }
+        void clear() { numMoves = 0; }
+
+        size_type size() const { return numMoves; }
+        bool empty() const { return numMoves == 0; }
+        static constexpr size_type capacity() { return Capacity; }
+
+        ChessMove &operator[](size_type ndx) { return moves[ndx]; }
+        const ChessMove &operator[](size_type ndx) const { return moves[ndx]; }
+        ChessMove &back() { return moves[numMoves - 1]; }
+        const ChessMove &back() const { return moves[numMoves - 1]; }
+
+        iterator begin() { return moves; }
+        iterator end() { return moves + numMoves; }
+        const_iterator begin() const { return moves; }
+        const_iterator end() const { return moves + numMoves; }
+
+    private:
+        size_type numMoves = 0;
+        union {
+            ChessMove moves[Capacity];
+        };
+    };
+
+} // namespace cSzd
+
+#endif // #if !defined CSZD_MOVELIST_HEADER
@@ -0,0 +1,98 @@
+#if !defined CSZD_MOVEPICKER_HEADER
+#define CSZD_MOVEPICKER_HEADER
+
+#include "cmdsuzdal/chessboard.h"
+
+namespace cSzd
+{
+
+    // --- History of the quiet moves -------------------
+    // The scores of the quiet moves (by army, start and destination cells)
+    // that caused beta cut-offs in the search. The scores are kept in
+    // [-MaxHistoryScore, MaxHistoryScore]: each update moves the score
+    // towards the bound, by a fraction of the bonus that decreases as the
+    // score approaches it
+    constexpr int MaxHistoryScore = 16384;
+
+    struct HistoryTable {
+        int scores[2][64][64] = {};
+
+        void clear() { *this = HistoryTable{}; }
+        int score(ArmyColor a, const ChessMove &m) const
+        {
+            return scores[a][chessMoveGetStartingCell(m)][chessMoveGetDestinationCell(m)];
+        }
+        void update(ArmyColor a, const ChessMove &m, int bonus)
+        {
+            int &s = scores[a][chessMoveGetStartingCell(m)][chessMoveGetDestinationCell(m)];
+            bonus = (bonus > MaxHistoryScore) ? MaxHistoryScore : ((bonus < -MaxHistoryScore) ? -MaxHistoryScore : bonus);
+            s += bonus - s * (bonus < 0 ? -bonus : bonus) / MaxHistoryScore;
+        }
+    };
+
+    // The killer moves: quiet moves that caused a beta cut-off in a
+    // sibling position (same ply of the search)
+    constexpr unsigned int NumKillers = 2;
+
+    // ------------------------------------------------------------------------
+    // MovePicker: returns the legal moves of a position one at a time, in the
+    // order in which they should be searched, generating them lazily in
+    // stages:
+    //   1. the move of the transposition table (only validated, not
+    //      generated with the others)
+    //   2. the captures and the promotions that do not lose material
+    //      according to the static exchange evaluation, most valuable
+    //      victim first (least valuable attacker first)
+    //   3. the killer moves, if they are legal quiet moves in the position
+    //   4. the other quiet moves, ordered by their history score
+    //   5. the captures losing material
+    // The moves of a stage are generated only when the moves of the previous
+    // stages have been returned, so when the first moves cause a cut-off the
+    // other ones are never generated. Each move is returned only once.
+    //
+    // The quiescence picker (constructed without killers and history)
+    // returns only the moves of the first two stages.
+    // nextMove() returns InvalidMove when there are no more moves.
+    // ------------------------------------------------------------------------
+    enum MovePickerStage : unsigned int {
+        TTMoveStage, CapturesGenerationStage, GoodCapturesStage, KillersStage,
+        QuietsGenerationStage, QuietsStage, BadCapturesStage, DoneStage
+    };
+
+    class MovePicker
+    {
+        public:
+            // Picker of all the legal moves (killers and history can be nullptr)
+            MovePicker(const ChessBoard &cb, const ChessMove &ttMove,
+                       const ChessMove *killers, const HistoryTable *history);
+            // Picker of the captures and promotions not losing material
+            MovePicker(const ChessBoard &cb, const ChessMove &ttMove);
+
+            ChessMove nextMove();
+
+            MovePickerStage stage() const { return currentStage; }
+            // Number of moves generated (the transposition table and
+            // killer moves are validated, not generated)
+            unsigned int movesGenerated() const { return numGenerated; }
+
+        private:
+            ChessMove pickBest();
+            bool isKiller(const ChessMove &m) const;
+
+            const ChessBoard &board;
+            ChessMove ttMove;
+            ChessMove killers[NumKillers] = {InvalidMove, InvalidMove};
+            const HistoryTable *history = nullptr;
+            bool capturesOnly;
+
+            MovePickerStage currentStage = TTMoveStage;
+            unsigned int numGenerated = 0;
+            unsigned int current = 0;
+            MoveList moves;
+            int scores[MoveList::Capacity];
+            MoveList badCaptures;
+    };
+
+} // namespace cSzd
+
+#endif // #if !defined CSZD_MOVEPICKER_HEADER
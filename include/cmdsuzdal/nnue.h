@@ -0,0 +1,142 @@
+#if !defined CSZD_NNUE_HEADER
+#define CSZD_NNUE_HEADER
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "cmdsuzdal/chessboard.h"
+
+namespace cSzd
+{
+
+    // ------------------------------------------------------------------------
+    // NNUE: an "efficiently updatable neural network" evaluating positions
+    // on the CPU. The network has the HalfKP architecture:
+    //
+    //   - input features: for each perspective (white and black), the
+    //     position of the king of the perspective combined with the position
+    //     of each other piece (kings excluded), 64 * 10 * 64 = 40960 binary
+    //     features. The positions are flipped vertically for the black
+    //     perspective, so the two perspectives share the same weights
+    //   - feature transformer: 40960 -> 256 int16 values per perspective (the
+    //     "accumulator"). Only a few features change with a move, so the
+    //     accumulator is updated incrementally adding and subtracting the
+    //     columns of the changed features
+    //   - the two accumulators (side to move first) are clipped to [0, 127]
+    //     and processed by three dense int8 layers: 512 -> 32 -> 32 -> 1,
+    //     with clipped ReLU activations between them
+    //
+    // The accumulators are not stored in the ChessBoard (they are large and
+    // depend on the network): the search keeps a stack of NNUEAccumulators,
+    // one per ply, and updates it with update() after each doMove().
+    //
+    // The dense layers and the accumulator updates use AVX2 or SSSE3 kernels
+    // if the CPU supports them, and plain C++ kernels otherwise.
+    //
+    // The weights are loaded from a binary file that is memory-mapped: the
+    // network uses the weights directly from the mapped memory, so they are
+    // shared by all the processes using the same file. File format (little
+    // endian, each section starts at a multiple of 64 bytes):
+    //   - header: the 8 characters "CSZDNNUE", the uint32 format version (1)
+    //     and the uint32 sizes: features, hidden, dense1, dense2
+    //   - feature transformer: int16 biases[256], int16 weights[40960][256]
+    //   - dense1: int32 biases[32], int8 weights[32][512]
+    //   - dense2: int32 biases[32], int8 weights[32][32]
+    //   - output: int32 bias, int8 weights[32]
+    // The output of the network divided by NNUEOutputScale is the score
+    // in centipawns from the point of view of the side to move.
+    // ------------------------------------------------------------------------
+
+    // --- Network structure --------------------------
+    constexpr unsigned int NNUEFeatures = 64 * 10 * 64;
+    constexpr unsigned int NNUEHiddenSize = 256;
+    constexpr unsigned int NNUEDense1Size = 32;
+    constexpr unsigned int NNUEDense2Size = 32;
+    constexpr int NNUEWeightScaleBits = 6;
+    constexpr int NNUEOutputScale = 16;
+
+    // --- File layout --------------------------------
+    constexpr std::size_t nnueAlign(std::size_t n) { return (n + 63) & ~std::size_t(63); }
+    constexpr std::size_t NNUEHeaderSize = 64;
+    constexpr std::size_t NNUEFTBiasesOffset = NNUEHeaderSize;
+    constexpr std::size_t NNUEFTWeightsOffset = NNUEFTBiasesOffset + nnueAlign(NNUEHiddenSize * 2);
+    constexpr std::size_t NNUEDense1BiasesOffset = NNUEFTWeightsOffset + nnueAlign(std::size_t(NNUEFeatures) * NNUEHiddenSize * 2);
+    constexpr std::size_t NNUEDense1WeightsOffset = NNUEDense1BiasesOffset + nnueAlign(NNUEDense1Size * 4);
+    constexpr std::size_t NNUEDense2BiasesOffset = NNUEDense1WeightsOffset + nnueAlign(NNUEDense1Size * 2 * NNUEHiddenSize);
+    constexpr std::size_t NNUEDense2WeightsOffset = NNUEDense2BiasesOffset + nnueAlign(NNUEDense2Size * 4);
+    constexpr std::size_t NNUEOutputBiasOffset = NNUEDense2WeightsOffset + nnueAlign(NNUEDense2Size * NNUEDense1Size);
+    constexpr std::size_t NNUEOutputWeightsOffset = NNUEOutputBiasOffset + nnueAlign(4);
+    constexpr std::size_t NNUEFileSize = NNUEOutputWeightsOffset + nnueAlign(NNUEDense2Size);
+
+    // Index of the feature of a piece for a perspective (a = color of the
+    // perspective, kingCell = position of its king)
+    inline unsigned int nnueFeature(ArmyColor a, Cell kingCell, ArmyColor pieceColor, Piece p, Cell c)
+    {
+        // Pieces in the feature order: Q, B, N, R, P (King is not a feature)
+        unsigned int flip = (a == WhiteArmy) ? 0 : 56;
+        unsigned int pieceNdx = ((pieceColor == a) ? 0 : 5) + (p - 1);
+        return ((((kingCell ^ flip) * 10) + pieceNdx) * 64) + (c ^ flip);
+    }
+
+    // --- The kernels ---------------------------------
+    enum NNUEKernels : unsigned int { ScalarKernels, SSSE3Kernels, AVX2Kernels };
+    // The best kernels supported by the CPU (the CSZD_NNUE_KERNELS
+    // environment variable can force "scalar" or "ssse3" kernels)
+    NNUEKernels nnueBestKernels();
+
+    // --- The accumulator -----------------------------
+    struct alignas(64) NNUEAccumulator {
+        std::int16_t values[2][NNUEHiddenSize];
+    };
+
+    // --- The network ----------------------------------
+    class NNUE
+    {
+        public:
+            NNUE() = default;
+            explicit NNUE(const std::string &fileName) { load(fileName); }
+            ~NNUE();
+            NNUE(const NNUE &) = delete;
+            NNUE &operator=(const NNUE &) = delete;
+
+            // Maps the weights file: returns false (and the network is not
+            // loaded) if the file cannot be mapped or its format is invalid
+            bool load(const std::string &fileName);
+            bool isLoaded() const { return mapping != nullptr; }
+
+            // The kernels used (by default, the best ones supported by the
+            // CPU): kernels not supported are replaced by the best ones
+            NNUEKernels kernels() const { return kern; }
+            void setKernels(NNUEKernels k);
+
+            // Computes the accumulator from scratch
+            void refresh(const ChessBoard &cb, NNUEAccumulator &acc) const;
+            // Computes the accumulator of the position cb, reached executing
+            // the move m (undo is the UndoInfo returned by doMove()) in the
+            // position with accumulator prev
+            void update(const ChessBoard &cb, const ChessMove &m, const UndoInfo &undo,
+                        const NNUEAccumulator &prev, NNUEAccumulator &acc) const;
+            // Score (centipawns) from the point of view of the side to move
+            int evaluate(const NNUEAccumulator &acc, ArmyColor sideToMove) const;
+
+        private:
+            void refreshPerspective(const ChessBoard &cb, ArmyColor a, NNUEAccumulator &acc) const;
+
+            void *mapping = nullptr;
+            std::size_t mappingSize = 0;
+            NNUEKernels kern = nnueBestKernels();
+
+            const std::int16_t *ftBiases = nullptr;
+            const std::int16_t *ftWeights = nullptr;
+            const std::int32_t *dense1Biases = nullptr;
+            const std::int8_t *dense1Weights = nullptr;
+            const std::int32_t *dense2Biases = nullptr;
+            const std::int8_t *dense2Weights = nullptr;
+            const std::int32_t *outputBias = nullptr;
+            const std::int8_t *outputWeights = nullptr;
+    };
+
+} // namespace cSzd
+
+#endif // #if !defined CSZD_NNUE_HEADER
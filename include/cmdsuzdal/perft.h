@@ -0,0 +1,79 @@
+#if !defined CSZD_PERFT_HEADER
+#define CSZD_PERFT_HEADER
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "cmdsuzdal/chessboard.h"
+#include "cmdsuzdal/threadpool.h"
+
+namespace cSzd
+{
+
+    // ------------------------------------------------------------------------
+    // Perft (performance test): walks the tree of the legal moves starting
+    // from a position up to a given depth and counts the leaf nodes. The
+    // results can be compared with well known reference values, so perft is
+    // used to verify the correctness of the move generator, and, measuring
+    // the time spent, to evaluate its performances.
+    // The "divide" variant returns the number of leaf nodes reached from
+    // each one of the legal moves of the root position: comparing these
+    // numbers with the ones of a reference implementation allows to find
+    // quickly the move generation errors.
+    //
+    // Deep perfts can be speeded up:
+    //   - caching the number of nodes of the subtrees already visited (the
+    //     same position is reached many times through different sequences
+    //     of moves) in a PerftHashTable
+    //   - splitting the tree among the threads of a ThreadPool
+    // ------------------------------------------------------------------------
+
+    // --- Perft hash table --------------------------
+    // Shared (lock-free) cache of the (position key, depth) --> nodes results.
+    // Each entry stores the data (nodes and depth) and the XOR of the key and
+    // the data: an entry written concurrently by two threads is detected
+    // because the XOR does not match the key anymore, so no locks are needed.
+    // Entries are always replaced.
+    class PerftHashTable
+    {
+        public:
+            explicit PerftHashTable(std::size_t sizeMB);
+
+            bool probe(std::uint64_t key, unsigned int depth, std::uint64_t &nodes) const;
+            void store(std::uint64_t key, unsigned int depth, std::uint64_t nodes);
+            void clear();
+
+            std::size_t numEntries() const { return mask + 1; }
+
+        private:
+            struct Entry {
+                std::atomic<std::uint64_t> keyXorData {0};
+                std::atomic<std::uint64_t> data {0};
+            };
+            std::unique_ptr<Entry[]> entries;
+            std::size_t mask = 0;
+    };
+
+    // Number of leaf nodes of the moves tree of depth "depth"
+    std::uint64_t perft(const ChessBoard &cb, unsigned int depth,
+                        PerftHashTable *hashTable = nullptr);
+
+    // --- Perft divide -------------------------------
+    struct PerftDivideEntry {
+        ChessMove move;
+        std::uint64_t nodes;
+    };
+    std::vector<PerftDivideEntry> perftDivide(const ChessBoard &cb, unsigned int depth,
+                                              PerftHashTable *hashTable = nullptr);
+    // Multithreaded version: the subtrees of the root moves (or, for deep
+    // enough perfts, the subtrees of the replies to the root moves) are
+    // counted in parallel by the threads of the pool
+    std::vector<PerftDivideEntry> perftDivide(const ChessBoard &cb, unsigned int depth,
+                                              ThreadPool &pool, PerftHashTable *hashTable = nullptr);
+
+} // namespace cSzd
+
+#endif // #if !defined CSZD_PERFT_HEADER
@@ -0,0 +1,99 @@
+#if !defined CSZD_PGNFILE_HEADER
+#define CSZD_PGNFILE_HEADER
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cmdsuzdal/chessboard.h"
+#include "cmdsuzdal/positionfile.h"
+#include "cmdsuzdal/threadpool.h"
+
+namespace cSzd
+{
+
+    // ------------------------------------------------------------------------
+    // PGN (Portable Game Notation) import.
+    // A game is a tag section ([Name "Value"] pairs, one per line) followed
+    // by the movetext: the SAN moves of the main line, with move numbers,
+    // comments ({...} and ;...), recursive variations ((...)) and numeric
+    // annotation glyphs ($n), terminated by the result (1-0, 0-1, 1/2-1/2
+    // or *). Comments, variations and glyphs are skipped; the moves are
+    // replayed from the initial position (or from the FEN tag) and resolved
+    // against the legal moves of each position (see resolveSANMove() in
+    // chessboard.h).
+    //
+    // PGNFile maps the file (like PositionFile) and decodes its games
+    // without copying the text, passing each one to a callback; the games
+    // are delimited by their tag sections (a tag line that follows the
+    // movetext of the previous game starts a new game). With a ThreadPool
+    // the file is processed in windows of a few chunks per thread: the
+    // chunks end at a game boundary and are decoded in parallel, so the
+    // callback is called concurrently by the threads (the games of a chunk
+    // in order, the chunks in any order) and shall be thread safe. Only the
+    // game being decoded by each thread is kept in memory.
+    // Each game carries its offset in the file: an interrupted import can be
+    // resumed passing the offset of the first game not imported.
+    // ------------------------------------------------------------------------
+    enum PGNError : unsigned int {
+        PGNNoError = 0,
+        PGNInvalidTag,              // a tag pair is not [Name "Value"]
+        PGNInvalidPosition,         // the FEN tag is not a valid position
+        PGNInvalidMove,             // a move is not legal (or not in SAN)
+        PGNUnterminatedComment,
+        PGNUnterminatedVariation
+    };
+    const char *pgnErrorDescription(PGNError e);
+
+    struct PGNGame {
+        std::size_t offset = 0;     // offset of the game in the file
+        std::map<std::string, std::string> tags;
+        std::vector<ChessMove> moves;
+        std::string result;         // the termination of the movetext (or the Result tag)
+    };
+
+    // Decodes the text of a game: on errors the moves decoded so far are
+    // left in the game
+    PGNError parsePGNGame(const std::string_view text, PGNGame &game);
+
+    struct PGNFileStats {
+        std::size_t games = 0;          // games decoded (and passed to the callback)
+        std::size_t moves = 0;          // moves of the decoded games
+        std::size_t errors = 0;         // games that cannot be decoded
+        PGNError firstError = PGNNoError;
+        std::size_t firstErrorOffset = 0;   // offset in the file of the first invalid game
+    };
+
+    using PGNGameCallback = std::function<void(const PGNGame &game)>;
+
+    class PGNFile
+    {
+        public:
+            PGNFile() = default;
+            explicit PGNFile(const std::string &fileName) { open(fileName); }
+
+            bool open(const std::string &fileName) { return file.open(fileName); }
+            void close() { file.close(); }
+            bool isOpen() const { return file.isOpen(); }
+            std::string_view contents() const { return file.contents(); }
+
+            // The offset of the first game starting at or after offset (the
+            // size of the file if there are no more games)
+            std::size_t nextGame(std::size_t offset) const;
+
+            // The games starting at or after startOffset
+            PGNFileStats forEach(const PGNGameCallback &callback, std::size_t startOffset = 0) const;
+            PGNFileStats forEach(const PGNGameCallback &callback, ThreadPool &pool, std::size_t startOffset = 0) const;
+
+        private:
+            std::size_t firstGame(std::size_t startOffset) const;
+
+            PositionFile file;      // the memory mapping of the file
+    };
+
+} // namespace cSzd
+
+#endif // #if !defined CSZD_PGNFILE_HEADER
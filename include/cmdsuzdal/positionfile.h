@@ -0,0 +1,87 @@
+#if !defined CSZD_POSITIONFILE_HEADER
+#define CSZD_POSITIONFILE_HEADER
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cmdsuzdal/chessboard.h"
+#include "cmdsuzdal/threadpool.h"
+
+namespace cSzd
+{
+
+    // ------------------------------------------------------------------------
+    // PositionFile: a text file of positions, one per line, in FEN (".fen"
+    // files) or EPD (".epd" files) format, loaded in bulk.
+    // The file is memory mapped and never copied: the lines are found with a
+    // vectorized (SSE2) scan of the newlines and parsed in place with the
+    // single pass FEN parser (see parseFEN() and parseEPDPosition(); the EPD
+    // operations are ignored). Blank lines are skipped, the lines that are
+    // not valid positions are counted as errors and skipped.
+    //
+    // The positions can be loaded in a vector, in the order of the file, or
+    // passed to a callback (with the offset of their line in the file)
+    // without storing them. With a ThreadPool, the file is split in chunks of
+    // whole lines parsed in parallel by the threads of the pool: the vector
+    // is still filled in the order of the file, while the callback is called
+    // concurrently by the threads (the lines of a chunk are passed in order,
+    // the chunks in any order), so it shall be thread safe.
+    // ------------------------------------------------------------------------
+    enum PositionFileFormat : unsigned int { FENFile, EPDFile };
+
+    struct PositionFileStats {
+        std::size_t lines = 0;          // not blank lines
+        std::size_t positions = 0;      // valid positions loaded
+        std::size_t errors = 0;         // lines that are not valid positions
+        FENError firstError = FENNoError;
+        std::size_t firstErrorOffset = 0;   // offset in the file of the first invalid line
+    };
+
+    using PositionCallback = std::function<void(const ChessBoard &cb, std::size_t lineOffset)>;
+
+    class PositionFile
+    {
+        public:
+            PositionFile() = default;
+            explicit PositionFile(const std::string &fileName) { open(fileName); }
+            ~PositionFile();
+            PositionFile(const PositionFile &) = delete;
+            PositionFile &operator=(const PositionFile &) = delete;
+
+            // Maps the file: returns false (and the file is not open) if it
+            // cannot be mapped. The format is EPD for the ".epd" files and
+            // FEN for the other ones (it can be changed with setFormat())
+            bool open(const std::string &fileName);
+            void close();
+            bool isOpen() const { return opened; }
+
+            PositionFileFormat format() const { return fmt; }
+            void setFormat(PositionFileFormat f) { fmt = f; }
+            // The content of the mapped file
+            std::string_view contents() const { return std::string_view(data, size); }
+
+            PositionFileStats load(std::vector<ChessBoard> &positions) const;
+            PositionFileStats load(std::vector<ChessBoard> &positions, ThreadPool &pool) const;
+            PositionFileStats forEach(const PositionCallback &callback) const;
+            PositionFileStats forEach(const PositionCallback &callback, ThreadPool &pool) const;
+
+        private:
+            std::vector<std::string_view> chunks(unsigned int numChunks) const;
+
+            bool opened = false;
+            const char *data = nullptr;
+            std::size_t size = 0;
+            void *mapping = nullptr;
+            PositionFileFormat fmt = FENFile;
+    };
+
+    // Returns the first newline in [begin, end), or end if there are no
+    // newlines (the scan uses SSE2 when available)
+    const char *findNewline(const char *begin, const char *end);
+
+} // namespace cSzd
+
+#endif // #if !defined CSZD_POSITIONFILE_HEADER
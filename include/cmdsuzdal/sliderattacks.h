@@ -0,0 +1,56 @@
+#if !defined CSZD_SLIDERATTACKS_HEADER
+#define CSZD_SLIDERATTACKS_HEADER
+
+#include "cmdsuzdal/bbdefines.h"
+
+namespace cSzd
+{
+
+    // -------------------------------------------------------------------------
+    // Slider attacks (Bishops, Rooks and Queens).
+    // Given the position of a slider and the occupancy of the board, returns the
+    // BitBoard state of the cells attacked by the slider: the cells are attacked
+    // until a busy cell is found, and the busy cell is the last attacked one
+    // (regardless of the color of the piece that occupies it).
+    //
+    // The lookups are O(1) and are based on "fancy" magic bitboards: for each
+    // cell the relevant occupancy bits (the cells of the rays of the piece,
+    // excluding the board edges) are mapped to an index of a precomputed
+    // attacks table using a multiply and shift by a "magic" number.
+    // On x86 CPUs supporting the BMI2 instruction set, the index is instead
+    // computed with a single PEXT instruction (parallel bits extract of the
+    // relevant occupancy bits). The backend is selected once, when the tables
+    // are built, querying the CPU with cpuid, and its lookup is bound to the
+    // tables, so the same binary uses the fastest path available on each
+    // machine with no check of the backend in the lookups. Setting the
+    // CSZD_SLIDER_ATTACKS environment variable to "magic" forces the magic
+    // bitboards backend.
+    // The tables are computed once, at the first lookup, in a thread safe way
+    // (also from static initializers), and after this they are shared
+    // read-only by all the threads.
+    BitBoardState bishopAttacks(Cell c, BitBoardState occupancy);
+    BitBoardState rookAttacks(Cell c, BitBoardState occupancy);
+    BitBoardState queenAttacks(Cell c, BitBoardState occupancy);
+
+    // Returns the cells strictly between two cells on the same rank, file,
+    // diagonal or anti-diagonal (EmptyBB if the cells are not aligned).
+    // Used to compute the check blocking cells and the rays of the pins
+    BitBoardState cellsBetween(Cell a, Cell b);
+
+    // Backend used to index the attacks tables, and backend supported by
+    // the CPU (the one used unless CSZD_SLIDER_ATTACKS forces the magic one)
+    enum SliderAttacksBackend : unsigned int { MagicBackend, PextBackend };
+    SliderAttacksBackend sliderAttacksBackend();
+    SliderAttacksBackend cpuSliderAttacksBackend();
+
+    // Builds new attacks tables indexed by the backend (whatever backend
+    // is used by the lookups) and checks them against a slow ray by ray
+    // computation, for every relevant occupancy of every cell: returns
+    // false on any difference, e.g. for a destructive collision of the
+    // magic indexes. The PEXT backend can be verified only if the CPU
+    // supports it (see cpuSliderAttacksBackend())
+    bool verifySliderAttacksTables(SliderAttacksBackend backend);
+
+} // namespace cSzd
+
+#endif // #if !defined CSZD_SLIDERATTACKS_HEADER
@@ -0,0 +1,67 @@
+#if !defined CSZD_THREADPOOL_HEADER
+#define CSZD_THREADPOOL_HEADER
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cSzd
+{
+
+    // ------------------------------------------------------------------------
+    // ThreadPool: a fixed set of worker threads executing the submitted tasks.
+    // Each worker has its own queue of tasks: the tasks submitted by a worker
+    // (e.g. the subtasks of a task) are pushed in its queue, the tasks
+    // submitted from outside of the pool are distributed among the queues in
+    // round robin. A worker executes the tasks of its queue in LIFO order and,
+    // when its queue is empty, "steals" the oldest tasks of the other queues
+    // (work stealing), so the load is balanced even if the tasks have very
+    // different durations.
+    //
+    // wait() blocks until all the submitted tasks are completed. If a task
+    // throws an exception, the first exception is propagated by wait().
+    // ------------------------------------------------------------------------
+    class ThreadPool
+    {
+        public:
+            explicit ThreadPool(unsigned int numThreads = std::thread::hardware_concurrency());
+            ~ThreadPool();
+            ThreadPool(const ThreadPool &) = delete;
+            ThreadPool &operator=(const ThreadPool &) = delete;
+
+            unsigned int size() const { return static_cast<unsigned int>(workers.size()); }
+
+            void submit(std::function<void()> task);
+            void wait();
+
+        private:
+            struct WorkQueue {
+                std::mutex mtx;
+                std::deque<std::function<void()>> tasks;
+            };
+
+            bool popTask(unsigned int ndx, std::function<void()> &task);
+            void workerLoop(unsigned int ndx);
+
+            std::vector<std::unique_ptr<WorkQueue>> queues;
+            std::vector<std::thread> workers;
+
+            std::mutex mtx;
+            std::condition_variable workAvailable;
+            std::condition_variable allDone;
+            std::atomic<unsigned int> queuedTasks {0};
+            std::atomic<unsigned int> pendingTasks {0};
+            std::atomic<unsigned int> nextQueue {0};
+            bool stopping = false;
+            std::exception_ptr firstException;
+    };
+
+} // namespace cSzd
+
+#endif // #if !defined CSZD_THREADPOOL_HEADER
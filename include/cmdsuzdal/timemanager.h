@@ -0,0 +1,67 @@
+#if !defined CSZD_TIMEMANAGER_HEADER
+#define CSZD_TIMEMANAGER_HEADER
+
+#include <chrono>
+#include <cstdint>
+
+#include "cmdsuzdal/chessdefines.h"
+
+namespace cSzd
+{
+
+    // --- Search limits (0 means no limit) ------------
+    struct SearchLimits {
+        unsigned int depth = 0;
+        std::uint64_t nodes = 0;
+        std::chrono::milliseconds moveTime {0};
+        // The clock of the game: remaining time and increment per move
+        // of each army, and moves to the next time control (0 if the
+        // remaining time is for the whole game)
+        std::chrono::milliseconds time[2] = {};
+        std::chrono::milliseconds increment[2] = {};
+        unsigned int movesToGo = 0;
+        // Search a mate in the specified number of moves
+        unsigned int mate = 0;
+    };
+
+    // ------------------------------------------------------------------------
+    // TimeManager: allocates the time of the search of a move. If the search
+    // is limited by a fixed time per move, that time is used (less the
+    // overhead, like the clock time). Otherwise the
+    // time is allocated from the clock of the side to move:
+    //   - the optimum time is the remaining time divided by the number of
+    //     moves to the time control (or by an estimate of the number of
+    //     moves left), plus most of the increment. A new iteration of the
+    //     search is not started after the optimum time
+    //   - the maximum time is a multiple of the optimum one, bounded by a
+    //     fraction of the remaining time: the search is stopped when it is
+    //     reached, even in the middle of an iteration
+    // A small overhead is always kept, to take into account the latency of
+    // the communications with the GUI or the server.
+    // ------------------------------------------------------------------------
+    class TimeManager
+    {
+        public:
+            static constexpr std::chrono::milliseconds MoveOverhead {10};
+            static constexpr unsigned int DefaultMovesToGo = 30;
+
+            void start(const SearchLimits &limits, ArmyColor sideToMove);
+
+            std::chrono::milliseconds elapsed() const;
+            bool isTimeLimited() const { return timeLimited; }
+            std::chrono::milliseconds optimumTime() const { return optimum; }
+            std::chrono::milliseconds maximumTime() const { return maximum; }
+
+            bool canStartNewIteration() const { return !timeLimited || (elapsed() < optimum); }
+            bool timeIsUp() const { return timeLimited && (elapsed() >= maximum); }
+
+        private:
+            std::chrono::steady_clock::time_point startTime;
+            bool timeLimited = false;
+            std::chrono::milliseconds optimum {0};
+            std::chrono::milliseconds maximum {0};
+    };
+
+} // namespace cSzd
+
+#endif // #if !defined CSZD_TIMEMANAGER_HEADER
@@ -0,0 +1,94 @@
+#if !defined CSZD_TRANSPOSITIONTABLE_HEADER
+#define CSZD_TRANSPOSITIONTABLE_HEADER
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "cmdsuzdal/chessmove.h"
+
+namespace cSzd
+{
+
+    // ------------------------------------------------------------------------
+    // TranspositionTable is the cache of the search results shared by all
+    // the search threads, addressed using the Zobrist key of the position
+    // (see ChessBoard::hashKey). For each position it stores:
+    //   - the best move found
+    //   - the score and its bound type (exact, lower or upper bound)
+    //   - the depth of the search that produced the score
+    //   - the age (the search that produced the entry)
+    //
+    // Each entry is 16 bytes long: 8 bytes for the packed data and 8 bytes
+    // for the XOR of the key and the data. Four entries are grouped in a
+    // bucket aligned to a cache line (64 bytes), so a probe reads a single
+    // cache line. The access is lock-free: an entry written concurrently by
+    // two threads contains data that do not match its key anymore, so it is
+    // simply ignored (Hyatt's "lockless hashing").
+    //
+    // The size of the table is specified in MB and can be changed with the
+    // resize() method (that shall not be called while the table is used by
+    // other threads).
+    // ------------------------------------------------------------------------
+
+    // --- Bound of the stored scores ----------------
+    enum TTBound : unsigned int {
+        NoBound = 0, UpperBound, LowerBound, ExactBound
+    };
+
+    // --- The content of an entry --------------------
+    struct TTData {
+        ChessMove move = InvalidMove;
+        int score = 0;
+        unsigned int depth = 0;
+        TTBound bound = NoBound;
+        unsigned int age = 0;
+    };
+
+    // --- The Transposition Table --------------------
+    class TranspositionTable
+    {
+        public:
+            explicit TranspositionTable(std::size_t sizeMB);
+
+            void resize(std::size_t sizeMB);
+            void clear();
+
+            // Shall be called at the beginning of each search: the entries
+            // of the older searches are replaced first
+            void newSearch();
+
+            bool probe(std::uint64_t key, TTData &data) const;
+            void store(std::uint64_t key, ChessMove move, int score,
+                       unsigned int depth, TTBound bound);
+
+            std::size_t sizeMB() const { return sizeInMB; }
+            std::size_t numEntries() const { return (mask + 1) * BucketSize; }
+            // Permille of the entries written by the current search
+            // (computed on a sample of the table, as the UCI "hashfull")
+            unsigned int hashfull() const;
+
+        private:
+            static constexpr unsigned int BucketSize = 4;
+            static constexpr unsigned int AgeMask = 0x3F;
+
+            struct Entry {
+                std::atomic<std::uint64_t> keyXorData {0};
+                std::atomic<std::uint64_t> data {0};
+            };
+            struct alignas(64) Bucket {
+                Entry entries[BucketSize];
+            };
+            static_assert(sizeof(Entry) == 16, "TranspositionTable entries shall be 16 bytes long");
+            static_assert(sizeof(Bucket) == 64, "TranspositionTable buckets shall be 64 bytes long");
+
+            std::unique_ptr<Bucket[]> buckets;
+            std::size_t mask = 0;
+            std::size_t sizeInMB = 0;
+            unsigned int age = 0;
+    };
+
+} // namespace cSzd
+
+#endif // #if !defined CSZD_TRANSPOSITIONTABLE_HEADER
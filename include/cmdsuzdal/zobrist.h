@@ -0,0 +1,84 @@
+#if !defined CSZD_ZOBRIST_HEADER
+#define CSZD_ZOBRIST_HEADER
+
+#include <cstdint>
+
+#include "cmdsuzdal/bbdefines.h"
+#include "cmdsuzdal/chessdefines.h"
+
+namespace cSzd
+{
+
+    // ------------------------------------------------------------------------
+    // Zobrist hashing: a position is identified by a 64 bits key, computed as
+    // the XOR of a set of random numbers, one for each "feature" of the
+    // position:
+    //   - each piece (of each color) in each cell
+    //   - the side to move (only if black has the move)
+    //   - each castling right (c1, g1, c8 and g8 cells of the
+    //     castlingAvailability BitBoard)
+    //   - the file of the en passant target square (if any)
+    // The random numbers are generated at compile time with a splitmix64
+    // generator, so the keys are the same on any platform and in any run.
+    // ------------------------------------------------------------------------
+
+    // --- The Zobrist random numbers ----------------
+    struct ZobristKeys {
+        std::uint64_t pieces[2][NumPieceTypes][64] = {};
+        std::uint64_t blackToMove = 0;
+        std::uint64_t castling[4] = {};         // c1, g1, c8, g8
+        std::uint64_t enPassantFile[8] = {};
+    };
+
+    constexpr std::uint64_t splitMix64(std::uint64_t &state)
+    {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    constexpr ZobristKeys zobristKeys(std::uint64_t seed)
+    {
+        ZobristKeys keys;
+        for (auto a = 0; a < 2; a++)
+            for (auto p = 0U; p < NumPieceTypes; p++)
+                for (auto c = 0; c < 64; c++)
+                    keys.pieces[a][p][c] = splitMix64(seed);
+        keys.blackToMove = splitMix64(seed);
+        for (auto &k : keys.castling)
+            k = splitMix64(seed);
+        for (auto &k : keys.enPassantFile)
+            k = splitMix64(seed);
+        return keys;
+    }
+
+    inline constexpr ZobristKeys Zobrist = zobristKeys(0x5EEDC0DE5EEDC0DEULL);
+
+    // Keys of the castling rights and of the en passant target square
+    // specified as BitBoard states (see the ChessBoard class)
+    inline std::uint64_t castlingKey(BitBoardState castlingAvailability)
+    {
+        const Cell castlingCells[4] {c1, g1, c8, g8};
+        std::uint64_t key = 0;
+        for (auto i = 0; i < 4; i++) {
+            if (castlingAvailability & (1ULL << castlingCells[i]))
+                key ^= Zobrist.castling[i];
+        }
+        return key;
+    }
+    inline std::uint64_t enPassantKey(BitBoardState enPassantTargetSquare)
+    {
+        if (enPassantTargetSquare == EmptyBB)
+            return 0;
+        return Zobrist.enPassantFile[lsb(enPassantTargetSquare) % 8];
+    }
+
+    // Computes from scratch the Zobrist key of the position (the ChessBoard
+    // keeps its key updated incrementally, see ChessBoard::hashKey)
+    struct ChessBoard;
+    std::uint64_t zobristKey(const ChessBoard &cb);
+
+} // namespace cSzd
+
+#endif // #if !defined CSZD_ZOBRIST_HEADER
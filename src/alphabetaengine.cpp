@@ -0,0 +1,403 @@
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+
+#include "cmdsuzdal/alphabetaengine.h"
+
+namespace cSzd
+{
+    // Values (in centipawns) of the pieces used by the material evaluation:
+    // the ones of SEEPieceValues (used to order the captures), but the
+    // king, that is not counted
+    static constexpr int PieceValues[NumPieceTypes] = {0, 900, 330, 320, 500, 100};
+
+    // -----------------------------------------------------------------
+    int materialEvaluation(const ChessBoard &cb)
+    {
+        int score = 0;
+        for (auto p = 0U; p < NumPieceTypes; p++) {
+            score += PieceValues[p] * (static_cast<int>(cb.armies[WhiteArmy].pieces[p].popCount()) -
+                                       static_cast<int>(cb.armies[BlackArmy].pieces[p].popCount()));
+        }
+        return (cb.sideToMove == WhiteArmy) ? score : -score;
+    }
+
+    // -----------------------------------------------------------------
+    // The mate scores are stored in the transposition table as distance
+    // from the position (and not from the root), so that they remain valid
+    // when the position is reached at a different ply
+    static int scoreToTT(int score, unsigned int ply)
+    {
+        if (score > MateScore - 1000)
+            return score + static_cast<int>(ply);
+        if (score < -MateScore + 1000)
+            return score - static_cast<int>(ply);
+        return score;
+    }
+    static int scoreFromTT(int score, unsigned int ply)
+    {
+        if (score > MateScore - 1000)
+            return score - static_cast<int>(ply);
+        if (score < -MateScore + 1000)
+            return score + static_cast<int>(ply);
+        return score;
+    }
+
+    // -----------------------------------------------------------------
+    // Lazy SMP: the helper thread i skips the depths d for which
+    // ((d + SkipPhase[i]) / SkipSize[i]) is odd, so the helpers search
+    // different depths at the same time
+    static constexpr unsigned int SkipTableSize = 20;
+    static constexpr unsigned int SkipSize[SkipTableSize]  = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+    static constexpr unsigned int SkipPhase[SkipTableSize] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+    // -----------------------------------------------------------------
+    AlphaBetaEngine::AlphaBetaEngine(std::size_t hashSizeMB, unsigned int numThreads)
+        : tt(hashSizeMB)
+    {
+        setThreads(numThreads);
+    }
+
+    AlphaBetaEngine::~AlphaBetaEngine()
+    {
+        stop();
+        if (searchThread.joinable())
+            searchThread.join();
+    }
+
+    // -----------------------------------------------------------------
+    // The main thread is the one calling move() (or the one started by
+    // startSearch()), so numThreads - 1 helper threads are created
+    void AlphaBetaEngine::setThreads(unsigned int numThreads)
+    {
+        numThreads = std::max(numThreads, 1U);
+        states.clear();
+        for (auto i = 0U; i < numThreads; i++)
+            states.push_back(std::make_unique<SearchState>());
+        helpers.reset();
+        if (numThreads > 1)
+            helpers = std::make_unique<ThreadPool>(numThreads - 1);
+    }
+
+    // -----------------------------------------------------------------
+    ChessMove AlphaBetaEngine::move(const ChessBoard &cb)
+    {
+        prepareSearch(cb);
+        return searchMove(cb);
+    }
+
+    // -----------------------------------------------------------------
+    // The search is prepared (and the clock started) before the search
+    // thread is launched, so a stop() called immediately after
+    // startSearch() is not lost
+    std::future<ChessMove> AlphaBetaEngine::startSearch(const ChessBoard &cb)
+    {
+        if (searchThread.joinable())
+            searchThread.join();
+        prepareSearch(cb);
+        std::promise<ChessMove> result;
+        std::future<ChessMove> futureMove = result.get_future();
+        searchThread = std::thread([this, cb, result = std::move(result)] () mutable {
+            result.set_value(searchMove(cb));
+        });
+        return futureMove;
+    }
+
+    void AlphaBetaEngine::prepareSearch(const ChessBoard &cb)
+    {
+        stopSearch = false;
+        timeManager.start(limits, cb.sideToMove);
+    }
+
+    // -----------------------------------------------------------------
+    ChessMove AlphaBetaEngine::searchMove(const ChessBoard &cb)
+    {
+        info = SearchInfo{};
+        tt.newSearch();
+
+        MoveList rootMoves;
+        cb.generateLegalMoves(rootMoves);
+        if (rootMoves.empty())
+            return InvalidMove;
+
+        for (auto &s : states) {
+            s->board = cb;
+            s->nodes = 0;
+            s->keys[0] = cb.hashKey;
+            if (network)
+                network->refresh(cb, s->accumulators[0]);
+            for (auto &k : s->killers)
+                std::fill(std::begin(k), std::end(k), InvalidMove);
+            s->history.clear();
+        }
+        for (auto i = 1U; i < states.size(); i++)
+            helpers->submit([this, i, &rootMoves] { iterativeDeepening(*states[i], i, rootMoves[0]); });
+
+        // If the first iteration is not completed, the first legal move is played
+        ChessMove bestMove = iterativeDeepening(*states[0], 0, rootMoves[0]);
+
+        // The main thread has completed its search: the helpers are stopped
+        stopSearch = true;
+        if (helpers)
+            helpers->wait();
+        return bestMove;
+    }
+
+    // -----------------------------------------------------------------
+    // Only the main thread (threadNdx == 0) reports the search information
+    ChessMove AlphaBetaEngine::iterativeDeepening(SearchState &s, unsigned int threadNdx, ChessMove bestMove)
+    {
+        unsigned int maxDepth = (limits.depth == 0) ? MaxSearchDepth : std::min(limits.depth, MaxSearchDepth);
+        // A mate in N moves is found with a search of 2N - 1 plies
+        if (limits.mate != 0)
+            maxDepth = std::min(maxDepth, 2 * limits.mate - 1);
+        for (auto depth = 1U; depth <= maxDepth; depth++) {
+            if (threadNdx > 0) {
+                unsigned int i = (threadNdx - 1) % SkipTableSize;
+                if (((depth + SkipPhase[i]) / SkipSize[i]) % 2 != 0)
+                    continue;
+            }
+
+            int score = search(s, -InfiniteScore, InfiniteScore, depth, 0);
+            if (stopSearch)
+                break;
+            bestMove = s.pv[0][0];
+            if (threadNdx > 0)
+                continue;
+
+            // The helper threads are still searching: each counter is read
+            // once, so the total is the sum of the reported thread nodes
+            auto elapsed = timeManager.elapsed();
+            info.depth = depth;
+            info.score = score;
+            info.threadNodes.clear();
+            for (auto &st : states)
+                info.threadNodes.push_back(st->nodes.load(std::memory_order_relaxed));
+            info.nodes = std::accumulate(info.threadNodes.begin(), info.threadNodes.end(), std::uint64_t{0});
+            info.time = elapsed;
+            info.nps = (info.nodes * 1000) / std::max<std::uint64_t>(elapsed.count(), 1);
+            info.pv.assign(&s.pv[0][0], &s.pv[0][s.pvLength[0]]);
+            if (infoCallback)
+                infoCallback(info);
+
+            // No need to search deeper if the shortest mate has been found
+            if (isMateScore(score) && (static_cast<unsigned int>(MateScore - std::abs(score)) <= depth))
+                break;
+            // An iteration that cannot be completed in the allocated time is not started
+            if (!timeManager.canStartNewIteration())
+                break;
+        }
+        return bestMove;
+    }
+
+    // -----------------------------------------------------------------
+    int AlphaBetaEngine::search(SearchState &s, int alpha, int beta, unsigned int depth, unsigned int ply)
+    {
+        s.pvLength[ply] = ply;
+        if (depth == 0)
+            return quiescence(s, alpha, beta, ply);
+
+        s.countNode();
+        checkLimits(s);
+        if (stopSearch)
+            return 0;
+
+        ChessBoard &cb = s.board;
+        if (ply > 0) {
+            if ((cb.halfMoveClock >= 100) || isRepetition(s, ply))
+                return 0;
+            if (ply >= MaxSearchDepth)
+                return evaluate(s, ply);
+        }
+
+        // Transposition table cut-off (not at the root, where the
+        // move to play is needed)
+        TTData ttData;
+        ChessMove ttMove = InvalidMove;
+        if (tt.probe(cb.hashKey, ttData)) {
+            ttMove = ttData.move;
+            if ((ply > 0) && (ttData.depth >= depth)) {
+                int ttScore = scoreFromTT(ttData.score, ply);
+                if ((ttData.bound == ExactBound) ||
+                    ((ttData.bound == LowerBound) && (ttScore >= beta)) ||
+                    ((ttData.bound == UpperBound) && (ttScore <= alpha)))
+                    return ttScore;
+            }
+        }
+
+        // The moves are generated lazily: after a cut-off on the first
+        // moves, the other ones are never generated
+        MovePicker picker(cb, ttMove, s.killers[ply], &s.history);
+        unsigned int numMoves = 0;
+        int originalAlpha = alpha;
+        int bestScore = -InfiniteScore;
+        ChessMove bestMove = InvalidMove;
+        ChessMove m;
+        while ((m = picker.nextMove()) != InvalidMove) {
+            numMoves++;
+            UndoInfo undo = doMove(s, m, ply);
+            int score = -search(s, -beta, -alpha, depth - 1, ply + 1);
+            cb.undoMove(m, undo);
+            if (stopSearch)
+                return 0;
+
+            if (score > bestScore) {
+                bestScore = score;
+                bestMove = m;
+                if (score > alpha) {
+                    alpha = score;
+                    s.pv[ply][ply] = m;
+                    for (auto n = ply + 1; n < s.pvLength[ply + 1]; n++)
+                        s.pv[ply][n] = s.pv[ply + 1][n];
+                    s.pvLength[ply] = std::max(s.pvLength[ply + 1], ply + 1);
+                    if (alpha >= beta) {
+                        if (!isACaptureOrPromotion(m))
+                            updateQuietMoveStats(s, m, depth, ply);
+                        break;
+                    }
+                }
+            }
+        }
+        if (numMoves == 0)
+            return cb.armyIsInCheck(cb.sideToMove) ? -MateScore + static_cast<int>(ply) : 0;
+
+        TTBound bound = (bestScore >= beta) ? LowerBound
+                            : ((bestScore > originalAlpha) ? ExactBound : UpperBound);
+        tt.store(cb.hashKey, bestMove, scoreToTT(bestScore, ply), depth, bound);
+        return bestScore;
+    }
+
+    // -----------------------------------------------------------------
+    // Only the captures and the promotions that do not lose material
+    // (according to the static exchange evaluation) are searched, unless
+    // the side to move is in check: in such a case all the evasions are
+    // searched
+    int AlphaBetaEngine::quiescence(SearchState &s, int alpha, int beta, unsigned int ply)
+    {
+        s.pvLength[ply] = ply;
+        s.countNode();
+        checkLimits(s);
+        if (stopSearch)
+            return 0;
+
+        ChessBoard &cb = s.board;
+        if (ply >= MaxSearchDepth)
+            return evaluate(s, ply);
+
+        bool inCheck = cb.armyIsInCheck(cb.sideToMove);
+        int bestScore = -InfiniteScore;
+        if (!inCheck) {
+            // "Stand pat": the side to move is not forced to capture
+            bestScore = evaluate(s, ply);
+            if (bestScore >= beta)
+                return bestScore;
+            alpha = std::max(alpha, bestScore);
+        }
+
+        // In check all the evasions are searched, otherwise only the
+        // captures not losing material
+        MovePicker picker = inCheck ? MovePicker(cb, InvalidMove, nullptr, nullptr)
+                                    : MovePicker(cb, InvalidMove);
+        unsigned int numMoves = 0;
+        ChessMove m;
+        while ((m = picker.nextMove()) != InvalidMove) {
+            numMoves++;
+            UndoInfo undo = doMove(s, m, ply);
+            int score = -quiescence(s, -beta, -alpha, ply + 1);
+            cb.undoMove(m, undo);
+            if (stopSearch)
+                return 0;
+
+            if (score > bestScore) {
+                bestScore = score;
+                if (score > alpha) {
+                    alpha = score;
+                    if (alpha >= beta)
+                        break;
+                }
+            }
+        }
+        if (inCheck && (numMoves == 0))
+            return -MateScore + static_cast<int>(ply);
+        return bestScore;
+    }
+
+    // -----------------------------------------------------------------
+    // Executes the move in the board of the thread, updating the keys of
+    // the search path and the NNUE accumulator of the new ply
+    UndoInfo AlphaBetaEngine::doMove(SearchState &s, const ChessMove &m, unsigned int ply) const
+    {
+        UndoInfo undo = s.board.doMove(m);
+        s.keys[ply + 1] = s.board.hashKey;
+        if (network)
+            network->update(s.board, m, undo, s.accumulators[ply], s.accumulators[ply + 1]);
+        return undo;
+    }
+
+    // A quiet move caused a beta cut-off: it becomes the first killer move
+    // of the ply and its history score is increased
+    void AlphaBetaEngine::updateQuietMoveStats(SearchState &s, const ChessMove &m,
+                                               unsigned int depth, unsigned int ply) const
+    {
+        ChessMove *killers = s.killers[ply];
+        if (killers[0] != m) {
+            for (auto i = NumKillers - 1; i > 0; i--)
+                killers[i] = killers[i - 1];
+            killers[0] = m;
+        }
+        s.history.update(s.board.sideToMove, m, static_cast<int>(depth * depth));
+    }
+
+    // The NNUE scores are bounded so that they cannot be mistaken for mates
+    int AlphaBetaEngine::evaluate(const SearchState &s, unsigned int ply) const
+    {
+        if (!network)
+            return evaluator(s.board);
+        int score = network->evaluate(s.accumulators[ply], s.board.sideToMove);
+        return std::clamp(score, -MateScore + 2000, MateScore - 2000);
+    }
+
+    // -----------------------------------------------------------------
+    // The position is a repetition of a position of the search path with
+    // the same side to move, not separated by irreversible moves
+    bool AlphaBetaEngine::isRepetition(const SearchState &s, unsigned int ply) const
+    {
+        unsigned int reversiblePlies = std::min(s.board.halfMoveClock, ply);
+        for (auto back = 4U; back <= reversiblePlies; back += 2) {
+            if (s.keys[ply - back] == s.keys[ply])
+                return true;
+        }
+        return false;
+    }
+
+    // -----------------------------------------------------------------
+    // The clock is read every 1024 nodes only. With more threads, the
+    // nodes limit is checked every 1024 nodes too, because the nodes of
+    // all the threads have to be summed
+    void AlphaBetaEngine::checkLimits(const SearchState &s)
+    {
+        std::uint64_t nodes = s.nodes.load(std::memory_order_relaxed);
+        bool checkpoint = ((nodes & 1023) == 0);
+        if (limits.nodes != 0) {
+            if (states.size() == 1) {
+                if (nodes >= limits.nodes)
+                    stopSearch = true;
+            }
+            else if (checkpoint && (totalNodes() >= limits.nodes)) {
+                stopSearch = true;
+            }
+        }
+        if (checkpoint && timeManager.timeIsUp())
+            stopSearch = true;
+    }
+
+    std::uint64_t AlphaBetaEngine::totalNodes() const
+    {
+        std::uint64_t nodes = 0;
+        for (auto &s : states)
+            nodes += s->nodes.load(std::memory_order_relaxed);
+        return nodes;
+    }
+
+}  // namespace cSzd
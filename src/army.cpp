@@ -1,4 +1,5 @@
 #include "cmdsuzdal/army.h"
+#include "cmdsuzdal/sliderattacks.h"
 
 namespace cSzd
 {
@@ -133,13 +134,8 @@ namespace cSzd
         // The cell controlled by pawns are the front left and front right
         // of each pawn. Front is north for white army, and south for black
         BitBoard bb;
-        auto foundCells = 0;
-        for (auto ndx = 0; (ndx < 64) && (foundCells < pieces[Pawn].popCount()); ndx++) {
-            if (pieces[Pawn][ndx] != 0) {
-                // pawn in position ndx
-                foundCells++;
-                bb |= singlePawnControlledCells(static_cast<Cell>(ndx));
-            }
+        for (Cell c : pieces[Pawn]) {
+            bb |= singlePawnControlledCells(c);
         }
         return bb;
     }
@@ -148,11 +144,8 @@ namespace cSzd
     // in that position, so the caller knows what it is doing...
     BitBoard Army::singlePawnControlledCells(Cell nPos) const
     {
-        if (color == WhiteArmy) {
-            return BitBoard({ne(nPos), nw(nPos)});
-        }
-        else if (color == BlackArmy) {
-            return BitBoard({se(nPos), sw(nPos)});
+        if ((color == WhiteArmy) || (color == BlackArmy)) {
+            return BitBoard(PawnAttacks[color][nPos]);
         }
         return BitBoard(EmptyBB);
     }
@@ -161,21 +154,8 @@ namespace cSzd
     BitBoard Army::knightsControlledCells(const BitBoard &intfBoard) const
     {
         BitBoard bb;
-        auto foundCells = 0;
-        for (auto ndx = 0; (ndx < 64) && (foundCells < pieces[Knight].popCount()); ndx++) {
-            if (pieces[Knight][ndx] != 0) {
-                // knight in position ndx
-                foundCells++;
-                Cell c = static_cast<const Cell>(ndx);
-                bb |= BitBoard({calcCellAfterSteps(c,  2,  1),
-                                calcCellAfterSteps(c,  1,  2),
-                                calcCellAfterSteps(c, -1,  2),
-                                calcCellAfterSteps(c, -2,  1),
-                                calcCellAfterSteps(c, -2, -1),
-                                calcCellAfterSteps(c, -1, -2),
-                                calcCellAfterSteps(c,  1, -2),
-                                calcCellAfterSteps(c,  2, -1)});
-            }
+        for (Cell c : pieces[Knight]) {
+            bb |= BitBoard(KnightAttacks[c]);
         }
         return bb;
     }
@@ -187,62 +167,12 @@ namespace cSzd
     // pieces of the enemy army (see the ChessBoard class)
     BitBoard Army::bishopsControlledCells(const BitBoard &intfBoard) const
     {
+        // The cells are controlled until a busy cell is found: the busy
+        // cell is the last controlled one (see sliderattacks.h)
         BitBoard bb;
-        BitBoard busyCells = occupiedCells() | intfBoard;
-        auto foundCells = 0;
-        for (auto ndx = 0; (ndx < 64) && (foundCells < pieces[Bishop].popCount()); ndx++) {
-            if (pieces[Bishop][ndx] != 0) {
-                foundCells++;
-                auto r = rank(static_cast<Cell>(ndx));
-                auto f = file(static_cast<Cell>(ndx));
-                // Bishop found in position ndx, (rank r, file f)
-                // Eplore left-lower side of the diagonal for controlled
-                // cells. The cells are controlled until a busy cell
-                // is found: the busy cell is the last controlled one
-                int cFile = f - 1;
-                int cRank = r - 1;
-                while (cFile >= 0 && cRank >= 0) {
-                    bb.setCell(static_cast<File>(cFile), static_cast<Rank>(cRank));
-                    if (busyCells.isActive(static_cast<File>(cFile), static_cast<Rank>(cRank))) {
-                        break;
-                    }
-                    --cFile;
-                    --cRank;
-                }
-                // Explore the right-upper side of the diagonal (same algo above)
-                cFile = f + 1;
-                cRank = r + 1;
-                while (cFile < 8 && cRank < 8) {
-                    bb.setCell(static_cast<File>(cFile), static_cast<Rank>(cRank));
-                    if (busyCells.isActive(static_cast<File>(cFile), static_cast<Rank>(cRank))) {
-                        break;
-                    }
-                    ++cFile;
-                    ++cRank;
-                }
-                // Explore the right-lower side of the antidiagonal (same algo above)
-                cFile = f + 1;
-                cRank = r - 1;
-                while (cFile < 8 && cRank >= 0) {
-                    bb.setCell(static_cast<File>(cFile), static_cast<Rank>(cRank));
-                    if (busyCells.isActive(static_cast<File>(cFile), static_cast<Rank>(cRank))) {
-                        break;
-                    }
-                    ++cFile;
-                    --cRank;
-                }
-                // Explore the left-upper side of the antidiagonal (same algo above)
-                cFile = f - 1;
-                cRank = r + 1;
-                while (cFile >= 0 && cRank < 8) {
-                    bb.setCell(static_cast<File>(cFile), static_cast<Rank>(cRank));
-                    if (busyCells.isActive(static_cast<File>(cFile), static_cast<Rank>(cRank))) {
-                        break;
-                    }
-                    --cFile;
-                    ++cRank;
-                }
-            }
+        BitBoardState busyCells = (occupiedCells() | intfBoard).state();
+        for (Cell c : pieces[Bishop]) {
+            bb |= BitBoard(bishopAttacks(c, busyCells));
         }
         return bb;
     }
@@ -257,55 +187,9 @@ namespace cSzd
     BitBoard Army::rooksControlledCells(const BitBoard &intfBoard) const
     {
         BitBoard bb;
-        BitBoard busyCells = occupiedCells() | intfBoard;
-        auto foundCells = 0;
-        for (auto ndx = 0; (ndx < 64) && (foundCells < pieces[Rook].popCount()); ndx++) {
-            if (pieces[Rook][ndx] != 0) {
-                // rook in position ndx
-                foundCells++;
-                auto r = rank(static_cast<Cell>(ndx));
-                auto f = file(static_cast<Cell>(ndx));
-                // Rook found in position ndx, (rank r, file f)
-
-                // Eplore left side of the rank for controlled
-                // cells. The cells are controlled until a busy cell
-                // is found: the busy cell is the last controlled one
-                int cFile = f - 1;
-                while (cFile >= 0) {
-                    bb.setCell(static_cast<File>(cFile), r);
-                    if (busyCells.isActive(static_cast<File>(cFile), r)) {
-                        break;
-                    }
-                    --cFile;
-                }
-                // Explore the right side of the rank (same algo above)
-                cFile = f + 1;
-                while (cFile < 8) {
-                    bb.setCell(static_cast<File>(cFile), r);
-                    if (busyCells.isActive(static_cast<File>(cFile), r)) {
-                        break;
-                    }
-                    ++cFile;
-                }
-                // Explore the lower side of the file (same algo above)
-                int cRank = r - 1;
-                while (cRank >= 0) {
-                    bb.setCell(f, static_cast<Rank>(cRank));
-                    if (busyCells.isActive(f, static_cast<Rank>(cRank))) {
-                        break;
-                    }
-                    --cRank;
-                }
-                // Explore the upper side of the file (same algo above)
-                cRank = r + 1;
-                while (cRank < 8) {
-                    bb.setCell(f, static_cast<Rank>(cRank));
-                    if (busyCells.isActive(f, static_cast<Rank>(cRank))) {
-                        break;
-                    }
-                    ++cRank;
-                }
-            }
+        BitBoardState busyCells = (occupiedCells() | intfBoard).state();
+        for (Cell c : pieces[Rook]) {
+            bb |= BitBoard(rookAttacks(c, busyCells));
         }
         return bb;
     }
@@ -319,22 +203,13 @@ namespace cSzd
     {
         // Cells controlled by Queens is the union of the cells
         // controlled by rooks and bishops in the same position
-        // of the queens. The code below is quite tricky... we have
-        // to convert bishops and rooks in pawn to mantain interference
-        // and avoid to signal wrong controlled cells
-        Army fakeArmy = *this;
-        fakeArmy.pieces[Pawn] |= fakeArmy.pieces[Bishop];
-        fakeArmy.pieces[Pawn] |= fakeArmy.pieces[Rook];
-        fakeArmy.pieces[Bishop] = pieces[Queen];
-        fakeArmy.pieces[Rook] = pieces[Queen];
-        // IMPORTANT: Please note that we cannot call directly the fakeArmy.controlledCells()
-        // method because not only it returns the wrong value in case of comples army
-        // with interferences, but also generate an infinite recursion...
-        // This is wrong:
-        //   return fakeArmy.controlledCells();
-        // This is OK:
-        return fakeArmy.bishopsControlledCells(intfBoard) |
-                fakeArmy.rooksControlledCells(intfBoard);
+        // of the queens
+        BitBoard bb;
+        BitBoardState busyCells = (occupiedCells() | intfBoard).state();
+        for (Cell c : pieces[Queen]) {
+            bb |= BitBoard(queenAttacks(c, busyCells));
+        }
+        return bb;
     }
 
     BitBoard Army::possibleMovesCellsByPieceTypeAndPosition(Piece pType,
@@ -457,10 +332,25 @@ namespace cSzd
         //   - Queens
         if (!(pieces[pType] & BitBoard(c)))
             return BitBoard(EmptyBB);
-        Army fakeArmy = *this;
-        fakeArmy.pieces[Pawn] |= (pieces[pType] ^ BitBoard(c));
-        fakeArmy.pieces[pType] = BitBoard(c);
-        return ((fakeArmy.controlledCellsByPieceType(pType, intfBoard) | occupiedCells()) ^ occupiedCells());
+        BitBoardState busyCells = (occupiedCells() | intfBoard).state();
+        BitBoardState attacks = EmptyBB;
+        switch (pType) {
+            case Queen:
+                attacks = queenAttacks(c, busyCells);
+                break;
+            case Rook:
+                attacks = rookAttacks(c, busyCells);
+                break;
+            case Bishop:
+                attacks = bishopAttacks(c, busyCells);
+                break;
+            case Knight:
+                attacks = KnightAttacks[c];
+                break;
+            default:
+                break;
+        }
+        return BitBoard(attacks) & ~occupiedCells();
     }
 
     std::ostream &operator<<(std::ostream &os, const Army &a)
@@ -1,4 +1,4 @@
-#include "cmdsuzdal/bbdefines.h"
+#include "cmdsuzdal/cellnames.h"
 
 namespace cSzd
 {
@@ -71,20 +71,7 @@ namespace cSzd
 
     BitBoardState singlecell(const Cell &c) { return (1ULL << c); }
 
-    BitBoardState neighbour(const Cell &c)
-    {
-        File f, w, e;
-        Rank r, s, n;
-        f = file(c);
-        r = rank(c);
-        w = west(c);
-        e = east(c);
-        s = south(c);
-        n = north(c);
-        return ((FilesBB[w] | FilesBB[f] | FilesBB[e]) &
-                (RanksBB[n] | RanksBB[r] | RanksBB[s])) ^
-               singlecell(c);
-    }
+    BitBoardState neighbour(const Cell &c) { return (c != InvalidCell) ? KingAttacks[c] : EmptyBB; }
 
     BitBoardState fileMask(const Cell &c) { return (FilesBB[file(c)]); }
     BitBoardState rankMask(const Cell &c) { return (RanksBB[rank(c)]); }
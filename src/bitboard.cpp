@@ -10,47 +10,30 @@ namespace cSzd
         if (popCount() != 1)
             return InvalidCell;
 
-        unsigned int ndx;
-        for (ndx = 0; ndx < 64; ndx++)
-            if (bbs[ndx] != 0)
-                break;
-
-        return static_cast<Cell>(ndx);
+        return lsb();
     }
 
     BitBoard BitBoard::neighbourCells() const
     {
         BitBoard nb;
-        auto foundCells = 0;
-        for (auto ndx = 0; (ndx < 64) && (foundCells < popCount()); ndx++) {
-            if (bbs[ndx] != 0) {
-                foundCells++;
-                nb = nb | BitBoard(neighbour(static_cast<Cell>(ndx)));
-            }
+        for (Cell c : *this) {
+            nb |= BitBoard(neighbour(c));
         }
         return nb;
     }
     BitBoard BitBoard::diagonalsCells() const
     {
         BitBoard nb;
-        auto foundCells = 0;
-        for (auto ndx = 0; (ndx < 64) && (foundCells < popCount()); ndx++) {
-            if (bbs[ndx] != 0) {
-                foundCells++;
-                nb = nb | BitBoard(diagonalsMask(static_cast<Cell>(ndx)) ^ singlecell(static_cast<Cell>(ndx)));
-            }
+        for (Cell c : *this) {
+            nb |= BitBoard(diagonalsMask(c) ^ singlecell(c));
         }
         return nb;
     }
     BitBoard BitBoard::fileRankCells() const
     {
         BitBoard nb;
-        auto foundCells = 0;
-        for (auto ndx = 0; (ndx < 64) && (foundCells < popCount()); ndx++) {
-            if (bbs[ndx] != 0) {
-                foundCells++;
-                nb = nb | BitBoard(fileRankMask(static_cast<Cell>(ndx)) ^ singlecell(static_cast<Cell>(ndx)));
-            }
+        for (Cell c : *this) {
+            nb |= BitBoard(fileRankMask(c) ^ singlecell(c));
         }
         return nb;
     }
@@ -111,7 +94,7 @@ namespace cSzd
             auto startPos = rank * 8;
             if (rank == 0) fillchar = '_';
             for (auto file = 0; file < 8; file++) {
-                os << ((bb.bbs[startPos + file] == 0) ? fillchar : 'x') << '|';
+                os << ((bb[startPos + file] == 0) ? fillchar : 'x') << '|';
             }
         }
         os << std::endl << "  a b c d e f g h" << std::endl;
@@ -120,7 +103,7 @@ namespace cSzd
 
     int BitBoard::operator[](int i) const
     {
-        return bbs[i];
+        return static_cast<int>((bbs >> i) & 1ULL);
     }
 
 
@@ -1,7 +1,18 @@
+#include <algorithm>
+
 #include "cmdsuzdal/chessboard.h"
+#include "cmdsuzdal/sliderattacks.h"
+#include "cmdsuzdal/zobrist.h"
 
 namespace cSzd
 {
+    // -----------------------------------------------------------------
+    ChessBoard::ChessBoard()
+    {
+        updateHashKey();
+        updateEvalAccumulator();
+    }
+
     // -----------------------------------------------------------------
     ChessBoard::ChessBoard(const FENRecord &fen)
     {
@@ -9,8 +20,12 @@ namespace cSzd
     }
 
     // -----------------------------------------------------------------
+    // If the string is not a valid FEN, the empty chessboard is set
     ChessBoard::ChessBoard(const std::string_view fenStr)
-        : ChessBoard(FENRecord(fenStr)) {}
+    {
+        if (loadPosition(fenStr) != FENNoError)
+            loadPosition(FENEmptyChessBoard);
+    }
 
     // -----------------------------------------------------------------
     BitBoard ChessBoard::wholeArmyBitBoard(ArmyColor a) const
@@ -36,10 +51,14 @@ namespace cSzd
 
     bool ChessBoard::armyIsInCheck(ArmyColor a) const
     {
-        // An army is in check if King position intersecates
-        // the controlled cells of the opposite army
+        // An army is in check if its King is attacked by
+        // the opposite army
         ArmyColor enemyColor = (a == WhiteArmy) ? BlackArmy : WhiteArmy;
-        return (armies[a].pieces[King] & controlledCells(enemyColor));
+        for (Cell k : armies[a].pieces[King]) {
+            if (isAttacked(k, enemyColor))
+                return true;
+        }
+        return false;
     }
     // -----------------------------------------------------------------
     ArmyColor ChessBoard::armyInCheck() const
@@ -66,7 +85,7 @@ namespace cSzd
         // If the army with the move is valid and it in check
         // and there are no valid moves, this is checkmate
         if (armyInCheck() == sideToMove && sideToMove != InvalidArmy) {
-            std::vector<ChessMove> moves;
+            MoveList moves;
             generateLegalMoves(moves);
             if (moves.size() == 0)
                 return true;
@@ -79,7 +98,7 @@ namespace cSzd
         // If the army with the move is valid and NOT in check
         // and there are no valid moves, this is stalemate
         if (armyInCheck() == InvalidArmy && sideToMove != InvalidArmy) {
-            std::vector<ChessMove> moves;
+            MoveList moves;
             generateLegalMoves(moves);
             if (moves.size() == 0)
                 return true;
@@ -138,30 +157,142 @@ namespace cSzd
     }
 
     // -----------------------------------------------------------------
-    void ChessBoard::loadPosition(const FENRecord &fen)
-    {
-        armies[WhiteArmy].pieces[King]   = fen.extractBitBoard(WhiteArmy, King);
-        armies[WhiteArmy].pieces[Queen]  = fen.extractBitBoard(WhiteArmy, Queen);
-        armies[WhiteArmy].pieces[Rook]   = fen.extractBitBoard(WhiteArmy, Rook);
-        armies[WhiteArmy].pieces[Knight] = fen.extractBitBoard(WhiteArmy, Knight);
-        armies[WhiteArmy].pieces[Bishop] = fen.extractBitBoard(WhiteArmy, Bishop);
-        armies[WhiteArmy].pieces[Pawn]   = fen.extractBitBoard(WhiteArmy, Pawn);
-        armies[BlackArmy].pieces[King]   = fen.extractBitBoard(BlackArmy, King);
-        armies[BlackArmy].pieces[Queen]  = fen.extractBitBoard(BlackArmy, Queen);
-        armies[BlackArmy].pieces[Rook]   = fen.extractBitBoard(BlackArmy, Rook);
-        armies[BlackArmy].pieces[Knight] = fen.extractBitBoard(BlackArmy, Knight);
-        armies[BlackArmy].pieces[Bishop] = fen.extractBitBoard(BlackArmy, Bishop);
-        armies[BlackArmy].pieces[Pawn]   = fen.extractBitBoard(BlackArmy, Pawn);
-        sideToMove = fen.sideToMove();
-        castlingAvailability = fen.castlingAvailability();
-        enPassantTargetSquare = fen.enPassantTargetSquare();
-        halfMoveClock = fen.halfMoveClock();
-        fullMoves = fen.fullMoves();
+    // If the record is not a valid FEN, the empty chessboard is set
+    FENError ChessBoard::loadPosition(const FENRecord &fen)
+    {
+        FENPosition pos;
+        FENError e = fen.extractPosition(pos);
+        loadPosition(pos);
+        return e;
     }
+
+    void ChessBoard::loadPosition(const FENPosition &pos)
+    {
+        for (auto a : {WhiteArmy, BlackArmy}) {
+            for (auto p = 0U; p < NumPieceTypes; p++)
+                armies[a].pieces[p] = BitBoard(pos.pieces[a][p]);
+        }
+        sideToMove = pos.sideToMove;
+        castlingAvailability = BitBoard(pos.castlingAvailability);
+        enPassantTargetSquare = BitBoard(pos.enPassantTargetSquare);
+        halfMoveClock = pos.halfMoveClock;
+        fullMoves = pos.fullMoves;
+        updateHashKey();
+        updateEvalAccumulator();
+    }
+
     // -----------------------------------------------------------------
-    void ChessBoard::loadPosition(const std::string_view fenStr)
+    // The string is parsed directly, without building a FENRecord. The
+    // empty string is the empty chessboard (as for the FENRecord). If the
+    // string is not a valid FEN, the board is not modified
+    FENError ChessBoard::loadPosition(const std::string_view fenStr)
     {
-        loadPosition(FENRecord(fenStr));
+        FENPosition pos;
+        FENError e = parseFEN(fenStr.empty() ? FENEmptyChessBoard : fenStr, pos);
+        if (e == FENNoError)
+            loadPosition(pos);
+        return e;
+    }
+
+    // -----------------------------------------------------------------
+    // Writes the decimal representation of n, returns the end of the digits
+    static char *writeFENNumber(char *buf, unsigned int n)
+    {
+        char digits[10];
+        unsigned int len = 0;
+        do {
+            digits[len++] = static_cast<char>('0' + n % 10);
+            n /= 10;
+        } while (n != 0);
+        while (len > 0)
+            *buf++ = digits[--len];
+        return buf;
+    }
+
+    // The pieces are first placed in a mailbox (one pass on the bitboards),
+    // then the ranks are written from the 8th to the 1st, visiting only the
+    // occupied cells of each rank
+    std::size_t ChessBoard::toFEN(char *buf) const
+    {
+        constexpr char PieceChars[2][NumPieceTypes] = {{'K', 'Q', 'B', 'N', 'R', 'P'},
+                                                       {'k', 'q', 'b', 'n', 'r', 'p'}};
+        char mailbox[64];
+        BitBoardState occupied = EmptyBB;
+        for (auto a : {WhiteArmy, BlackArmy}) {
+            for (auto p = 0U; p < NumPieceTypes; p++) {
+                BitBoardState bbs = armies[a].pieces[p].state();
+                occupied |= bbs;
+                while (bbs != EmptyBB)
+                    mailbox[popLsb(bbs)] = PieceChars[a][p];
+            }
+        }
+
+        char *out = buf;
+        for (int r = 7; r >= 0; r--) {
+            BitBoardState rankCells = (occupied >> (r * 8)) & 0xFF;
+            unsigned int f = 0;
+            while (rankCells != EmptyBB) {
+                unsigned int next = popLsb(rankCells);
+                if (next > f)
+                    *out++ = static_cast<char>('0' + (next - f));
+                *out++ = mailbox[r * 8 + next];
+                f = next + 1;
+            }
+            if (f < 8)
+                *out++ = static_cast<char>('0' + (8 - f));
+            *out++ = '/';
+        }
+        --out;  // no separator after the 1st rank
+
+        *out++ = ' ';
+        *out++ = (sideToMove == WhiteArmy) ? 'w' : ((sideToMove == BlackArmy) ? 'b' : '-');
+
+        *out++ = ' ';
+        char *castling = out;
+        if (castlingAvailability.isActive(g1))
+            *out++ = 'K';
+        if (castlingAvailability.isActive(c1))
+            *out++ = 'Q';
+        if (castlingAvailability.isActive(g8))
+            *out++ = 'k';
+        if (castlingAvailability.isActive(c8))
+            *out++ = 'q';
+        if (out == castling)
+            *out++ = '-';
+
+        *out++ = ' ';
+        Cell ep = enPassantTargetSquare.lsb();
+        if (ep != InvalidCell) {
+            *out++ = static_cast<char>('a' + (ep & 7));
+            *out++ = static_cast<char>('1' + (ep >> 3));
+        }
+        else {
+            *out++ = '-';
+        }
+
+        *out++ = ' ';
+        out = writeFENNumber(out, halfMoveClock);
+        *out++ = ' ';
+        out = writeFENNumber(out, fullMoves);
+        *out = '\0';
+        return static_cast<std::size_t>(out - buf);
+    }
+
+    std::string ChessBoard::toFEN() const
+    {
+        char buf[MaxFENLength];
+        return std::string(buf, toFEN(buf));
+    }
+
+    // -----------------------------------------------------------------
+    void ChessBoard::updateHashKey()
+    {
+        hashKey = zobristKey(*this);
+    }
+
+    void ChessBoard::updateEvalAccumulator()
+    {
+        evalAccumulator = computeEvalAccumulator(*this);
     }
 
     // -----------------------------------------------------------------
@@ -189,112 +320,382 @@ namespace cSzd
         if (armies[BlackArmy].numPieces() > 16) return false;
 
         // If both kings are in check, position is not valid
-        if (armyIsInCheck(WhiteArmy) && armyIsInCheck(BlackArmy)) return false;
+        bool whiteInCheck = armyIsInCheck(WhiteArmy);
+        bool blackInCheck = armyIsInCheck(BlackArmy);
+        if (whiteInCheck && blackInCheck) return false;
 
         // If king of an army is in check and move is assigned
         // to other army, position is not valid
-        if (armyIsInCheck(WhiteArmy) && sideToMove == BlackArmy) return false;
-        if (armyIsInCheck(BlackArmy) && sideToMove == WhiteArmy) return false;
+        if (whiteInCheck && sideToMove == BlackArmy) return false;
+        if (blackInCheck && sideToMove == WhiteArmy) return false;
 
         // lastly check en passant cell validity
         return checkEnPassantTargetSquareValidity();
     }
 
+    // ---------------------------------------------------------------------------------
+    // Returns the cells occupied by the pieces of the army of color aColor that attack
+    // the cell c, given the occupancy of the whole board
+    static BitBoardState attackersOf(const Army &a, ArmyColor aColor, Cell c, BitBoardState occupancy)
+    {
+        // A pawn of the army attacks c if it is in one of the cells
+        // attacked by a pawn of the other color placed in c
+        ArmyColor otherColor = (aColor == WhiteArmy) ? BlackArmy : WhiteArmy;
+        return (PawnAttacks[otherColor][c] & a.pieces[Pawn].state()) |
+               (KnightAttacks[c] & a.pieces[Knight].state()) |
+               (KingAttacks[c] & a.pieces[King].state()) |
+               (bishopAttacks(c, occupancy) & (a.pieces[Bishop] | a.pieces[Queen]).state()) |
+               (rookAttacks(c, occupancy) & (a.pieces[Rook] | a.pieces[Queen]).state());
+    }
+
+    // ---------------------------------------------------------------------------------
+    BitBoardState ChessBoard::attackersTo(Cell c, BitBoardState occupancy) const
+    {
+        return (attackersOf(armies[WhiteArmy], WhiteArmy, c, occupancy) |
+                attackersOf(armies[BlackArmy], BlackArmy, c, occupancy)) & occupancy;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // The attacks are looked up in reverse, from the cell: the cheap leapers
+    // lookups are performed first, and the sliders are checked only if needed
+    bool ChessBoard::isAttacked(Cell c, ArmyColor a) const
+    {
+        if (a == InvalidArmy)
+            return false;
+        const Army &army = armies[a];
+        ArmyColor otherColor = (a == WhiteArmy) ? BlackArmy : WhiteArmy;
+        if ((PawnAttacks[otherColor][c] & army.pieces[Pawn].state()) ||
+            (KnightAttacks[c] & army.pieces[Knight].state()) ||
+            (KingAttacks[c] & army.pieces[King].state()))
+            return true;
+        BitBoardState diagonalSliders = (army.pieces[Bishop] | army.pieces[Queen]).state();
+        BitBoardState straightSliders = (army.pieces[Rook] | army.pieces[Queen]).state();
+        if ((diagonalSliders | straightSliders) == EmptyBB)
+            return false;
+        BitBoardState occupancy = wholeArmyBitBoard().state();
+        return (bishopAttacks(c, occupancy) & diagonalSliders) ||
+               (rookAttacks(c, occupancy) & straightSliders);
+    }
+
+    // ---------------------------------------------------------------------------------
+    // Static Exchange Evaluation
+    // ---------------------------------------------------------------------------------
+    // Returns the cell of the least valuable piece of the army a among the attackers
+    // (and its type in p), or InvalidCell if the army has no attackers
+    Cell ChessBoard::leastValuableAttacker(BitBoardState attackers, ArmyColor a, Piece &p) const
+    {
+        for (auto pt : {Pawn, Knight, Bishop, Rook, Queen, King}) {
+            BitBoardState bbs = attackers & armies[a].pieces[pt].state();
+            if (bbs != EmptyBB) {
+                p = pt;
+                return static_cast<Cell>(lsb(bbs));
+            }
+        }
+        return InvalidCell;
+    }
+
+    // The occupancy of the board after the move, without the piece moved
+    // (and without the pawn captured en passant)
+    BitBoardState ChessBoard::seeInitialOccupancy(const ChessMove &m) const
+    {
+        Cell startCell = chessMoveGetStartingCell(m);
+        Cell destCell = chessMoveGetDestinationCell(m);
+        BitBoardState occupancy = wholeArmyBitBoard().state() & ~singlecell(startCell);
+        if ((chessMoveGetMovedPiece(m) == Pawn) && (chessMoveGetTakenPiece(m) == Pawn) &&
+            (enPassantTargetSquare.state() == singlecell(destCell)))
+            occupancy &= ~singlecell(toCell(file(destCell), rank(startCell)));
+        return occupancy;
+    }
+
+    // The "swap list" algorithm: gain[d] is the balance (from the point of view of
+    // the side performing the capture d) if the sequence is stopped after the
+    // capture d. Each gain is stored speculatively, before knowing if the capture
+    // is possible, and the list is then evaluated backwards, allowing each side to
+    // stop the sequence
+    int ChessBoard::see(const ChessMove &m) const
+    {
+        if (isACastlingMove(m))
+            return 0;
+
+        Cell destCell = chessMoveGetDestinationCell(m);
+        Piece taken = chessMoveGetTakenPiece(m);
+        Piece promoted = chessMoveGetPromotedPiece(m);
+        Piece onDestCell = (promoted != InvalidPiece) ? promoted : chessMoveGetMovedPiece(m);
+
+        int gain[34];
+        unsigned int d = 0;
+        gain[0] = (taken != InvalidPiece) ? SEEPieceValues[taken] : 0;
+        if (promoted != InvalidPiece)
+            gain[0] += SEEPieceValues[promoted] - SEEPieceValues[Pawn];
+
+        BitBoardState occupancy = seeInitialOccupancy(m);
+        BitBoardState attackers = attackersTo(destCell, occupancy);
+        BitBoardState diagonalSliders = (armies[WhiteArmy].pieces[Bishop] | armies[WhiteArmy].pieces[Queen] |
+                                         armies[BlackArmy].pieces[Bishop] | armies[BlackArmy].pieces[Queen]).state();
+        BitBoardState straightSliders = (armies[WhiteArmy].pieces[Rook] | armies[WhiteArmy].pieces[Queen] |
+                                         armies[BlackArmy].pieces[Rook] | armies[BlackArmy].pieces[Queen]).state();
+        ArmyColor side = sideToMove;
+        while (d < 32) {
+            d++;
+            gain[d] = SEEPieceValues[onDestCell] - gain[d - 1];
+            side = (side == WhiteArmy) ? BlackArmy : WhiteArmy;
+            Piece p;
+            Cell c = leastValuableAttacker(attackers, side, p);
+            if (c == InvalidCell)
+                break;
+            // The king cannot capture a defended piece
+            ArmyColor other = (side == WhiteArmy) ? BlackArmy : WhiteArmy;
+            if ((p == King) && (attackers & armies[other].occupiedCells().state()))
+                break;
+            onDestCell = p;
+            // Remove the attacker, adding the sliders behind it
+            occupancy &= ~singlecell(c);
+            attackers |= (bishopAttacks(destCell, occupancy) & diagonalSliders) |
+                         (rookAttacks(destCell, occupancy) & straightSliders);
+            attackers &= occupancy;
+        }
+        // The last gain is speculative (the capture was not possible)
+        while (--d > 0)
+            gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+        return gain[0];
+    }
+
+    // The balance is compared to the threshold at each step: the exchange is
+    // stopped as soon as the result is known (the "res" side wins it)
+    bool ChessBoard::seeGE(const ChessMove &m, int threshold) const
+    {
+        if (isACastlingMove(m))
+            return 0 >= threshold;
+
+        Cell destCell = chessMoveGetDestinationCell(m);
+        Piece taken = chessMoveGetTakenPiece(m);
+        Piece promoted = chessMoveGetPromotedPiece(m);
+        Piece onDestCell = (promoted != InvalidPiece) ? promoted : chessMoveGetMovedPiece(m);
+
+        // swap is the amount that the opponent shall gain to make the
+        // result less than the threshold
+        int swap = ((taken != InvalidPiece) ? SEEPieceValues[taken] : 0) - threshold;
+        if (promoted != InvalidPiece)
+            swap += SEEPieceValues[promoted] - SEEPieceValues[Pawn];
+        if (swap < 0)
+            return false;
+        swap = SEEPieceValues[onDestCell] - swap;
+        if (swap <= 0)
+            return true;
+
+        BitBoardState occupancy = seeInitialOccupancy(m);
+        BitBoardState attackers = attackersTo(destCell, occupancy);
+        BitBoardState diagonalSliders = (armies[WhiteArmy].pieces[Bishop] | armies[WhiteArmy].pieces[Queen] |
+                                         armies[BlackArmy].pieces[Bishop] | armies[BlackArmy].pieces[Queen]).state();
+        BitBoardState straightSliders = (armies[WhiteArmy].pieces[Rook] | armies[WhiteArmy].pieces[Queen] |
+                                         armies[BlackArmy].pieces[Rook] | armies[BlackArmy].pieces[Queen]).state();
+        ArmyColor side = sideToMove;
+        bool res = true;
+        while (true) {
+            side = (side == WhiteArmy) ? BlackArmy : WhiteArmy;
+            ArmyColor other = (side == WhiteArmy) ? BlackArmy : WhiteArmy;
+            Piece p;
+            Cell c = leastValuableAttacker(attackers, side, p);
+            if (c == InvalidCell)
+                break;
+            res = !res;
+            // The king can capture only if the piece is not defended
+            if (p == King)
+                return (attackers & armies[other].occupiedCells().state()) ? !res : res;
+            swap = SEEPieceValues[p] - swap;
+            if (swap < static_cast<int>(res))
+                break;
+            occupancy &= ~singlecell(c);
+            attackers |= (bishopAttacks(destCell, occupancy) & diagonalSliders) |
+                         (rookAttacks(destCell, occupancy) & straightSliders);
+            attackers &= occupancy;
+        }
+        return res;
+    }
+
     // ---------------------------------------------------------------------------------
     // Generates all the legal moves for the Army starting from the current position
     // taking into account an opponent Army. The opponent army is necessary to generate
     // the move, but also to check for the legality of moves: illegal moves are those
     // that places the King in check. If a valid Piece type is specified, only the
     // moves for that Piece type are generated, otherwise, the moves for all the
-    // pieces are generated
-    void ChessBoard::generateLegalMoves(std::vector<ChessMove> &moves, Piece pType) const
+    // pieces are generated.
+    // The legality of the moves is not verified executing each move and checking
+    // if the king is in check afterwards: the checks and the pins are computed
+    // only once for the position, and only the legal moves are generated.
+    // The type of the moves to generate can be restricted to the captures (and the
+    // promotions) or to the quiet moves (see MoveGenType)
+    void ChessBoard::generateLegalMoves(MoveList &moves, Piece pType) const
     {
-        ChessBoard fakeCB = *this;
+        generateLegalMoves(moves, AllMoves, pType);
+    }
+
+    void ChessBoard::generateLegalMoves(MoveList &moves, MoveGenType genType, Piece pType) const
+    {
+        // Clear the vector of moves
+        moves.clear();
+
+        // If side to move is not valid (White or Black), returns nothing
+        if ((sideToMove != WhiteArmy) && (sideToMove != BlackArmy))
+            return;
 
         ArmyColor opponentColor = (sideToMove == WhiteArmy) ? BlackArmy : WhiteArmy;
+        const Army &army = armies[sideToMove];
+        const Army &opponent = armies[opponentColor];
+        BitBoardState occupancy = (army.occupiedCells() | opponent.occupiedCells()).state();
+
         // Iterates over all Pieces of the specified type.
         // If pType is InvalidPiece, all the piece are considered
-        BitBoard moveBB;
-        auto foundPieces = 0;
         BitBoard bbToCheck;
         if (pType == InvalidPiece) {
-            bbToCheck = armies[sideToMove].occupiedCells();
+            bbToCheck = army.occupiedCells();
         }
         else {
-            bbToCheck = armies[sideToMove].pieces[pType];
+            bbToCheck = army.pieces[pType];
         }
 
-        // Clear the vector of moves
-        moves.clear();
-
-        // If side to move is not valid (White or Black), returns nothing
-        if ((sideToMove != WhiteArmy) && (sideToMove != BlackArmy))
+        // Legality constraints, derived from the position of the king:
+        //  - checkMask: the cells where a piece other than the king can move.
+        //    If the king is not in check, all the cells; if it is in check by
+        //    a single piece, the cell of the checker and the cells between the
+        //    checker and the king; in case of double check, no cells at all
+        //  - pinned: the pieces that cannot leave the ray between the king and
+        //    an opponent slider; pinRays contains the cells where each pinned
+        //    piece can move (the cells of the ray, pinner included)
+        // Without a king (not a valid position) there are no constraints. With
+        // more than one king no move is generated (position is not valid too)
+        BitBoardState checkMask = AllCellsBB;
+        BitBoardState pinned = EmptyBB;
+        BitBoardState pinRays[64];
+        Cell kingPos = army.getKingPosition();
+        if (kingPos != InvalidCell) {
+            BitBoardState checkers = attackersOf(opponent, opponentColor, kingPos, occupancy);
+            if (checkers != EmptyBB) {
+                if (popCount(checkers) == 1) {
+                    Cell checker = static_cast<Cell>(lsb(checkers));
+                    checkMask = checkers | cellsBetween(kingPos, checker);
+                }
+                else {
+                    checkMask = EmptyBB;
+                }
+            }
+            // Opponent sliders that would attack the king if the pieces of
+            // the army were not on the board: if there is only one piece
+            // between the king and the slider, and it belongs to the army,
+            // it is pinned
+            BitBoardState opponentOccupancy = opponent.occupiedCells().state();
+            BitBoardState snipers =
+                (bishopAttacks(kingPos, opponentOccupancy) & (opponent.pieces[Bishop] | opponent.pieces[Queen]).state()) |
+                (rookAttacks(kingPos, opponentOccupancy) & (opponent.pieces[Rook] | opponent.pieces[Queen]).state());
+            while (snipers) {
+                Cell sniper = static_cast<Cell>(popLsb(snipers));
+                BitBoardState blockers = cellsBetween(kingPos, sniper) & occupancy;
+                if ((popCount(blockers) == 1) && (blockers & army.occupiedCells().state())) {
+                    pinned |= blockers;
+                    pinRays[lsb(blockers)] = cellsBetween(kingPos, sniper) | singlecell(sniper);
+                }
+            }
+        }
+        else if (army.pieces[King].popCount() > 1) {
             return;
+        }
+
+        // Destination cells allowed by the type of the moves to generate (the
+        // pawns moving to the last rank are promotions, generated with the captures)
+        BitBoardState promotionRank = (sideToMove == WhiteArmy) ? RanksBB[r_8] : RanksBB[r_1];
+        BitBoardState targets = AllCellsBB;
+        BitBoardState pawnTargets = AllCellsBB;
+        if (genType == CaptureMoves) {
+            targets = opponent.occupiedCells().state();
+            pawnTargets = targets | promotionRank;
+        }
+        else if (genType == QuietMoves) {
+            targets = ~opponent.occupiedCells().state();
+            pawnTargets = targets & ~promotionRank;
+        }
 
         // Search for moves...
-        for (auto startPos = 0; (startPos < 64) && (foundPieces < bbToCheck.popCount()); startPos++) {
-            if (bbToCheck[startPos] != 0) {
-                // piece found in position startPos
-                foundPieces++;
-                pType = armies[sideToMove].getPieceInCell(static_cast<Cell>(startPos));
-                moveBB = armies[sideToMove].possibleMovesCellsByPieceTypeAndPosition(pType,
-                                static_cast<Cell>(startPos), armies[opponentColor].occupiedCells());
-                auto foundMove = 0;
-                for (auto destPos = 0; (destPos < 64) && (foundMove < moveBB.popCount()); destPos++) {
-                    if (moveBB[destPos] != 0) {
-                        ++foundMove;
-                        auto takenPiece = armies[opponentColor].getPieceInCell(static_cast<Cell>(destPos));
-                        // Possible move found:
-                        //    Piece of type pType from startPos --- to ---> destPos, taking takenPiece (can be InvalidPiece)
-                        // We need to validate the move: after the move the king shall not be in check
-                        // otherwise the move is not valid and shall be discarded
-                        // ...move the knight
-                        fakeCB.armies[sideToMove].pieces[pType] ^=
-                                BitBoard({static_cast<Cell>(startPos), static_cast<Cell>(destPos)});
-                        // ...remove the piece from the opponent army if necessary
-                        if (takenPiece != InvalidPiece) {
-                            fakeCB.armies[opponentColor].pieces[takenPiece] ^= BitBoard(static_cast<Cell>(destPos));
-                        }
-                        // ... check for check
-                        if (!fakeCB.armyIsInCheck(sideToMove)) {
-                            // If at the end the move is valid, it can be added to the vector of moves.
-                            // If the piece is a pawn and the destination position is on the last rank,
-                            // this is a promotion, so the moves to be added are four: one for each type
-                            // of promotion (Queen, Rook, Bishop, Knight). To add this kind of moves, we
-                            // use a dedicated function
-                            if ((pType == Pawn) && (((sideToMove == WhiteArmy) && (rank(static_cast<Cell>(destPos)) == r_8)) ||
-                                                    ((sideToMove == BlackArmy) && (rank(static_cast<Cell>(destPos)) == r_1)))) {
-                                // promotion moves
-                                addPromotionMoves(moves, static_cast<Cell>(startPos),
-                                                    static_cast<Cell>(destPos),
-                                                    takenPiece);
-
-                            } else {
-                                // normal move
-                                moves.push_back(chessMove(pType,
-                                    static_cast<Cell>(startPos), static_cast<Cell>(destPos),
-                                    takenPiece));
-                            }
-                        }
-                        // ...restore the armies
-                        fakeCB.armies[sideToMove].pieces[pType] ^=
-                                BitBoard({static_cast<Cell>(startPos), static_cast<Cell>(destPos)});
-                        if (takenPiece != InvalidPiece) {
-                            fakeCB.armies[opponentColor].pieces[takenPiece] ^= BitBoard(static_cast<Cell>(destPos));
-                        }
-                    }
+        for (Cell startPos : bbToCheck) {
+            // piece found in position startPos
+            pType = army.getPieceInCell(startPos);
+            BitBoard moveBB = army.possibleMovesCellsByPieceTypeAndPosition(pType,
+                                    startPos, opponent.occupiedCells());
+            if (pType == King) {
+                // The king cannot move in a cell attacked by an opponent piece;
+                // the king is removed from the occupancy to take into account
+                // the sliders attacking it along the direction of its movement
+                BitBoardState noKingOccupancy = occupancy ^ singlecell(startPos);
+                BitBoardState attackedCells = EmptyBB;
+                for (Cell destPos : moveBB) {
+                    if (attackersOf(opponent, opponentColor, destPos, noKingOccupancy) != EmptyBB)
+                        attackedCells |= singlecell(destPos);
                 }
-                if (pType == Pawn) {
-                    checkForEnPassant(static_cast<Cell>(startPos), moves);
-                }
-                if (pType == King) {
-                    checkForCastlingMoves(moves);
+                moveBB &= ~BitBoard(attackedCells);
+            }
+            else {
+                BitBoardState legalCells = checkMask;
+                if (pinned & singlecell(startPos))
+                    legalCells &= pinRays[startPos];
+                moveBB &= BitBoard(legalCells);
+            }
+            moveBB &= BitBoard((pType == Pawn) ? pawnTargets : targets);
+            for (Cell destPos : moveBB) {
+                auto takenPiece = opponent.getPieceInCell(destPos);
+                // Legal move found:
+                //    Piece of type pType from startPos --- to ---> destPos, taking takenPiece (can be InvalidPiece)
+                // If the piece is a pawn and the destination position is on the last rank,
+                // this is a promotion, so the moves to be added are four: one for each type
+                // of promotion (Queen, Rook, Bishop, Knight). To add this kind of moves, we
+                // use a dedicated function
+                if ((pType == Pawn) && (((sideToMove == WhiteArmy) && (rank(destPos) == r_8)) ||
+                                        ((sideToMove == BlackArmy) && (rank(destPos) == r_1)))) {
+                    // promotion moves
+                    addPromotionMoves(moves, startPos, destPos, takenPiece);
+
+                } else {
+                    // normal move
+                    moves.push_back(chessMove(pType, startPos, destPos, takenPiece));
                 }
             }
+            if ((pType == Pawn) && (genType != QuietMoves)) {
+                checkForEnPassant(startPos, moves);
+            }
+            if ((pType == King) && (genType != CaptureMoves)) {
+                checkForCastlingMoves(moves);
+            }
         }
     }
 
-    void ChessBoard::addPromotionMoves(std::vector<ChessMove> &moves, Cell startPos,
+    // ---------------------------------------------------------------------------------
+    // Returns true if the move is one of the legal moves of the position: used to
+    // validate the moves coming from other positions (e.g. the moves stored in the
+    // transposition tables), so only the moves of the moved piece type are generated
+    bool ChessBoard::isLegal(const ChessMove &m) const
+    {
+        Piece movedPiece = chessMoveGetMovedPiece(m);
+        if ((m == InvalidMove) || (movedPiece >= NumPieceTypes) || (sideToMove > BlackArmy) ||
+            !armies[sideToMove].pieces[movedPiece].isActive(chessMoveGetStartingCell(m)))
+            return false;
+        MoveList moves;
+        generateLegalMoves(moves, AllMoves, movedPiece);
+        for (auto &lm : moves) {
+            if (lm == m)
+                return true;
+        }
+        return false;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // Same as above, but the moves are returned in a std::vector (more convenient
+    // but slower, due to the dynamic allocation of the vector storage)
+    void ChessBoard::generateLegalMoves(std::vector<ChessMove> &moves, Piece pType) const
+    {
+        MoveList mList;
+        generateLegalMoves(mList, pType);
+        moves.assign(mList.begin(), mList.end());
+    }
+
+    void ChessBoard::addPromotionMoves(MoveList &moves, Cell startPos,
                                        Cell destPos, Piece takenPiece) const
     {
         // add all the possible promotions
@@ -304,7 +705,7 @@ namespace cSzd
          moves.push_back(chessMove(Pawn, startPos, destPos, takenPiece, Knight));
     }
 
-    void ChessBoard::checkForEnPassant(Cell c, std::vector<ChessMove> &moves) const
+    void ChessBoard::checkForEnPassant(Cell c, MoveList &moves) const
     {
         Rank pawnRank;
         File pawnFile;
@@ -319,14 +720,16 @@ namespace cSzd
                     // checks the file to the left of the pawn
                     if (c + 7 == enPassantCell) {
                         // en passant move!
-                        moves.push_back(chessMove(Pawn, c, enPassantCell, Pawn));
+                        if (enPassantCaptureIsLegal(c, enPassantCell))
+                            moves.push_back(chessMove(Pawn, c, enPassantCell, Pawn));
                     }
                 }
                 if (pawnFile < f_h) {
                     // checks the file to the right of the pawn
                     if (c + 9 == enPassantCell) {
                         // en passant move!
-                        moves.push_back(chessMove(Pawn, c, enPassantCell, Pawn));
+                        if (enPassantCaptureIsLegal(c, enPassantCell))
+                            moves.push_back(chessMove(Pawn, c, enPassantCell, Pawn));
                     }
                 }
             }
@@ -337,14 +740,16 @@ namespace cSzd
                     // checks the file to the right of the pawn
                     if (c - 9 == enPassantCell) {
                         // en passant move!
-                        moves.push_back(chessMove(Pawn, c, enPassantCell, Pawn));
+                        if (enPassantCaptureIsLegal(c, enPassantCell))
+                            moves.push_back(chessMove(Pawn, c, enPassantCell, Pawn));
                     }
                 }
                 if (pawnFile < f_h) {
                     // checks the file to the left of the pawn
                     if (c - 7 == enPassantCell) {
                         // en passant move!
-                        moves.push_back(chessMove(Pawn, c, enPassantCell, Pawn));
+                        if (enPassantCaptureIsLegal(c, enPassantCell))
+                            moves.push_back(chessMove(Pawn, c, enPassantCell, Pawn));
                     }
                 }
             }
@@ -352,7 +757,7 @@ namespace cSzd
     }
 
     // ---------------------------------------------------------------------------------
-    void ChessBoard::checkForCastlingMoves(std::vector<ChessMove> &moves) const
+    void ChessBoard::checkForCastlingMoves(MoveList &moves) const
     {
         // This function checks is king castling moves are currently possible.
         // For the castling to be possible, the appropriate Cells in the
@@ -363,8 +768,8 @@ namespace cSzd
         //  - At least one of the cells when the king pass, or the destination
         //    cell of the king is under check of any enemy piece
 
-        // If any king is in check we are unlucky...
-        if (armyInCheck() != InvalidArmy)
+        // If the king is in check we are unlucky...
+        if (armyIsInCheck(sideToMove))
             return;
 
         if (sideToMove == WhiteArmy) {
@@ -373,7 +778,8 @@ namespace cSzd
                 // 1. Friend or foe pieces occupy one of f1 and g1
                 // 2. During movement, the king shall not occupy any
                 //    foe controlled cell
-                if (!((wholeArmyBitBoard() | controlledCells(BlackArmy)) & BitBoard({f1, g1}))) {
+                if (!(wholeArmyBitBoard() & BitBoard({f1, g1})) &&
+                    !isAttacked(f1, BlackArmy) && !isAttacked(g1, BlackArmy)) {
                     // ***** Add white 0-0 ******
                     moves.push_back(chessMove(King, e1, g1));
                 }
@@ -382,8 +788,10 @@ namespace cSzd
                 // White 0-0-0 is still possible, checks for inhibit factors
                 // 1. Friend or foe pieces occupy one of b1, c1, d1
                 // 2. During movement, the king shall not occupy any
-                //    foe controlled cell
-                if (!((wholeArmyBitBoard() | controlledCells(BlackArmy)) & BitBoard({b1, c1, d1}))) {
+                //    foe controlled cell (b1 can be controlled: the
+                //    king does not pass on it)
+                if (!(wholeArmyBitBoard() & BitBoard({b1, c1, d1})) &&
+                    !isAttacked(c1, BlackArmy) && !isAttacked(d1, BlackArmy)) {
                     // Cells are free and not controlled by enemy
                     // ***** Add white 0-0-0 ******
                     moves.push_back(chessMove(King, e1, c1));
@@ -396,7 +804,8 @@ namespace cSzd
                 // 1. Friend or foe pieces occupy one of f8 and g8
                 // 2. During movement, the king shall not occupy any
                 //    foe controlled cell
-                if (!((wholeArmyBitBoard() | controlledCells(WhiteArmy)) & BitBoard({f8, g8}))) {
+                if (!(wholeArmyBitBoard() & BitBoard({f8, g8})) &&
+                    !isAttacked(f8, WhiteArmy) && !isAttacked(g8, WhiteArmy)) {
                     // ***** Add black 0-0 ******
                     moves.push_back(chessMove(King, e8, g8));
                 }
@@ -405,8 +814,10 @@ namespace cSzd
                 // Black 0-0-0 is still possible, checks for inhibit factors
                 // 1. Friend or foe pieces occupy one of b8, c8, d8
                 // 2. During movement, the king shall not occupy any
-                //    foe controlled cell
-                if (!((wholeArmyBitBoard() | controlledCells(WhiteArmy)) & BitBoard({b8, c8, d8}))) {
+                //    foe controlled cell (b8 can be controlled: the
+                //    king does not pass on it)
+                if (!(wholeArmyBitBoard() & BitBoard({b8, c8, d8})) &&
+                    !isAttacked(c8, WhiteArmy) && !isAttacked(d8, WhiteArmy)) {
                     // Cells are free and not controlled by enemy
                     // ***** Add black 0-0-0 ******
                     moves.push_back(chessMove(King, e8, c8));
@@ -419,8 +830,12 @@ namespace cSzd
     // Modify the ChessBoard assuming the specified move is executed by the active Army.
     // N.B.: This method does not perform any check on move validity: it is responsibility
     // of the caller to perform such check (possibly using the generateLegalMoves() method)
-    void ChessBoard::doMove(const ChessMove &m)
+    // The returned UndoInfo contains the state that cannot be derived from the move,
+    // and can be passed to undoMove() to restore the position before the move.
+    UndoInfo ChessBoard::doMove(const ChessMove &m)
     {
+        UndoInfo undo {castlingAvailability.state(), enPassantTargetSquare.state(),
+                       halfMoveClock, hashKey, evalAccumulator};
         ArmyColor enemyArmy = (sideToMove == WhiteArmy) ? BlackArmy : WhiteArmy;
         Piece movedPiece = chessMoveGetMovedPiece(m);
         Piece takenPiece = chessMoveGetTakenPiece(m);
@@ -457,10 +872,16 @@ namespace cSzd
                     // white 0-0
                     armies[sideToMove].pieces[Rook] ^=
                                 BitBoard({h1, f1});
+                    hashKey ^= Zobrist.pieces[sideToMove][Rook][h1] ^
+                               Zobrist.pieces[sideToMove][Rook][f1];
+                    evalAccumulator.movePiece(sideToMove, Rook, h1, f1);
                 } else {
                     // white 0-0-0
                     armies[sideToMove].pieces[Rook] ^=
                                 BitBoard({a1, d1});
+                    hashKey ^= Zobrist.pieces[sideToMove][Rook][a1] ^
+                               Zobrist.pieces[sideToMove][Rook][d1];
+                    evalAccumulator.movePiece(sideToMove, Rook, a1, d1);
                 }
                 castlingAvailability &= ~BitBoard({c1, g1});
             } else {
@@ -469,19 +890,41 @@ namespace cSzd
                     // black 0-0
                     armies[sideToMove].pieces[Rook] ^=
                                 BitBoard({h8, f8});
+                    hashKey ^= Zobrist.pieces[sideToMove][Rook][h8] ^
+                               Zobrist.pieces[sideToMove][Rook][f8];
+                    evalAccumulator.movePiece(sideToMove, Rook, h8, f8);
                 } else {
                     // black 0-0-0
                     armies[sideToMove].pieces[Rook] ^=
                                 BitBoard({a8, d8});
+                    hashKey ^= Zobrist.pieces[sideToMove][Rook][a8] ^
+                               Zobrist.pieces[sideToMove][Rook][d8];
+                    evalAccumulator.movePiece(sideToMove, Rook, a8, d8);
                 }
                 castlingAvailability &= ~BitBoard({c8, g8});
             }
         }
         armies[sideToMove].pieces[movedPiece] ^=
             BitBoard({startCell, destCell});
+        hashKey ^= Zobrist.pieces[sideToMove][movedPiece][startCell] ^
+                   Zobrist.pieces[sideToMove][movedPiece][destCell];
+        evalAccumulator.movePiece(sideToMove, movedPiece, startCell, destCell);
+        // In case of promotion, the pawn in the destination
+        // cell is replaced with the promoted piece
+        Piece promotedPiece = chessMoveGetPromotedPiece(m);
+        if (promotedPiece != InvalidPiece) {
+            armies[sideToMove].pieces[movedPiece] ^= BitBoard(destCell);
+            armies[sideToMove].pieces[promotedPiece] ^= BitBoard(destCell);
+            hashKey ^= Zobrist.pieces[sideToMove][movedPiece][destCell] ^
+                       Zobrist.pieces[sideToMove][promotedPiece][destCell];
+            evalAccumulator.removePiece(sideToMove, movedPiece, destCell);
+            evalAccumulator.addPiece(sideToMove, promotedPiece, destCell);
+        }
         if (takenPiece != InvalidPiece) {
             // remove the taken piece from the opposite army
             armies[enemyArmy].pieces[takenPiece] ^= BitBoard(capturedPieceCell);
+            hashKey ^= Zobrist.pieces[enemyArmy][takenPiece][capturedPieceCell];
+            evalAccumulator.removePiece(enemyArmy, takenPiece, capturedPieceCell);
         }
         // If we move a Pawn or we capture a piece, reset half move counter,
         // otherwise increases it
@@ -541,6 +984,71 @@ namespace cSzd
 
         // Updates side to move
         sideToMove = enemyArmy;
+
+        // The castling rights and the en passant target square are
+        // hashed with their new values (the pieces keys have been
+        // already updated above)
+        hashKey ^= castlingKey(undo.castlingAvailability) ^
+                   castlingKey(castlingAvailability.state()) ^
+                   enPassantKey(undo.enPassantTargetSquare) ^
+                   enPassantKey(enPassantTargetSquare.state()) ^
+                   Zobrist.blackToMove;
+
+        return undo;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // Restore the position before the execution of the move m, that shall be the last
+    // move performed with doMove(), using the UndoInfo returned by doMove()
+    void ChessBoard::undoMove(const ChessMove &m, const UndoInfo &undo)
+    {
+        ArmyColor enemyArmy = sideToMove;
+        sideToMove = (enemyArmy == WhiteArmy) ? BlackArmy : WhiteArmy;
+        Piece movedPiece = chessMoveGetMovedPiece(m);
+        Piece takenPiece = chessMoveGetTakenPiece(m);
+        Piece promotedPiece = chessMoveGetPromotedPiece(m);
+        Cell startCell = chessMoveGetStartingCell(m);
+        Cell destCell = chessMoveGetDestinationCell(m);
+
+        // Move back the piece (in case of promotion, the promoted
+        // piece in the destination cell is replaced by the pawn)
+        if (promotedPiece != InvalidPiece) {
+            armies[sideToMove].pieces[promotedPiece] ^= BitBoard(destCell);
+            armies[sideToMove].pieces[movedPiece] ^= BitBoard(startCell);
+        }
+        else {
+            armies[sideToMove].pieces[movedPiece] ^= BitBoard({startCell, destCell});
+        }
+
+        // Put back the captured piece. A pawn captured by a pawn moving
+        // to the en passant target square was captured en passant
+        if (takenPiece != InvalidPiece) {
+            Cell capturedPieceCell = destCell;
+            if ((movedPiece == Pawn) && (takenPiece == Pawn) &&
+                (undo.enPassantTargetSquare == singlecell(destCell))) {
+                capturedPieceCell = toCell(file(destCell), rank(startCell));
+            }
+            armies[enemyArmy].pieces[takenPiece] ^= BitBoard(capturedPieceCell);
+        }
+
+        // Move back the rook in case of castling
+        if (isACastlingMove(m)) {
+            switch (destCell) {
+                case g1: armies[sideToMove].pieces[Rook] ^= BitBoard({h1, f1}); break;
+                case c1: armies[sideToMove].pieces[Rook] ^= BitBoard({a1, d1}); break;
+                case g8: armies[sideToMove].pieces[Rook] ^= BitBoard({h8, f8}); break;
+                case c8: armies[sideToMove].pieces[Rook] ^= BitBoard({a8, d8}); break;
+                default: break;
+            }
+        }
+
+        castlingAvailability = BitBoard(undo.castlingAvailability);
+        enPassantTargetSquare = BitBoard(undo.enPassantTargetSquare);
+        halfMoveClock = undo.halfMoveClock;
+        hashKey = undo.hashKey;
+        evalAccumulator = undo.evalAccumulator;
+        if (sideToMove == BlackArmy)
+            --fullMoves;
     }
 
     std::ostream &operator<<(std::ostream &os, const ChessBoard &cb)
@@ -614,6 +1122,25 @@ namespace cSzd
     // --------------------------------------------------------------------------------------------------
     // Private methods
 
+    // -----------------------------------------------------------------
+    // An en passant capture removes two pawns from the same rank, and this
+    // can discover a check that is not detected by the pin computation of
+    // the move generator. So the capture is executed on the occupancy
+    // and the king safety is checked explicitly
+    bool ChessBoard::enPassantCaptureIsLegal(Cell from, Cell to) const
+    {
+        ArmyColor opponentColor = (sideToMove == WhiteArmy) ? BlackArmy : WhiteArmy;
+        Cell kingPos = armies[sideToMove].getKingPosition();
+        if (kingPos == InvalidCell)
+            return true;
+        Cell capturedPawnCell = toCell(file(to), rank(from));
+        BitBoardState occupancy = wholeArmyBitBoard().state();
+        occupancy ^= singlecell(from) | singlecell(to) | singlecell(capturedPawnCell);
+        Army opponent = armies[opponentColor];
+        opponent.pieces[Pawn].resetCell(capturedPawnCell);
+        return attackersOf(opponent, opponentColor, kingPos, occupancy) == EmptyBB;
+    }
+
     // -----------------------------------------------------------------
     bool ChessBoard::checkEnPassantTargetSquareValidity() const
     {
@@ -674,5 +1201,76 @@ namespace cSzd
         return true;
     }
 
+    // -----------------------------------------------------------------
+    static bool isSANSuffix(char ch) { return (ch == '+') || (ch == '#') || (ch == '!') || (ch == '?'); }
+
+    ChessMove resolveSANMove(const ChessBoard &cb, const MoveList &legalMoves, std::string_view san)
+    {
+        while (!san.empty() && isSANSuffix(san.back()))
+            san.remove_suffix(1);
+        if (san.size() < 2)
+            return InvalidMove;
+
+        // Castling, written with the letter O or with zeros
+        if ((san[0] == 'O') || (san[0] == '0')) {
+            bool kingSide = (san == "O-O") || (san == "0-0");
+            bool queenSide = (san == "O-O-O") || (san == "0-0-0");
+            if (!kingSide && !queenSide)
+                return InvalidMove;
+            Rank r = (cb.sideToMove == WhiteArmy) ? r_1 : r_8;
+            ChessMove castling = chessMove(King, toCell(f_e, r), toCell(kingSide ? f_g : f_c, r));
+            return (std::find(legalMoves.begin(), legalMoves.end(), castling) != legalMoves.end()) ? castling : InvalidMove;
+        }
+
+        // [<piece>][<from file>][<from rank>][x]<destination>[=<promoted piece>]
+        Piece piece = Pawn;
+        if ((san[0] == 'K') || (san[0] == 'Q') || (san[0] == 'R') || (san[0] == 'B') || (san[0] == 'N')) {
+            piece = toPiece(san[0]);
+            san.remove_prefix(1);
+        }
+        Piece promoted = InvalidPiece;
+        if ((piece == Pawn) && (san.size() >= 3) &&
+            ((san.back() == 'Q') || (san.back() == 'R') || (san.back() == 'B') || (san.back() == 'N'))) {
+            promoted = toPiece(san.back());
+            san.remove_suffix(1);
+            if (san.back() == '=')
+                san.remove_suffix(1);
+        }
+        if (san.size() < 2)
+            return InvalidMove;
+        File destFile = toFile(san[san.size() - 2]);
+        Rank destRank = toRank(san[san.size() - 1]);
+        if ((destFile == InvalidFile) || (destRank == InvalidRank))
+            return InvalidMove;
+        Cell dest = toCell(destFile, destRank);
+
+        File fromFile = InvalidFile;
+        Rank fromRank = InvalidRank;
+        for (auto ch : san.substr(0, san.size() - 2)) {
+            if ((ch == 'x') || (ch == ':') || (ch == '-'))
+                continue;
+            if (toFile(ch) != InvalidFile)
+                fromFile = toFile(ch);
+            else if (toRank(ch) != InvalidRank)
+                fromRank = toRank(ch);
+            else
+                return InvalidMove;
+        }
+
+        // The move shall match exactly one legal move
+        ChessMove found = InvalidMove;
+        for (auto m : legalMoves) {
+            Cell from = chessMoveGetStartingCell(m);
+            if ((chessMoveGetMovedPiece(m) != piece) || (chessMoveGetDestinationCell(m) != dest) ||
+                (chessMoveGetPromotedPiece(m) != promoted) ||
+                ((fromFile != InvalidFile) && (file(from) != fromFile)) ||
+                ((fromRank != InvalidRank) && (rank(from) != fromRank)))
+                continue;
+            if (found != InvalidMove)
+                return InvalidMove;
+            found = m;
+        }
+        return found;
+    }
 
 } // namespace cSzd
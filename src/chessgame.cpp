@@ -1,5 +1,7 @@
 #include <algorithm>
 #include "cmdsuzdal/chessgame.h"
+#include "cmdsuzdal/cellnames.h"
+#include "cmdsuzdal/sliderattacks.h"
 
 namespace cSzd
 {
@@ -59,8 +61,9 @@ namespace cSzd
         // Removes the annotations
         auto move = removeAnnotions(nMove);
 
-        if (move.at(0) == '0') {
-            // This can be an castling move
+        if ((move.at(0) == '0') || (move.at(0) == 'O')) {
+            // This can be an castling move (written with zeros or with
+            // the letter O, as in the PGN files)
             cm = castlingMoveNotationEvaluationAndConversion(move);
         }
         else {
@@ -125,19 +128,21 @@ namespace cSzd
     // -----------------------------------------------------------------
     ChessMove ChessGame::castlingMoveNotationEvaluationAndConversion(const std::string_view nMove) const
     {
+        bool kingSide = (nMove == "0-0") || (nMove == "00") || (nMove == "O-O") || (nMove == "OO");
+        bool queenSide = (nMove == "0-0-0") || (nMove == "000") || (nMove == "O-O-O") || (nMove == "OOO");
         if (board.sideToMove == WhiteArmy) {
-            if ((nMove == "0-0") || (nMove == "00")) {
+            if (kingSide) {
                 return chessMove(King, e1, g1);
             }
-            if ((nMove == "0-0-0") || (nMove == "000")) {
+            if (queenSide) {
                 return chessMove(King, e1, c1);
             }
         }
         else if (board.sideToMove == BlackArmy) {
-            if ((nMove == "0-0") || (nMove == "00")) {
+            if (kingSide) {
                 return chessMove(King, e8, g8);
             }
-            if ((nMove == "0-0-0") || (nMove == "000")) {
+            if (queenSide) {
                 return chessMove(King, e8, c8);
             }
         }
@@ -502,46 +507,66 @@ namespace cSzd
     Cell ChessGame::determineStartCell(Piece p, Cell dCell, Piece capturedPiece,
                                             std::tuple<File, Rank> suggested) const
     {
-        // Depending on Piece type, select the proper bitboard
+        if ((p == InvalidPiece) || (dCell == InvalidCell))
+            return InvalidCell;
+
+        // Depending on Piece type, select the proper bitboard. Only the pieces
+        // that attack the destination cell can be the moved one: these are found
+        // with a "reverse" lookup of the attacks starting from the destination cell
         BitBoard bbToCheck = board.armies[board.sideToMove].pieces[p];
+        BitBoardState occupancy = board.wholeArmyBitBoard().state();
+        switch (p) {
+            case King:
+                bbToCheck &= BitBoard(KingAttacks[dCell]);
+                break;
+            case Queen:
+                bbToCheck &= BitBoard(queenAttacks(dCell, occupancy));
+                break;
+            case Rook:
+                bbToCheck &= BitBoard(rookAttacks(dCell, occupancy));
+                break;
+            case Bishop:
+                bbToCheck &= BitBoard(bishopAttacks(dCell, occupancy));
+                break;
+            case Knight:
+                bbToCheck &= BitBoard(KnightAttacks[dCell]);
+                break;
+            default:
+                break;
+        }
         // Search the pieces...
-        auto foundPieces = 0;
         Cell tentativeStartCell = InvalidCell;
-        for (auto startPos = 0; (startPos < 64) && (foundPieces < bbToCheck.popCount()); startPos++) {
-            if (bbToCheck[startPos] != 0) {
-                // piece found in position startPos
-                foundPieces++;
-                // Check if the move is possible
-                if (std::find(possibleMoves.begin(), possibleMoves.end(),
-                        chessMove(p, static_cast<Cell>(startPos), dCell, capturedPiece)) != possibleMoves.end()) {
-
-                    // Move found... validate with suggestions
-                    if (std::get<0>(suggested) != InvalidFile) {
-                        // File of the found possible start cell
-                        // shall correspond to the suggested one
-                        if (file(static_cast<Cell>(startPos)) != std::get<0>(suggested)) {
-                            // not good...
-                            continue;
-                        }
-                    }
-                    if (std::get<1>(suggested) != InvalidRank) {
-                        // Rank of the found possible start cell
-                        // shall correspond to the suggested one
-                        if (rank(static_cast<Cell>(startPos)) != std::get<1>(suggested)) {
-                            // not good...
-                            continue;
-                        }
-                    }
-                    // Move really found! If a valid move was still not found,
-                    // this becames the candidate, otherwise there is ambiguity
-                    // and invalid move is returned
-                    if (tentativeStartCell == InvalidCell) {
-                        tentativeStartCell = static_cast<Cell>(startPos);
+        for (Cell startPos : bbToCheck) {
+            // piece found in position startPos. Check if the move is possible
+            if (std::find(possibleMoves.begin(), possibleMoves.end(),
+                    chessMove(p, startPos, dCell, capturedPiece)) != possibleMoves.end()) {
+
+                // Move found... validate with suggestions
+                if (std::get<0>(suggested) != InvalidFile) {
+                    // File of the found possible start cell
+                    // shall correspond to the suggested one
+                    if (file(startPos) != std::get<0>(suggested)) {
+                        // not good...
+                        continue;
                     }
-                    else {
-                        return InvalidCell;
+                }
+                if (std::get<1>(suggested) != InvalidRank) {
+                    // Rank of the found possible start cell
+                    // shall correspond to the suggested one
+                    if (rank(startPos) != std::get<1>(suggested)) {
+                        // not good...
+                        continue;
                     }
                 }
+                // Move really found! If a valid move was still not found,
+                // this becames the candidate, otherwise there is ambiguity
+                // and invalid move is returned
+                if (tentativeStartCell == InvalidCell) {
+                    tentativeStartCell = startPos;
+                }
+                else {
+                    return InvalidCell;
+                }
             }
         }
         return tentativeStartCell;
@@ -1,4 +1,5 @@
 #include "cmdsuzdal/chessmove.h"
+#include "cmdsuzdal/cellnames.h"
 
 namespace cSzd
 {
@@ -67,4 +68,22 @@ namespace cSzd
         return os;
     }
 
-}
\ No newline at end of file
+    std::ostream &printUCIMove(std::ostream &os, const ChessMove &cm)
+    {
+        if (cm == InvalidMove) {
+            os << "0000";
+        }
+        else {
+            os << cellName(chessMoveGetStartingCell(cm)) << cellName(chessMoveGetDestinationCell(cm));
+            switch (chessMoveGetPromotedPiece(cm)) {
+                case Queen:  os << 'q'; break;
+                case Rook:   os << 'r'; break;
+                case Bishop: os << 'b'; break;
+                case Knight: os << 'n'; break;
+                default: break;
+            }
+        }
+        return os;
+    }
+
+}
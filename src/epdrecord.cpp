@@ -0,0 +1,204 @@
+#include <algorithm>
+
+#include "cmdsuzdal/epdrecord.h"
+#include "cmdsuzdal/cellnames.h"
+
+namespace cSzd
+{
+    static bool isEPDBlank(char ch) { return (ch == ' ') || (ch == '\t') || (ch == '\r') || (ch == '\n'); }
+    static bool isLetter(char ch) { return ((ch >= 'a') && (ch <= 'z')) || ((ch >= 'A') && (ch <= 'Z')); }
+    static bool isDigit(char ch) { return (ch >= '0') && (ch <= '9'); }
+
+    // The opcodes are a letter followed by up to 14 letters, digits or
+    // underscores
+    static bool isValidOpcode(const std::string_view opcode)
+    {
+        if (opcode.empty() || (opcode.size() > 15) || !isLetter(opcode[0]))
+            return false;
+        return std::all_of(opcode.begin(), opcode.end(),
+                           [](char ch) { return isLetter(ch) || isDigit(ch) || (ch == '_'); });
+    }
+
+    static bool parseEPDOperations(const std::string_view ops, std::vector<EPDOperation> &operations)
+    {
+        std::size_t ndx = 0;
+        while (ndx < ops.size()) {
+            // skips the blanks and the empty operations
+            if (isEPDBlank(ops[ndx]) || (ops[ndx] == ';')) {
+                ndx++;
+                continue;
+            }
+
+            std::size_t start = ndx;
+            while ((ndx < ops.size()) && !isEPDBlank(ops[ndx]) && (ops[ndx] != ';'))
+                ndx++;
+            std::string_view opcode = ops.substr(start, ndx - start);
+            if (!isValidOpcode(opcode))
+                return false;
+            EPDOperation op {std::string(opcode), {}};
+
+            // operands, up to the semicolon (or the end of the record)
+            while (ndx < ops.size()) {
+                if (isEPDBlank(ops[ndx])) {
+                    ndx++;
+                    continue;
+                }
+                if (ops[ndx] == ';') {
+                    ndx++;
+                    break;
+                }
+                if (ops[ndx] == '"') {
+                    std::size_t close = ops.find('"', ndx + 1);
+                    if (close == std::string_view::npos)
+                        return false;
+                    op.operands.emplace_back(ops.substr(ndx + 1, close - ndx - 1));
+                    ndx = close + 1;
+                }
+                else {
+                    start = ndx;
+                    while ((ndx < ops.size()) && !isEPDBlank(ops[ndx]) && (ops[ndx] != ';'))
+                        ndx++;
+                    op.operands.emplace_back(ops.substr(start, ndx - start));
+                }
+            }
+            operations.push_back(std::move(op));
+        }
+        return true;
+    }
+
+    // Non negative decimal number (false if it is not a number)
+    static bool parseEPDNumber(const std::string_view s, std::uint64_t &n)
+    {
+        if (s.empty() || (s.size() > 19) || !std::all_of(s.begin(), s.end(), isDigit))
+            return false;
+        n = 0;
+        for (auto ch : s)
+            n = n * 10 + static_cast<std::uint64_t>(ch - '0');
+        return true;
+    }
+
+    // -------------------------------------------------------------------------
+    FENError EPDRecord::loadRecord(const std::string_view epd)
+    {
+        operations.clear();
+        std::string_view ops;
+        FENError e = parseEPDPosition(epd, position, ops);
+        if ((e == FENNoError) && !parseEPDOperations(ops, operations))
+            e = EPDInvalidOperation;
+        if (e != FENNoError) {
+            position = FENPosition {};
+            operations.clear();
+        }
+        return e;
+    }
+
+    ChessBoard EPDRecord::board() const
+    {
+        FENPosition pos = position;
+        std::uint64_t n;
+        const EPDOperation *op = operation("hmvc");
+        if (op && !op->operands.empty() && parseEPDNumber(op->operands[0], n))
+            pos.halfMoveClock = static_cast<unsigned int>(n);
+        op = operation("fmvn");
+        if (op && !op->operands.empty() && parseEPDNumber(op->operands[0], n))
+            pos.fullMoves = static_cast<unsigned int>(n);
+        ChessBoard cb;
+        cb.loadPosition(pos);
+        return cb;
+    }
+
+    // -------------------------------------------------------------------------
+    const EPDOperation *EPDRecord::operation(const std::string_view opcode) const
+    {
+        for (auto &op : operations) {
+            if (op.opcode == opcode)
+                return &op;
+        }
+        return nullptr;
+    }
+
+    std::string EPDRecord::id() const
+    {
+        const EPDOperation *op = operation("id");
+        return (op && !op->operands.empty()) ? op->operands[0] : std::string();
+    }
+
+    std::string EPDRecord::comment(unsigned int n) const
+    {
+        const char opcode[3] = {'c', static_cast<char>('0' + std::min(n, 9U)), '\0'};
+        const EPDOperation *op = operation(opcode);
+        return (op && !op->operands.empty()) ? op->operands[0] : std::string();
+    }
+
+    // The moves of the operation legal in the position
+    static std::vector<ChessMove> operationMoves(const EPDRecord &r, const std::string_view opcode)
+    {
+        std::vector<ChessMove> moves;
+        const EPDOperation *op = r.operation(opcode);
+        if (op) {
+            ChessBoard cb = r.board();
+            MoveList legalMoves;
+            cb.generateLegalMoves(legalMoves);
+            for (auto &operand : op->operands) {
+                ChessMove m = epdMove(cb, legalMoves, operand);
+                if (m != InvalidMove)
+                    moves.push_back(m);
+            }
+        }
+        return moves;
+    }
+
+    std::vector<ChessMove> EPDRecord::bestMoves() const { return operationMoves(*this, "bm"); }
+    std::vector<ChessMove> EPDRecord::avoidMoves() const { return operationMoves(*this, "am"); }
+
+    std::vector<EPDPerftCount> EPDRecord::perftCounts() const
+    {
+        std::vector<EPDPerftCount> counts;
+        for (auto &op : operations) {
+            std::uint64_t depth, nodes;
+            if ((op.opcode.size() >= 2) && (op.opcode[0] == 'D') &&
+                parseEPDNumber(std::string_view(op.opcode).substr(1), depth) &&
+                !op.operands.empty() && parseEPDNumber(op.operands[0], nodes)) {
+                counts.push_back(EPDPerftCount{static_cast<unsigned int>(depth), nodes});
+            }
+        }
+        std::sort(counts.begin(), counts.end(),
+                  [](const EPDPerftCount &a, const EPDPerftCount &b) { return a.depth < b.depth; });
+        return counts;
+    }
+
+    // -------------------------------------------------------------------------
+    // The SAN moves are resolved against the legal moves (as the moves of
+    // the PGN files); the long algebraic moves are searched among them
+    ChessMove epdMove(const ChessBoard &cb, const MoveList &legalMoves, const std::string_view move)
+    {
+        ChessMove m = resolveSANMove(cb, legalMoves, move);
+        if (m != InvalidMove)
+            return m;
+
+        if ((move.size() == 4) || (move.size() == 5)) {
+            for (auto lm : legalMoves) {
+                if ((move.substr(0, 2) != cellName(chessMoveGetStartingCell(lm))) ||
+                    (move.substr(2, 2) != cellName(chessMoveGetDestinationCell(lm))))
+                    continue;
+                Piece promoted = chessMoveGetPromotedPiece(lm);
+                char promotion = (move.size() == 5) ? move[4] : ' ';
+                if (((promoted == InvalidPiece) && (move.size() == 4)) ||
+                    ((promoted == Queen) && ((promotion == 'q') || (promotion == 'Q'))) ||
+                    ((promoted == Rook) && ((promotion == 'r') || (promotion == 'R'))) ||
+                    ((promoted == Bishop) && ((promotion == 'b') || (promotion == 'B'))) ||
+                    ((promoted == Knight) && ((promotion == 'n') || (promotion == 'N'))))
+                    return lm;
+            }
+        }
+        return InvalidMove;
+    }
+
+    ChessMove epdMove(const ChessBoard &cb, const std::string_view move)
+    {
+        MoveList legalMoves;
+        cb.generateLegalMoves(legalMoves);
+        return epdMove(cb, legalMoves, move);
+    }
+
+} // namespace cSzd
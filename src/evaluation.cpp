@@ -0,0 +1,27 @@
+#include "cmdsuzdal/evaluation.h"
+#include "cmdsuzdal/chessboard.h"
+
+namespace cSzd
+{
+
+    // -----------------------------------------------------------------
+    EvalAccumulator computeEvalAccumulator(const ChessBoard &cb)
+    {
+        EvalAccumulator acc;
+        for (auto a = 0; a < 2; a++) {
+            for (auto p = 0U; p < NumPieceTypes; p++) {
+                for (Cell c : cb.armies[a].pieces[p])
+                    acc.addPiece(static_cast<ArmyColor>(a), static_cast<Piece>(p), c);
+            }
+        }
+        return acc;
+    }
+
+    // -----------------------------------------------------------------
+    int pestoEvaluation(const ChessBoard &cb)
+    {
+        int score = taperedScore(cb.evalAccumulator);
+        return (cb.sideToMove == WhiteArmy) ? score : -score;
+    }
+
+} // namespace cSzd
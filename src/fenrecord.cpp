@@ -1,72 +1,244 @@
-#include <iostream>
-#include <sstream>
+#include <limits>
 
 #include "cmdsuzdal/fenrecord.h"
 
 namespace cSzd
 {
+    // -------------------------------------------------------------
+    // The army and the piece of the FEN characters, coded as
+    // (army << 3) | piece, or as NotAPiece
+    static constexpr std::uint8_t NotAPiece = 0xFF;
+    struct FENPieceCodes {
+        std::uint8_t codes[256];
+        constexpr FENPieceCodes() : codes{}
+        {
+            for (auto &c : codes)
+                c = NotAPiece;
+            const char pieceChars[2][NumPieceTypes + 1] = {"KQBNRP", "kqbnrp"};
+            for (auto a = 0U; a < 2; a++) {
+                for (auto p = 0U; p < NumPieceTypes; p++)
+                    codes[static_cast<std::uint8_t>(pieceChars[a][p])] = static_cast<std::uint8_t>((a << 3) | p);
+            }
+        }
+    };
+    static constexpr FENPieceCodes PieceCodes {};
 
     // -------------------------------------------------------------
-    FENRecord::FENRecord(const std::string_view f) : fen { f }
+    const char *fenErrorDescription(FENError e)
     {
-        loadPosition(f);
+        switch (e) {
+            case FENNoError:              return "no error";
+            case FENMissingField:         return "missing field";
+            case FENInvalidPiece:         return "invalid character in the piece placement";
+            case FENInvalidRank:          return "a rank does not describe 8 cells";
+            case FENInvalidNumberOfRanks: return "the piece placement does not describe 8 ranks";
+            case FENInvalidActiveArmy:    return "invalid active army";
+            case FENInvalidCastling:      return "invalid castling availability";
+            case FENInvalidEnPassant:     return "invalid en passant target square";
+            case FENInvalidHalfMoveClock: return "invalid half move clock";
+            case FENInvalidFullMoves:     return "invalid full move number";
+            case FENTrailingCharacters:   return "unexpected characters after the last field";
+            case EPDInvalidOperation:     return "invalid EPD operation";
+            default:                      return "unknown error";
+        }
     }
 
     // -------------------------------------------------------------
-    void FENRecord::loadPosition(const std::string_view f)
+    // The ranks are described from the 8th to the 1st, the files from
+    // a to h: the cell of the next character is tracked as (rank, file)
+    FENError parseFENPiecePlacement(std::string_view pp, BitBoardState (&pieces)[2][NumPieceTypes])
     {
-        fen = (f != "") ? f : FENEmptyChessBoard;
-        activeArmy = InvalidArmy;
-        cstlAvail = BitBoard(EmptyBB);
-        enPassantCell = BitBoard(EmptyBB);
+        for (auto &army : pieces) {
+            for (auto &bbs : army)
+                bbs = EmptyBB;
+        }
+        int rank = 7;
+        unsigned int file = 0;
+        for (auto ch : pp) {
+            std::uint8_t code = PieceCodes.codes[static_cast<std::uint8_t>(ch)];
+            if (code != NotAPiece) {
+                if (file >= 8)
+                    return FENInvalidRank;
+                pieces[code >> 3][code & 0x07] |= BitBoardState{1} << (rank * 8 + file);
+                file++;
+            }
+            else if ((ch >= '1') && (ch <= '8')) {
+                file += static_cast<unsigned int>(ch - '0');
+                if (file > 8)
+                    return FENInvalidRank;
+            }
+            else if (ch == '/') {
+                if (file != 8)
+                    return FENInvalidRank;
+                if (--rank < 0)
+                    return FENInvalidNumberOfRanks;
+                file = 0;
+            }
+            else {
+                return FENInvalidPiece;
+            }
+        }
+        if (rank != 0)
+            return FENInvalidNumberOfRanks;
+        return (file == 8) ? FENNoError : FENInvalidRank;
+    }
 
-        // extracts the subfields
-        std::istringstream ss(fen);
-        std::string fld;
+    // -------------------------------------------------------------
+    static bool isFENBlank(char ch) { return (ch == ' ') || (ch == '\t') || (ch == '\r') || (ch == '\n'); }
+
+    // Returns the next field (empty at the end of the string)
+    static std::string_view nextFENField(std::string_view f, std::size_t &pos)
+    {
+        while ((pos < f.size()) && isFENBlank(f[pos]))
+            pos++;
+        std::size_t start = pos;
+        while ((pos < f.size()) && !isFENBlank(f[pos]))
+            pos++;
+        return f.substr(start, pos - start);
+    }
+
+    // Decimal number in the range of the unsigned int (at most 10 digits)
+    static bool parseFENNumber(std::string_view fld, unsigned int &n)
+    {
+        if (fld.empty() || (fld.size() > 10))
+            return false;
+        std::uint64_t v = 0;
+        for (auto ch : fld) {
+            if ((ch < '0') || (ch > '9'))
+                return false;
+            v = v * 10 + static_cast<std::uint64_t>(ch - '0');
+        }
+        if (v > std::numeric_limits<unsigned int>::max())
+            return false;
+        n = static_cast<unsigned int>(v);
+        return true;
+    }
+
+    // -------------------------------------------------------------
+    // Parses the first four fields (the ones shared by FEN and EPD)
+    static FENError parseFENPositionFields(std::string_view f, std::size_t &ndx, FENPosition &pos)
+    {
 
         // pieces placement
-        pPlacement = std::string_view {fen.c_str(), fen.find_first_of(FENDelim)};
+        std::string_view fld = nextFENField(f, ndx);
+        if (fld.empty())
+            return FENMissingField;
+        if (FENError e = parseFENPiecePlacement(fld, pos.pieces); e != FENNoError)
+            return e;
 
         // active army
-        ss >> fld;  // skip first field
-        ss >> fld;
-        if (fld == "w") {
-            activeArmy = WhiteArmy;
-        }
-        else if (fld == "b") {
-            activeArmy = BlackArmy;
+        fld = nextFENField(f, ndx);
+        if (fld.empty())
+            return FENMissingField;
+        if (fld.size() != 1)
+            return FENInvalidActiveArmy;
+        switch (fld[0]) {
+            case 'w': pos.sideToMove = WhiteArmy; break;
+            case 'b': pos.sideToMove = BlackArmy; break;
+            case '-': pos.sideToMove = InvalidArmy; break;
+            default: return FENInvalidActiveArmy;
         }
 
         // castling availability
-        ss >> fld;
-        if (fld.find('Q') != std::string::npos) {
-            cstlAvail.setCell(c1);
-        }
-        if (fld.find('K') != std::string::npos) {
-            cstlAvail.setCell(g1);
-        }
-        if (fld.find('q') != std::string::npos) {
-            cstlAvail.setCell(c8);
-        }
-        if (fld.find('k') != std::string::npos) {
-            cstlAvail.setCell(g8);
+        fld = nextFENField(f, ndx);
+        if (fld.empty())
+            return FENMissingField;
+        pos.castlingAvailability = EmptyBB;
+        if (fld != "-") {
+            for (auto ch : fld) {
+                BitBoardState cell;
+                switch (ch) {
+                    case 'K': cell = BitBoardState{1} << g1; break;
+                    case 'Q': cell = BitBoardState{1} << c1; break;
+                    case 'k': cell = BitBoardState{1} << g8; break;
+                    case 'q': cell = BitBoardState{1} << c8; break;
+                    default: return FENInvalidCastling;
+                }
+                if (pos.castlingAvailability & cell)
+                    return FENInvalidCastling;
+                pos.castlingAvailability |= cell;
+            }
         }
 
-        // En passant target cell
-        ss >> fld;
-        if (fld.size() == 2) {
-            enPassantCell.setCell(
-                static_cast<File>(fld[0] - 'a'),
-                static_cast<Rank>(fld[1] - '1'));
+        // en passant target cell
+        fld = nextFENField(f, ndx);
+        if (fld.empty())
+            return FENMissingField;
+        pos.enPassantTargetSquare = EmptyBB;
+        if (fld != "-") {
+            if ((fld.size() != 2) || (fld[0] < 'a') || (fld[0] > 'h') || (fld[1] < '1') || (fld[1] > '8'))
+                return FENInvalidEnPassant;
+            pos.enPassantTargetSquare = BitBoardState{1} << ((fld[1] - '1') * 8 + (fld[0] - 'a'));
         }
+        pos.halfMoveClock = 0;
+        pos.fullMoves = 1;
+        return FENNoError;
+    }
+
+    // -------------------------------------------------------------
+    FENError parseFEN(std::string_view f, FENPosition &pos)
+    {
+        std::size_t ndx = 0;
+        if (FENError e = parseFENPositionFields(f, ndx, pos); e != FENNoError)
+            return e;
+
+        // half move clock and full move number (optional)
+        std::string_view fld = nextFENField(f, ndx);
+        if (fld.empty())
+            return FENNoError;
+        if (!parseFENNumber(fld, pos.halfMoveClock))
+            return FENInvalidHalfMoveClock;
+        fld = nextFENField(f, ndx);
+        if (fld.empty())
+            return FENNoError;
+        if (!parseFENNumber(fld, pos.fullMoves))
+            return FENInvalidFullMoves;
+
+        return nextFENField(f, ndx).empty() ? FENNoError : FENTrailingCharacters;
+    }
 
-        // half move clock
-        ss >> fld;
-        hmc = std::stoul(fld);;
+    FENError parseEPDPosition(std::string_view epd, FENPosition &pos, std::string_view &operations)
+    {
+        std::size_t ndx = 0;
+        if (FENError e = parseFENPositionFields(epd, ndx, pos); e != FENNoError)
+            return e;
+        while ((ndx < epd.size()) && isFENBlank(epd[ndx]))
+            ndx++;
+        std::size_t end = epd.size();
+        while ((end > ndx) && isFENBlank(epd[end - 1]))
+            end--;
+        operations = epd.substr(ndx, end - ndx);
+        return FENNoError;
+    }
 
-        // full move number
-        ss >> fld;
-        fm = std::stoul(fld);;
+    // -------------------------------------------------------------
+    FENRecord::FENRecord(const std::string_view f) : fen { f }
+    {
+        loadPosition(f);
+    }
+
+    // -------------------------------------------------------------
+    FENError FENRecord::loadPosition(const std::string_view f)
+    {
+        fen = (f != "") ? f : FENEmptyChessBoard;
+        pPlacement = std::string_view {fen.c_str(), fen.find_first_of(FENDelim)};
+
+        FENPosition pos;
+        FENError e = parseFEN(fen, pos);
+        if (e != FENNoError) {
+            activeArmy = InvalidArmy;
+            cstlAvail = BitBoard(EmptyBB);
+            enPassantCell = BitBoard(EmptyBB);
+            hmc = 0;
+            fm = 1;
+            return e;
+        }
+        activeArmy = pos.sideToMove;
+        cstlAvail = BitBoard(pos.castlingAvailability);
+        enPassantCell = BitBoard(pos.enPassantTargetSquare);
+        hmc = pos.halfMoveClock;
+        fm = pos.fullMoves;
+        return FENNoError;
     }
 
     // -------------------------------------------------------------
@@ -75,115 +247,41 @@ namespace cSzd
     // the bitboard with the position of the white King.
     // If Piece is Invalid (default) the BitBoard of all the pieces of
     // the specified Army is returned, if also the Army is invalid, the
-    // BitBoard with all the pieces is returned
+    // BitBoard with all the pieces is returned. If the piece placement is
+    // not valid, the BitBoard is empty
     const BitBoard FENRecord::extractBitBoard(ArmyColor color, Piece piece) const
     {
-        BitBoard bb;
-        std::string skipList = "12345678";
-        std::string_view pp = piecePlacement();
-
-        // Build the list of pieces to search, depending on arguments
-        std::string piecesToSearch = pieceSetFENCharacters(color, piece);
-        Cell bbCell = a8;
-        for (auto ch: pp) {
-            if (ch == '/') {
-                // end of rank: restart from previous rank
-                bbCell = static_cast<Cell>(bbCell - 16);
-            }
-            else {
-                if (piecesToSearch.find(ch) != std::string::npos) {
-                    // Found a "target" piece: set the position
-                    // in the bitboard
-                    bb.setCell(bbCell);
-                }
-                else if (skipList.find(ch) != std::string::npos) {
-                    // found empty cell(s), skip them
-                    bbCell = static_cast<Cell>(bbCell + (ch -'1'));
-                }
-                bbCell = static_cast<Cell>(bbCell + 1);
+        BitBoardState pieces[2][NumPieceTypes];
+        if (parseFENPiecePlacement(piecePlacement(), pieces) != FENNoError)
+            return BitBoard(EmptyBB);
+
+        BitBoardState bbs = EmptyBB;
+        for (auto a : {WhiteArmy, BlackArmy}) {
+            if ((color != a) && (color != InvalidArmy))
+                continue;
+            for (auto p = 0U; p < NumPieceTypes; p++) {
+                if ((p == piece) || (piece == InvalidPiece) || (color == InvalidArmy))
+                    bbs |= pieces[a][p];
             }
         }
-        return bb;
+        return BitBoard(bbs);
     }
 
-    // ----------------------------------------------------------
-    // Build a string with the FEN characters of the specified pieces.
-    // Used by extractBitBoard()
-    const std::string FENRecord::pieceSetFENCharacters(ArmyColor c, Piece p)
+    // -------------------------------------------------------------
+    // The state fields are taken from the record (they can be modified
+    // after the load of the FEN string)
+    FENError FENRecord::extractPosition(FENPosition &pos) const
     {
-        switch (c) {
-            case WhiteArmy:
-                // searches white army
-                switch (p) {
-                    case King:
-                        return "K";
-                        break;
-                    case Queen:
-                        return "Q";
-                        break;
-                    case Bishop:
-                        return "B";
-                        break;
-                    case Knight:
-                        return "N";
-                        break;
-                    case Rook:
-                        return "R";
-                        break;
-                    case Pawn:
-                        return "P";
-                        break;
-                    case InvalidPiece:
-                        // search all white pieces
-                        return "BKNPQR";
-                        break;
-                    default:
-                        // invalid arg, return empty bitboard
-                        return "";
-                        break;
-                }
-                break;
-            case BlackArmy:
-                // searches black army
-                switch (p) {
-                    case King:
-                        return "k";
-                        break;
-                    case Queen:
-                        return "q";
-                        break;
-                    case Bishop:
-                        return "b";
-                        break;
-                    case Knight:
-                        return "n";
-                        break;
-                    case Rook:
-                        return "r";
-                        break;
-                    case Pawn:
-                        return "p";
-                        break;
-                    case InvalidPiece:
-                        // search all black pieces
-                        return "bknpqr";
-                        break;
-                    default:
-                        // invalid arg, return empty bitboard
-                        return "";
-                        break;
-                }
-                break;
-            case InvalidArmy:
-                // searches any army
-                return "BKNPQRbknpqr";
-                break;
-            default:
-                // invalid arg, return empty bitboard
-                return "";
-                break;
+        if (FENError e = parseFEN(fen, pos); e != FENNoError) {
+            parseFEN(FENEmptyChessBoard, pos);
+            return e;
         }
-        return "";
+        pos.sideToMove = activeArmy;
+        pos.castlingAvailability = cstlAvail.state();
+        pos.enPassantTargetSquare = enPassantCell.state();
+        pos.halfMoveClock = hmc;
+        pos.fullMoves = fm;
+        return FENNoError;
     }
 
-} // namespace cSzd
\ No newline at end of file
+} // namespace cSzd
@@ -0,0 +1,144 @@
+#include <algorithm>
+
+#include "cmdsuzdal/movepicker.h"
+
+namespace cSzd
+{
+    // Order of the attackers for the least valuable attacker criterion
+    // (in the Piece order: K, Q, B, N, R, P)
+    static constexpr int AttackerRank[NumPieceTypes] = {5, 4, 2, 1, 3, 0};
+
+    // -----------------------------------------------------------------
+    MovePicker::MovePicker(const ChessBoard &cb, const ChessMove &ttm,
+                           const ChessMove *k, const HistoryTable *h)
+        : board(cb), ttMove(ttm), history(h), capturesOnly(false)
+    {
+        if (k != nullptr) {
+            for (auto i = 0U; i < NumKillers; i++)
+                killers[i] = k[i];
+        }
+    }
+
+    MovePicker::MovePicker(const ChessBoard &cb, const ChessMove &ttm)
+        : board(cb), ttMove(ttm), capturesOnly(true)
+    {
+        // Only the captures can be returned as transposition table move
+        if ((ttMove != InvalidMove) && !isACaptureOrPromotion(ttMove))
+            ttMove = InvalidMove;
+    }
+
+    // -----------------------------------------------------------------
+    // Selection sort step: returns the best of the remaining moves
+    ChessMove MovePicker::pickBest()
+    {
+        unsigned int best = current;
+        for (auto i = current + 1; i < moves.size(); i++) {
+            if (scores[i] > scores[best])
+                best = i;
+        }
+        std::swap(moves[current], moves[best]);
+        std::swap(scores[current], scores[best]);
+        return moves[current++];
+    }
+
+    bool MovePicker::isKiller(const ChessMove &m) const
+    {
+        for (auto &k : killers) {
+            if (k == m)
+                return true;
+        }
+        return false;
+    }
+
+    // -----------------------------------------------------------------
+    ChessMove MovePicker::nextMove()
+    {
+        switch (currentStage) {
+            case TTMoveStage:
+                currentStage = CapturesGenerationStage;
+                if ((ttMove != InvalidMove) && board.isLegal(ttMove))
+                    return ttMove;
+                ttMove = InvalidMove;
+                [[fallthrough]];
+
+            case CapturesGenerationStage:
+                board.generateLegalMoves(moves, CaptureMoves);
+                numGenerated += static_cast<unsigned int>(moves.size());
+                for (auto i = 0U; i < moves.size(); i++) {
+                    Piece taken = chessMoveGetTakenPiece(moves[i]);
+                    Piece promoted = chessMoveGetPromotedPiece(moves[i]);
+                    scores[i] = ((taken != InvalidPiece) ? 16 * SEEPieceValues[taken] : 0) +
+                                ((promoted != InvalidPiece) ? SEEPieceValues[promoted] : 0) -
+                                AttackerRank[chessMoveGetMovedPiece(moves[i])];
+                }
+                current = 0;
+                currentStage = GoodCapturesStage;
+                [[fallthrough]];
+
+            case GoodCapturesStage:
+                while (current < moves.size()) {
+                    ChessMove m = pickBest();
+                    if (m == ttMove)
+                        continue;
+                    if (!board.seeGE(m, 0)) {
+                        if (!capturesOnly)
+                            badCaptures.push_back(m);
+                        continue;
+                    }
+                    return m;
+                }
+                if (capturesOnly) {
+                    currentStage = DoneStage;
+                    return InvalidMove;
+                }
+                current = 0;
+                currentStage = KillersStage;
+                [[fallthrough]];
+
+            case KillersStage:
+                while (current < NumKillers) {
+                    ChessMove k = killers[current++];
+                    if ((k == InvalidMove) || (k == ttMove) || isACaptureOrPromotion(k))
+                        continue;
+                    // The same killer could be stored twice
+                    if ((current > 1) && (k == killers[0]))
+                        continue;
+                    if (board.isLegal(k))
+                        return k;
+                }
+                currentStage = QuietsGenerationStage;
+                [[fallthrough]];
+
+            case QuietsGenerationStage:
+                board.generateLegalMoves(moves, QuietMoves);
+                numGenerated += static_cast<unsigned int>(moves.size());
+                for (auto i = 0U; i < moves.size(); i++)
+                    scores[i] = (history != nullptr) ? history->score(board.sideToMove, moves[i]) : 0;
+                current = 0;
+                currentStage = QuietsStage;
+                [[fallthrough]];
+
+            case QuietsStage:
+                while (current < moves.size()) {
+                    ChessMove m = pickBest();
+                    if ((m == ttMove) || isKiller(m))
+                        continue;
+                    return m;
+                }
+                current = 0;
+                currentStage = BadCapturesStage;
+                [[fallthrough]];
+
+            case BadCapturesStage:
+                if (current < badCaptures.size())
+                    return badCaptures[current++];
+                currentStage = DoneStage;
+                [[fallthrough]];
+
+            case DoneStage:
+            default:
+                return InvalidMove;
+        }
+    }
+
+} // namespace cSzd
@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "cmdsuzdal/nnue.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CSZD_MMAP_SUPPORTED
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CSZD_SIMD_SUPPORTED
+#include <immintrin.h>
+#endif
+
+namespace cSzd
+{
+    // Maximum number of features changed by a move, and of features active
+    // in a position (all the pieces but the kings)
+    constexpr unsigned int MaxChangedFeatures = 3;
+    constexpr unsigned int MaxActiveFeatures = 30;
+
+    // -------------------------------------------------------------------------
+    // The kernels:
+    //   - updateAccumulator: out = prev + sum(added columns) - sum(removed
+    //     columns), NNUEHiddenSize int16 values (with wrap-around)
+    //   - clipAccumulator: out = clamp(in, 0, 127), n values (n multiple of 32)
+    //   - dense: out[j] = biases[j] + sum(in[i] * weights[j][i]), inSize
+    //     multiple of 32. The inputs are in [0, 127] and the weights in
+    //     [-127, 127], so the int16 sums of pairs of products computed by
+    //     the SIMD kernels never saturate, and all the kernels produce the
+    //     same results
+    struct KernelSet {
+        void (*updateAccumulator)(const std::int16_t *prev, std::int16_t *out,
+                                  const std::int16_t *const *added, unsigned int nAdded,
+                                  const std::int16_t *const *removed, unsigned int nRemoved);
+        void (*clipAccumulator)(const std::int16_t *in, std::uint8_t *out, unsigned int n);
+        void (*dense)(const std::uint8_t *in, unsigned int inSize, const std::int8_t *weights,
+                      const std::int32_t *biases, std::int32_t *out, unsigned int outSize);
+    };
+
+    // --- Scalar kernels ------------------------------
+    static void scalarUpdateAccumulator(const std::int16_t *prev, std::int16_t *out,
+                                        const std::int16_t *const *added, unsigned int nAdded,
+                                        const std::int16_t *const *removed, unsigned int nRemoved)
+    {
+        for (auto i = 0U; i < NNUEHiddenSize; i++) {
+            std::int16_t v = prev[i];
+            for (auto k = 0U; k < nAdded; k++)
+                v = static_cast<std::int16_t>(v + added[k][i]);
+            for (auto k = 0U; k < nRemoved; k++)
+                v = static_cast<std::int16_t>(v - removed[k][i]);
+            out[i] = v;
+        }
+    }
+
+    static void scalarClipAccumulator(const std::int16_t *in, std::uint8_t *out, unsigned int n)
+    {
+        for (auto i = 0U; i < n; i++)
+            out[i] = static_cast<std::uint8_t>(std::clamp<int>(in[i], 0, 127));
+    }
+
+    static void scalarDense(const std::uint8_t *in, unsigned int inSize, const std::int8_t *weights,
+                            const std::int32_t *biases, std::int32_t *out, unsigned int outSize)
+    {
+        for (auto j = 0U; j < outSize; j++) {
+            const std::int8_t *w = weights + j * inSize;
+            std::int32_t sum = biases[j];
+            for (auto i = 0U; i < inSize; i++)
+                sum += in[i] * w[i];
+            out[j] = sum;
+        }
+    }
+
+#if defined(CSZD_SIMD_SUPPORTED)
+    // --- SSSE3 kernels -------------------------------
+    __attribute__((target("ssse3")))
+    static void ssse3UpdateAccumulator(const std::int16_t *prev, std::int16_t *out,
+                                       const std::int16_t *const *added, unsigned int nAdded,
+                                       const std::int16_t *const *removed, unsigned int nRemoved)
+    {
+        for (auto i = 0U; i < NNUEHiddenSize; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(prev + i));
+            for (auto k = 0U; k < nAdded; k++)
+                v = _mm_add_epi16(v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(added[k] + i)));
+            for (auto k = 0U; k < nRemoved; k++)
+                v = _mm_sub_epi16(v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(removed[k] + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), v);
+        }
+    }
+
+    __attribute__((target("ssse3")))
+    static void ssse3ClipAccumulator(const std::int16_t *in, std::uint8_t *out, unsigned int n)
+    {
+        const __m128i max = _mm_set1_epi8(127);
+        for (auto i = 0U; i < n; i += 16) {
+            __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+            __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 8));
+            __m128i packed = _mm_min_epu8(_mm_packus_epi16(lo, hi), max);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), packed);
+        }
+    }
+
+    __attribute__((target("ssse3")))
+    static void ssse3Dense(const std::uint8_t *in, unsigned int inSize, const std::int8_t *weights,
+                           const std::int32_t *biases, std::int32_t *out, unsigned int outSize)
+    {
+        const __m128i ones = _mm_set1_epi16(1);
+        for (auto j = 0U; j < outSize; j++) {
+            const std::int8_t *w = weights + j * inSize;
+            __m128i sum = _mm_setzero_si128();
+            for (auto i = 0U; i < inSize; i += 16) {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+                __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(w + i));
+                sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(x, y), ones));
+            }
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+            out[j] = biases[j] + _mm_cvtsi128_si32(sum);
+        }
+    }
+
+    // --- AVX2 kernels --------------------------------
+    __attribute__((target("avx2")))
+    static void avx2UpdateAccumulator(const std::int16_t *prev, std::int16_t *out,
+                                      const std::int16_t *const *added, unsigned int nAdded,
+                                      const std::int16_t *const *removed, unsigned int nRemoved)
+    {
+        for (auto i = 0U; i < NNUEHiddenSize; i += 16) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(prev + i));
+            for (auto k = 0U; k < nAdded; k++)
+                v = _mm256_add_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(added[k] + i)));
+            for (auto k = 0U; k < nRemoved; k++)
+                v = _mm256_sub_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(removed[k] + i)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), v);
+        }
+    }
+
+    __attribute__((target("avx2")))
+    static void avx2ClipAccumulator(const std::int16_t *in, std::uint8_t *out, unsigned int n)
+    {
+        const __m256i max = _mm256_set1_epi8(127);
+        for (auto i = 0U; i < n; i += 32) {
+            __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+            __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i + 16));
+            // packus works on the 128 bits lanes: the 64 bits blocks are
+            // then reordered
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_min_epu8(packed, max));
+        }
+    }
+
+    __attribute__((target("avx2")))
+    static void avx2Dense(const std::uint8_t *in, unsigned int inSize, const std::int8_t *weights,
+                          const std::int32_t *biases, std::int32_t *out, unsigned int outSize)
+    {
+        const __m256i ones = _mm256_set1_epi16(1);
+        for (auto j = 0U; j < outSize; j++) {
+            const std::int8_t *w = weights + j * inSize;
+            __m256i sum = _mm256_setzero_si256();
+            for (auto i = 0U; i < inSize; i += 32) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+                __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(w + i));
+                sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(x, y), ones));
+            }
+            __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+            s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+            s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+            out[j] = biases[j] + _mm_cvtsi128_si32(s);
+        }
+    }
+
+    constexpr KernelSet Kernels[] = {
+        {scalarUpdateAccumulator, scalarClipAccumulator, scalarDense},
+        {ssse3UpdateAccumulator, ssse3ClipAccumulator, ssse3Dense},
+        {avx2UpdateAccumulator, avx2ClipAccumulator, avx2Dense}
+    };
+#else
+    constexpr KernelSet Kernels[] = {
+        {scalarUpdateAccumulator, scalarClipAccumulator, scalarDense},
+        {scalarUpdateAccumulator, scalarClipAccumulator, scalarDense},
+        {scalarUpdateAccumulator, scalarClipAccumulator, scalarDense}
+    };
+#endif
+
+    // -------------------------------------------------------------------------
+    // Returns the best kernels supported by the CPU. The choice can be
+    // forced setting the CSZD_NNUE_KERNELS environment variable to "scalar"
+    // or "ssse3" (e.g. to compare the performances)
+    static NNUEKernels detectKernels()
+    {
+        NNUEKernels best = ScalarKernels;
+#if defined(CSZD_SIMD_SUPPORTED)
+        // __builtin_cpu_supports also checks that the OS saves the AVX
+        // registers on context switches
+        if (__builtin_cpu_supports("avx2"))
+            best = AVX2Kernels;
+        else if (__builtin_cpu_supports("ssse3"))
+            best = SSSE3Kernels;
+#endif
+        const char *forced = std::getenv("CSZD_NNUE_KERNELS");
+        if ((forced != nullptr) && (std::strcmp(forced, "scalar") == 0))
+            best = ScalarKernels;
+        else if ((forced != nullptr) && (std::strcmp(forced, "ssse3") == 0))
+            best = std::min(best, SSSE3Kernels);
+        return best;
+    }
+
+    NNUEKernels nnueBestKernels()
+    {
+        static const NNUEKernels best = detectKernels();
+        return best;
+    }
+
+    // -------------------------------------------------------------------------
+    NNUE::~NNUE()
+    {
+#if defined(CSZD_MMAP_SUPPORTED)
+        if (mapping != nullptr)
+            munmap(mapping, mappingSize);
+#endif
+    }
+
+    // Maps the weights file. The weights are little endian and are used
+    // directly from the mapped memory, so the network can be loaded only
+    // on little endian hosts
+    bool NNUE::load(const std::string &fileName)
+    {
+#if defined(CSZD_MMAP_SUPPORTED) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+        int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if ((fstat(fd, &st) != 0) || (static_cast<std::size_t>(st.st_size) != NNUEFileSize)) {
+            close(fd);
+            return false;
+        }
+        void *m = mmap(nullptr, NNUEFileSize, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (m == MAP_FAILED)
+            return false;
+
+        // Check the header
+        const char *base = static_cast<const char *>(m);
+        std::uint32_t hdr[5];
+        std::memcpy(hdr, base + 8, sizeof(hdr));
+        if ((std::memcmp(base, "CSZDNNUE", 8) != 0) || (hdr[0] != 1) || (hdr[1] != NNUEFeatures) ||
+            (hdr[2] != NNUEHiddenSize) || (hdr[3] != NNUEDense1Size) || (hdr[4] != NNUEDense2Size)) {
+            munmap(m, NNUEFileSize);
+            return false;
+        }
+
+        if (mapping != nullptr)
+            munmap(mapping, mappingSize);
+        mapping = m;
+        mappingSize = NNUEFileSize;
+        ftBiases = reinterpret_cast<const std::int16_t *>(base + NNUEFTBiasesOffset);
+        ftWeights = reinterpret_cast<const std::int16_t *>(base + NNUEFTWeightsOffset);
+        dense1Biases = reinterpret_cast<const std::int32_t *>(base + NNUEDense1BiasesOffset);
+        dense1Weights = reinterpret_cast<const std::int8_t *>(base + NNUEDense1WeightsOffset);
+        dense2Biases = reinterpret_cast<const std::int32_t *>(base + NNUEDense2BiasesOffset);
+        dense2Weights = reinterpret_cast<const std::int8_t *>(base + NNUEDense2WeightsOffset);
+        outputBias = reinterpret_cast<const std::int32_t *>(base + NNUEOutputBiasOffset);
+        outputWeights = reinterpret_cast<const std::int8_t *>(base + NNUEOutputWeightsOffset);
+        return true;
+#else
+        (void)fileName;
+        return false;
+#endif
+    }
+
+    // The kernels cannot be set to a level not supported by the CPU
+    void NNUE::setKernels(NNUEKernels k)
+    {
+        kern = std::min(k, nnueBestKernels());
+    }
+
+    // -------------------------------------------------------------------------
+    void NNUE::refreshPerspective(const ChessBoard &cb, ArmyColor a, NNUEAccumulator &acc) const
+    {
+        const std::int16_t *added[MaxActiveFeatures];
+        unsigned int nAdded = 0;
+        Cell kingCell = cb.armies[a].getKingPosition();
+        if (kingCell != InvalidCell) {
+            for (auto pc = 0; pc < 2; pc++) {
+                for (auto p = 1U; p < NumPieceTypes; p++) {
+                    for (Cell c : cb.armies[pc].pieces[p]) {
+                        if (nAdded == MaxActiveFeatures)
+                            break;
+                        unsigned int f = nnueFeature(a, kingCell, static_cast<ArmyColor>(pc),
+                                                     static_cast<Piece>(p), c);
+                        added[nAdded++] = ftWeights + f * NNUEHiddenSize;
+                    }
+                }
+            }
+        }
+        Kernels[kern].updateAccumulator(ftBiases, acc.values[a], added, nAdded, nullptr, 0);
+    }
+
+    void NNUE::refresh(const ChessBoard &cb, NNUEAccumulator &acc) const
+    {
+        refreshPerspective(cb, WhiteArmy, acc);
+        refreshPerspective(cb, BlackArmy, acc);
+    }
+
+    // -------------------------------------------------------------------------
+    // Only the features of the pieces moved or captured change, so the
+    // accumulator of each perspective is computed from the previous one.
+    // If a king moves, all the features of its perspective change, and the
+    // perspective is computed from scratch
+    void NNUE::update(const ChessBoard &cb, const ChessMove &m, const UndoInfo &undo,
+                      const NNUEAccumulator &prev, NNUEAccumulator &acc) const
+    {
+        struct PieceInCell { ArmyColor a; Piece p; Cell c; };
+        PieceInCell added[MaxChangedFeatures];
+        PieceInCell removed[MaxChangedFeatures];
+        unsigned int nAdded = 0;
+        unsigned int nRemoved = 0;
+
+        ArmyColor them = cb.sideToMove;
+        ArmyColor us = (them == WhiteArmy) ? BlackArmy : WhiteArmy;
+        Piece movedPiece = chessMoveGetMovedPiece(m);
+        Piece takenPiece = chessMoveGetTakenPiece(m);
+        Piece promotedPiece = chessMoveGetPromotedPiece(m);
+        Cell startCell = chessMoveGetStartingCell(m);
+        Cell destCell = chessMoveGetDestinationCell(m);
+
+        if (movedPiece != King) {
+            removed[nRemoved++] = {us, movedPiece, startCell};
+            added[nAdded++] = {us, (promotedPiece != InvalidPiece) ? promotedPiece : movedPiece, destCell};
+        }
+        else if (isACastlingMove(m)) {
+            switch (destCell) {
+                case g1: removed[nRemoved++] = {us, Rook, h1}; added[nAdded++] = {us, Rook, f1}; break;
+                case c1: removed[nRemoved++] = {us, Rook, a1}; added[nAdded++] = {us, Rook, d1}; break;
+                case g8: removed[nRemoved++] = {us, Rook, h8}; added[nAdded++] = {us, Rook, f8}; break;
+                default: removed[nRemoved++] = {us, Rook, a8}; added[nAdded++] = {us, Rook, d8}; break;
+            }
+        }
+        if (takenPiece != InvalidPiece) {
+            // A pawn captured by a pawn moving to the en passant target
+            // square was captured en passant
+            Cell capturedPieceCell = destCell;
+            if ((movedPiece == Pawn) && (takenPiece == Pawn) &&
+                (undo.enPassantTargetSquare == singlecell(destCell))) {
+                capturedPieceCell = toCell(file(destCell), rank(startCell));
+            }
+            removed[nRemoved++] = {them, takenPiece, capturedPieceCell};
+        }
+
+        for (auto a : {WhiteArmy, BlackArmy}) {
+            Cell kingCell = cb.armies[a].getKingPosition();
+            if ((movedPiece == King) && (a == us)) {
+                refreshPerspective(cb, a, acc);
+                continue;
+            }
+            if (kingCell == InvalidCell) {
+                std::memcpy(acc.values[a], prev.values[a], sizeof(acc.values[a]));
+                continue;
+            }
+            const std::int16_t *addedCols[MaxChangedFeatures];
+            const std::int16_t *removedCols[MaxChangedFeatures];
+            for (auto k = 0U; k < nAdded; k++)
+                addedCols[k] = ftWeights + nnueFeature(a, kingCell, added[k].a, added[k].p, added[k].c) * NNUEHiddenSize;
+            for (auto k = 0U; k < nRemoved; k++)
+                removedCols[k] = ftWeights + nnueFeature(a, kingCell, removed[k].a, removed[k].p, removed[k].c) * NNUEHiddenSize;
+            Kernels[kern].updateAccumulator(prev.values[a], acc.values[a], addedCols, nAdded, removedCols, nRemoved);
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    int NNUE::evaluate(const NNUEAccumulator &acc, ArmyColor sideToMove) const
+    {
+        const KernelSet &k = Kernels[kern];
+        ArmyColor other = (sideToMove == WhiteArmy) ? BlackArmy : WhiteArmy;
+
+        alignas(64) std::uint8_t transformed[2 * NNUEHiddenSize];
+        k.clipAccumulator(acc.values[sideToMove], transformed, NNUEHiddenSize);
+        k.clipAccumulator(acc.values[other], transformed + NNUEHiddenSize, NNUEHiddenSize);
+
+        alignas(64) std::int32_t dense1Out[NNUEDense1Size];
+        alignas(64) std::uint8_t hidden1[NNUEDense1Size];
+        k.dense(transformed, 2 * NNUEHiddenSize, dense1Weights, dense1Biases, dense1Out, NNUEDense1Size);
+        for (auto i = 0U; i < NNUEDense1Size; i++)
+            hidden1[i] = static_cast<std::uint8_t>(std::clamp(dense1Out[i] >> NNUEWeightScaleBits, 0, 127));
+
+        alignas(64) std::int32_t dense2Out[NNUEDense2Size];
+        alignas(64) std::uint8_t hidden2[NNUEDense2Size];
+        k.dense(hidden1, NNUEDense1Size, dense2Weights, dense2Biases, dense2Out, NNUEDense2Size);
+        for (auto i = 0U; i < NNUEDense2Size; i++)
+            hidden2[i] = static_cast<std::uint8_t>(std::clamp(dense2Out[i] >> NNUEWeightScaleBits, 0, 127));
+
+        std::int32_t output;
+        k.dense(hidden2, NNUEDense2Size, outputWeights, outputBias, &output, 1);
+        return output / NNUEOutputScale;
+    }
+
+} // namespace cSzd
@@ -0,0 +1,150 @@
+#include "cmdsuzdal/perft.h"
+
+namespace cSzd
+{
+
+    // -----------------------------------------------------------------
+    PerftHashTable::PerftHashTable(std::size_t sizeMB)
+    {
+        // The number of entries is the largest power of two fitting
+        // in the specified size (at least one entry is allocated)
+        std::size_t n = (sizeMB << 20) / sizeof(Entry);
+        std::size_t numEntries = 1;
+        while ((numEntries << 1) <= n)
+            numEntries <<= 1;
+        entries = std::make_unique<Entry[]>(numEntries);
+        mask = numEntries - 1;
+    }
+
+    // The data of an entry are the nodes (upper 56 bits) and the depth (lower 8 bits)
+    bool PerftHashTable::probe(std::uint64_t key, unsigned int depth, std::uint64_t &nodes) const
+    {
+        const Entry &e = entries[key & mask];
+        std::uint64_t data = e.data.load(std::memory_order_relaxed);
+        std::uint64_t keyXorData = e.keyXorData.load(std::memory_order_relaxed);
+        if (((keyXorData ^ data) != key) || ((data & 0xFF) != depth))
+            return false;
+        nodes = data >> 8;
+        return true;
+    }
+
+    void PerftHashTable::store(std::uint64_t key, unsigned int depth, std::uint64_t nodes)
+    {
+        Entry &e = entries[key & mask];
+        std::uint64_t data = (nodes << 8) | (depth & 0xFF);
+        e.keyXorData.store(key ^ data, std::memory_order_relaxed);
+        e.data.store(data, std::memory_order_relaxed);
+    }
+
+    void PerftHashTable::clear()
+    {
+        for (auto i = 0U; i <= mask; i++) {
+            entries[i].keyXorData.store(0, std::memory_order_relaxed);
+            entries[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // -----------------------------------------------------------------
+    // The tree is walked in place, executing and undoing the moves on the
+    // same board
+    static std::uint64_t perftInPlace(ChessBoard &cb, unsigned int depth, PerftHashTable *hashTable)
+    {
+        if (depth == 0)
+            return 1;
+
+        // The results of depth 1 are not cached: generating
+        // the moves costs less than probing the table
+        std::uint64_t key = cb.hashKey;
+        std::uint64_t nodes = 0;
+        if ((hashTable != nullptr) && (depth > 1)) {
+            if (hashTable->probe(key, depth, nodes))
+                return nodes;
+        }
+
+        MoveList moves;
+        cb.generateLegalMoves(moves);
+        // Bulk counting: the leaf nodes are the legal moves of
+        // the last level, so there is no need to execute them
+        if (depth == 1)
+            return moves.size();
+
+        for (auto &m : moves) {
+            UndoInfo undo = cb.doMove(m);
+            nodes += perftInPlace(cb, depth - 1, hashTable);
+            cb.undoMove(m, undo);
+        }
+        if (hashTable != nullptr)
+            hashTable->store(key, depth, nodes);
+        return nodes;
+    }
+
+    std::uint64_t perft(const ChessBoard &cb, unsigned int depth, PerftHashTable *hashTable)
+    {
+        ChessBoard board = cb;
+        return perftInPlace(board, depth, hashTable);
+    }
+
+    // -----------------------------------------------------------------
+    std::vector<PerftDivideEntry> perftDivide(const ChessBoard &cb, unsigned int depth,
+                                              PerftHashTable *hashTable)
+    {
+        std::vector<PerftDivideEntry> entries;
+        if (depth == 0)
+            return entries;
+
+        ChessBoard board = cb;
+        MoveList moves;
+        board.generateLegalMoves(moves);
+        for (auto &m : moves) {
+            UndoInfo undo = board.doMove(m);
+            entries.push_back({m, perftInPlace(board, depth - 1, hashTable)});
+            board.undoMove(m, undo);
+        }
+        return entries;
+    }
+
+    // -----------------------------------------------------------------
+    std::vector<PerftDivideEntry> perftDivide(const ChessBoard &cb, unsigned int depth,
+                                              ThreadPool &pool, PerftHashTable *hashTable)
+    {
+        std::vector<PerftDivideEntry> entries;
+        if (depth == 0)
+            return entries;
+
+        MoveList moves;
+        cb.generateLegalMoves(moves);
+        std::vector<std::atomic<std::uint64_t>> nodes(moves.size());
+        for (auto &n : nodes)
+            n = 0;
+
+        // The root moves are usually few (20-50), and their subtrees have very
+        // different sizes: for deep perfts the tasks are the subtrees of the
+        // replies to the root moves, so there are enough tasks to balance
+        // the load among the threads
+        for (auto i = 0U; i < moves.size(); i++) {
+            ChessBoard child = cb;
+            child.doMove(moves[i]);
+            if (depth < 3) {
+                pool.submit([child, depth, hashTable, &n = nodes[i]] {
+                    n += perft(child, depth - 1, hashTable);
+                });
+                continue;
+            }
+            MoveList replies;
+            child.generateLegalMoves(replies);
+            for (auto &r : replies) {
+                ChessBoard grandChild = child;
+                grandChild.doMove(r);
+                pool.submit([grandChild, depth, hashTable, &n = nodes[i]] {
+                    n += perft(grandChild, depth - 2, hashTable);
+                });
+            }
+        }
+        pool.wait();
+
+        for (auto i = 0U; i < moves.size(); i++)
+            entries.push_back({moves[i], nodes[i]});
+        return entries;
+    }
+
+} // namespace cSzd
@@ -0,0 +1,354 @@
+#include <algorithm>
+
+#include "cmdsuzdal/pgnfile.h"
+
+namespace cSzd
+{
+    // The chunks decoded in parallel end at the first game boundary after
+    // this size; a window of a few chunks per thread is decoded at a time
+    constexpr std::size_t PGNChunkSize = 1024 * 1024;
+    constexpr unsigned int PGNChunksPerThread = 4;
+
+    static bool isPGNBlank(char ch) { return (ch == ' ') || (ch == '\t') || (ch == '\r') || (ch == '\n'); }
+    static bool isPGNDigit(char ch) { return (ch >= '0') && (ch <= '9'); }
+    static bool isSANSuffix(char ch) { return (ch == '+') || (ch == '#') || (ch == '!') || (ch == '?'); }
+    static bool isTagNameChar(char ch)
+    {
+        return ((ch >= 'a') && (ch <= 'z')) || ((ch >= 'A') && (ch <= 'Z')) || isPGNDigit(ch) || (ch == '_');
+    }
+
+    // -------------------------------------------------------------------------
+    const char *pgnErrorDescription(PGNError e)
+    {
+        switch (e) {
+            case PGNNoError:               return "no error";
+            case PGNInvalidTag:            return "invalid tag pair";
+            case PGNInvalidPosition:       return "invalid FEN tag";
+            case PGNInvalidMove:           return "invalid or illegal move";
+            case PGNUnterminatedComment:   return "unterminated comment";
+            case PGNUnterminatedVariation: return "unterminated variation";
+            default:                       return "unknown error";
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // The index after the end of the line of ndx
+    static std::size_t skipLine(const std::string_view text, std::size_t ndx)
+    {
+        std::size_t eol = text.find('\n', ndx);
+        return (eol == std::string_view::npos) ? text.size() : eol + 1;
+    }
+
+    // [Name "Value"], with the escaped characters (\" and \\) in the value
+    static PGNError parsePGNTag(const std::string_view text, std::size_t &ndx, std::map<std::string, std::string> &tags)
+    {
+        std::size_t n = text.size();
+        ndx++;
+        while ((ndx < n) && isPGNBlank(text[ndx]))
+            ndx++;
+        std::size_t start = ndx;
+        while ((ndx < n) && isTagNameChar(text[ndx]))
+            ndx++;
+        std::string name(text.substr(start, ndx - start));
+        while ((ndx < n) && isPGNBlank(text[ndx]))
+            ndx++;
+        if (name.empty() || (ndx >= n) || (text[ndx] != '"'))
+            return PGNInvalidTag;
+
+        std::string value;
+        for (ndx++; (ndx < n) && (text[ndx] != '"'); ndx++) {
+            if ((text[ndx] == '\\') && (ndx + 1 < n))
+                ndx++;
+            value += text[ndx];
+        }
+        if (ndx >= n)
+            return PGNInvalidTag;
+        for (ndx++; (ndx < n) && isPGNBlank(text[ndx]); ndx++) {}
+        if ((ndx >= n) || (text[ndx] != ']'))
+            return PGNInvalidTag;
+        ndx++;
+        tags.insert_or_assign(std::move(name), std::move(value));
+        return PGNNoError;
+    }
+
+    // Skips a (nested) variation, and its comments
+    static PGNError skipPGNVariation(const std::string_view text, std::size_t &ndx)
+    {
+        unsigned int depth = 0;
+        while (ndx < text.size()) {
+            char ch = text[ndx];
+            if (ch == '{') {
+                std::size_t close = text.find('}', ndx + 1);
+                if (close == std::string_view::npos)
+                    return PGNUnterminatedComment;
+                ndx = close + 1;
+                continue;
+            }
+            if (ch == ';') {
+                ndx = skipLine(text, ndx);
+                continue;
+            }
+            if (ch == '(')
+                depth++;
+            else if ((ch == ')') && (--depth == 0)) {
+                ndx++;
+                return PGNNoError;
+            }
+            ndx++;
+        }
+        return PGNUnterminatedVariation;
+    }
+
+    // -------------------------------------------------------------------------
+    PGNError parsePGNGame(const std::string_view text, PGNGame &game)
+    {
+        static const ChessBoard InitialBoard;
+
+        game.tags.clear();
+        game.moves.clear();
+        game.result.clear();
+
+        // Tag section (and the escape lines, starting with %)
+        std::size_t n = text.size();
+        std::size_t ndx = 0;
+        while (ndx < n) {
+            if (isPGNBlank(text[ndx])) {
+                ndx++;
+            }
+            else if ((text[ndx] == '%') && ((ndx == 0) || (text[ndx - 1] == '\n'))) {
+                ndx = skipLine(text, ndx);
+            }
+            else if (text[ndx] == '[') {
+                PGNError e = parsePGNTag(text, ndx, game.tags);
+                if (e != PGNNoError)
+                    return e;
+            }
+            else {
+                break;
+            }
+        }
+
+        ChessBoard cb = InitialBoard;
+        auto fen = game.tags.find("FEN");
+        if ((fen != game.tags.end()) && (cb.loadPosition(fen->second) != FENNoError))
+            return PGNInvalidPosition;
+
+        // Movetext, up to the result
+        MoveList legalMoves;
+        while ((ndx < n) && game.result.empty()) {
+            char ch = text[ndx];
+            if (isPGNBlank(ch)) {
+                ndx++;
+            }
+            else if (ch == '{') {
+                std::size_t close = text.find('}', ndx + 1);
+                if (close == std::string_view::npos)
+                    return PGNUnterminatedComment;
+                ndx = close + 1;
+            }
+            else if ((ch == ';') || ((ch == '%') && (text[ndx - 1] == '\n'))) {
+                ndx = skipLine(text, ndx);
+            }
+            else if (ch == '(') {
+                PGNError e = skipPGNVariation(text, ndx);
+                if (e != PGNNoError)
+                    return e;
+            }
+            else if (ch == ')') {
+                return PGNUnterminatedVariation;
+            }
+            else if (ch == '$') {
+                for (ndx++; (ndx < n) && isPGNDigit(text[ndx]); ndx++) {}
+            }
+            else {
+                std::size_t start = ndx;
+                while ((ndx < n) && !isPGNBlank(text[ndx]) && (text[ndx] != '{') && (text[ndx] != '(') &&
+                       (text[ndx] != ')') && (text[ndx] != ';') && (text[ndx] != '$'))
+                    ndx++;
+                std::string_view token = text.substr(start, ndx - start);
+                if ((token == "1-0") || (token == "0-1") || (token == "1/2-1/2") || (token == "*")) {
+                    game.result = token;
+                    break;
+                }
+
+                // Move number ("12.", "12...", also attached to the move: "12.e4")
+                std::size_t d = 0;
+                while ((d < token.size()) && isPGNDigit(token[d]))
+                    d++;
+                if ((d == token.size()) || (token[d] == '.')) {
+                    while ((d < token.size()) && (token[d] == '.'))
+                        d++;
+                    token.remove_prefix(d);
+                }
+                if (std::all_of(token.begin(), token.end(), isSANSuffix))
+                    continue;
+
+                cb.generateLegalMoves(legalMoves);
+                ChessMove m = resolveSANMove(cb, legalMoves, token);
+                if (m == InvalidMove)
+                    return PGNInvalidMove;
+                game.moves.push_back(m);
+                cb.doMove(m);
+            }
+        }
+
+        if (game.result.empty()) {
+            auto result = game.tags.find("Result");
+            if (result != game.tags.end())
+                game.result = result->second;
+        }
+        return PGNNoError;
+    }
+
+    // -------------------------------------------------------------------------
+    // The first not blank character of the line [p, eol)
+    static const char *lineContent(const char *p, const char *eol)
+    {
+        while ((p < eol) && ((*p == ' ') || (*p == '\t') || (*p == '\r')))
+            p++;
+        return p;
+    }
+
+    // Decodes the games of a text of whole games, passing them to f.
+    // A tag line after the movetext of a game starts a new game
+    template <typename F>
+    static PGNFileStats parseGames(std::string_view text, std::size_t textOffset, F &&f)
+    {
+        PGNFileStats stats;
+        PGNGame game;
+        const char *begin = text.data();
+        const char *end = begin + text.size();
+        const char *gameStart = nullptr;
+        bool inMovetext = false;
+
+        auto decode = [&](const char *gameEnd) {
+            game.offset = textOffset + static_cast<std::size_t>(gameStart - begin);
+            PGNError e = parsePGNGame(std::string_view(gameStart, static_cast<std::size_t>(gameEnd - gameStart)), game);
+            if (e != PGNNoError) {
+                if (stats.errors++ == 0) {
+                    stats.firstError = e;
+                    stats.firstErrorOffset = game.offset;
+                }
+                return;
+            }
+            stats.games++;
+            stats.moves += game.moves.size();
+            f(game);
+        };
+
+        for (const char *p = begin; p < end; ) {
+            const char *eol = findNewline(p, end);
+            const char *content = lineContent(p, eol);
+            if (content < eol) {
+                bool tag = (*content == '[');
+                if (tag && inMovetext) {
+                    decode(p);
+                    gameStart = nullptr;
+                    inMovetext = false;
+                }
+                if (gameStart == nullptr)
+                    gameStart = p;
+                if (!tag && (*content != '%'))
+                    inMovetext = true;
+            }
+            p = eol + 1;
+        }
+        if (gameStart != nullptr)
+            decode(end);
+        return stats;
+    }
+
+    static void mergeStats(PGNFileStats &total, const PGNFileStats &chunk)
+    {
+        total.games += chunk.games;
+        total.moves += chunk.moves;
+        if ((total.errors == 0) && (chunk.errors > 0)) {
+            total.firstError = chunk.firstError;
+            total.firstErrorOffset = chunk.firstErrorOffset;
+        }
+        total.errors += chunk.errors;
+    }
+
+    // -------------------------------------------------------------------------
+    // A game starts with a tag line that does not follow another tag line
+    // (the blank and the escape lines between them are not considered)
+    std::size_t PGNFile::nextGame(std::size_t offset) const
+    {
+        std::string_view text = contents();
+        if (offset >= text.size())
+            return text.size();
+        const char *data = text.data();
+        const char *end = data + text.size();
+        const char *p = data + offset;
+        if ((offset > 0) && (p[-1] != '\n'))
+            p = findNewline(p, end) + 1;
+
+        for (; p < end; ) {
+            const char *eol = findNewline(p, end);
+            const char *content = lineContent(p, eol);
+            if ((content < eol) && (*content == '[')) {
+                // The previous line with some content
+                bool afterTag = false;
+                for (const char *q = p; q > data; ) {
+                    const char *prevEnd = q - 1;
+                    const char *prev = prevEnd;
+                    while ((prev > data) && (prev[-1] != '\n'))
+                        prev--;
+                    const char *c = lineContent(prev, prevEnd);
+                    if ((c < prevEnd) && (*c != '%')) {
+                        afterTag = (*c == '[');
+                        break;
+                    }
+                    q = prev;
+                }
+                if (!afterTag)
+                    return static_cast<std::size_t>(p - data);
+            }
+            p = eol + 1;
+        }
+        return text.size();
+    }
+
+    // From the beginning of the file, the first game can be without tags
+    std::size_t PGNFile::firstGame(std::size_t startOffset) const
+    {
+        return (startOffset == 0) ? 0 : nextGame(startOffset);
+    }
+
+    // -------------------------------------------------------------------------
+    PGNFileStats PGNFile::forEach(const PGNGameCallback &callback, std::size_t startOffset) const
+    {
+        std::size_t first = firstGame(startOffset);
+        return parseGames(contents().substr(std::min(first, contents().size())), first, callback);
+    }
+
+    // The windows are decoded one after the other, so that only the games
+    // of a window are in flight; the stats are merged in the order of the
+    // file, so the first error is the first one of the file
+    PGNFileStats PGNFile::forEach(const PGNGameCallback &callback, ThreadPool &pool, std::size_t startOffset) const
+    {
+        std::string_view text = contents();
+        std::size_t size = text.size();
+        PGNFileStats stats;
+        unsigned int chunksPerWindow = std::max(pool.size(), 1U) * PGNChunksPerThread;
+        for (std::size_t begin = firstGame(startOffset); begin < size; ) {
+            std::vector<std::string_view> parts;
+            while ((begin < size) && (parts.size() < chunksPerWindow)) {
+                std::size_t end = nextGame(std::min(begin + PGNChunkSize, size));
+                parts.push_back(text.substr(begin, end - begin));
+                begin = end;
+            }
+            std::vector<PGNFileStats> partStats(parts.size());
+            for (auto i = 0U; i < parts.size(); i++) {
+                pool.submit([i, &text, &parts, &partStats, &callback] {
+                    partStats[i] = parseGames(parts[i], static_cast<std::size_t>(parts[i].data() - text.data()), callback);
+                });
+            }
+            pool.wait();
+            for (auto &s : partStats)
+                mergeStats(stats, s);
+        }
+        return stats;
+    }
+
+} // namespace cSzd
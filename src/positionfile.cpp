@@ -0,0 +1,230 @@
+#include <algorithm>
+
+#include "cmdsuzdal/positionfile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CSZD_MMAP_SUPPORTED
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__)
+#define CSZD_SSE2_SUPPORTED
+#include <emmintrin.h>
+#endif
+
+namespace cSzd
+{
+    // The chunks parsed in parallel are not smaller than this, and each
+    // thread of the pool gets a few of them, to balance the load
+    constexpr std::size_t MinChunkSize = 64 * 1024;
+    constexpr unsigned int ChunksPerThread = 4;
+
+    // -------------------------------------------------------------------------
+    const char *findNewline(const char *begin, const char *end)
+    {
+        const char *p = begin;
+#if defined(CSZD_SSE2_SUPPORTED)
+        const __m128i newlines = _mm_set1_epi8('\n');
+        for (; end - p >= 16; p += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newlines));
+            if (mask != 0)
+                return p + __builtin_ctz(static_cast<unsigned int>(mask));
+        }
+#endif
+        for (; p < end; p++) {
+            if (*p == '\n')
+                return p;
+        }
+        return end;
+    }
+
+    // -------------------------------------------------------------------------
+    // Parses the lines of a chunk, passing the positions to f
+    template <typename F>
+    static PositionFileStats parseChunk(std::string_view chunk, std::size_t chunkOffset,
+                                        PositionFileFormat fmt, F &&f)
+    {
+        PositionFileStats stats;
+        ChessBoard cb;
+        FENPosition pos;
+        const char *begin = chunk.data();
+        const char *end = begin + chunk.size();
+        for (const char *p = begin; p < end; ) {
+            const char *eol = findNewline(p, end);
+            std::string_view line(p, static_cast<std::size_t>(eol - p));
+            std::size_t lineOffset = chunkOffset + static_cast<std::size_t>(p - begin);
+            p = eol + 1;
+
+            if (std::all_of(line.begin(), line.end(), [](char ch) { return (ch == ' ') || (ch == '\t') || (ch == '\r'); }))
+                continue;
+            stats.lines++;
+            FENError e;
+            if (fmt == EPDFile) {
+                std::string_view operations;
+                e = parseEPDPosition(line, pos, operations);
+            }
+            else {
+                e = parseFEN(line, pos);
+            }
+            if (e != FENNoError) {
+                if (stats.errors++ == 0) {
+                    stats.firstError = e;
+                    stats.firstErrorOffset = lineOffset;
+                }
+                continue;
+            }
+            cb.loadPosition(pos);
+            stats.positions++;
+            f(cb, lineOffset);
+        }
+        return stats;
+    }
+
+    // The chunks are processed in the order of the file, so the first error
+    // of the file is the first one of the first chunk with errors
+    static void mergeStats(PositionFileStats &total, const PositionFileStats &chunk)
+    {
+        total.lines += chunk.lines;
+        total.positions += chunk.positions;
+        if ((total.errors == 0) && (chunk.errors > 0)) {
+            total.firstError = chunk.firstError;
+            total.firstErrorOffset = chunk.firstErrorOffset;
+        }
+        total.errors += chunk.errors;
+    }
+
+    // -------------------------------------------------------------------------
+    PositionFile::~PositionFile()
+    {
+        close();
+    }
+
+    bool PositionFile::open(const std::string &fileName)
+    {
+        close();
+#if defined(CSZD_MMAP_SUPPORTED)
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if ((fstat(fd, &st) != 0) || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            return false;
+        }
+        size = static_cast<std::size_t>(st.st_size);
+        if (size > 0) {
+            void *m = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m == MAP_FAILED) {
+                ::close(fd);
+                size = 0;
+                return false;
+            }
+            madvise(m, size, MADV_SEQUENTIAL);
+            mapping = m;
+            data = static_cast<const char *>(m);
+        }
+        ::close(fd);
+
+        std::string_view ext(fileName);
+        ext = (ext.size() >= 4) ? ext.substr(ext.size() - 4) : std::string_view();
+        fmt = ((ext == ".epd") || (ext == ".EPD")) ? EPDFile : FENFile;
+        opened = true;
+        return true;
+#else
+        (void)fileName;
+        return false;
+#endif
+    }
+
+    void PositionFile::close()
+    {
+#if defined(CSZD_MMAP_SUPPORTED)
+        if (mapping != nullptr)
+            munmap(mapping, size);
+#endif
+        mapping = nullptr;
+        data = nullptr;
+        size = 0;
+        opened = false;
+    }
+
+    // -------------------------------------------------------------------------
+    // Splits the file in (at most) numChunks chunks of whole lines: a line
+    // belongs to the chunk where it starts
+    std::vector<std::string_view> PositionFile::chunks(unsigned int numChunks) const
+    {
+        std::vector<std::string_view> result;
+        std::size_t chunkSize = std::max(MinChunkSize, size / std::max(numChunks, 1U));
+        const char *end = data + size;
+        for (const char *p = data; p < end; ) {
+            const char *next = (static_cast<std::size_t>(end - p) > chunkSize) ? p + chunkSize : end;
+            if (next < end)
+                next = std::min(findNewline(next, end) + 1, end);
+            result.emplace_back(p, static_cast<std::size_t>(next - p));
+            p = next;
+        }
+        return result;
+    }
+
+    // -------------------------------------------------------------------------
+    PositionFileStats PositionFile::load(std::vector<ChessBoard> &positions) const
+    {
+        return parseChunk(contents(), 0, fmt, [&positions](const ChessBoard &cb, std::size_t) {
+            positions.push_back(cb);
+        });
+    }
+
+    // Each chunk is loaded in its own vector, then the vectors are appended
+    // to positions in the order of the file
+    PositionFileStats PositionFile::load(std::vector<ChessBoard> &positions, ThreadPool &pool) const
+    {
+        std::vector<std::string_view> parts = chunks(pool.size() * ChunksPerThread);
+        std::vector<std::vector<ChessBoard>> partPositions(parts.size());
+        std::vector<PositionFileStats> partStats(parts.size());
+        for (auto i = 0U; i < parts.size(); i++) {
+            pool.submit([this, i, &parts, &partPositions, &partStats] {
+                std::vector<ChessBoard> &out = partPositions[i];
+                out.reserve(parts[i].size() / 64);
+                partStats[i] = parseChunk(parts[i], static_cast<std::size_t>(parts[i].data() - data), fmt,
+                                          [&out](const ChessBoard &cb, std::size_t) { out.push_back(cb); });
+            });
+        }
+        pool.wait();
+
+        PositionFileStats stats;
+        for (auto &s : partStats)
+            mergeStats(stats, s);
+        positions.reserve(positions.size() + stats.positions);
+        for (auto &part : partPositions)
+            positions.insert(positions.end(), part.begin(), part.end());
+        return stats;
+    }
+
+    // -------------------------------------------------------------------------
+    PositionFileStats PositionFile::forEach(const PositionCallback &callback) const
+    {
+        return parseChunk(contents(), 0, fmt, callback);
+    }
+
+    PositionFileStats PositionFile::forEach(const PositionCallback &callback, ThreadPool &pool) const
+    {
+        std::vector<std::string_view> parts = chunks(pool.size() * ChunksPerThread);
+        std::vector<PositionFileStats> partStats(parts.size());
+        for (auto i = 0U; i < parts.size(); i++) {
+            pool.submit([this, i, &parts, &partStats, &callback] {
+                partStats[i] = parseChunk(parts[i], static_cast<std::size_t>(parts[i].data() - data), fmt, callback);
+            });
+        }
+        pool.wait();
+
+        PositionFileStats stats;
+        for (auto &s : partStats)
+            mergeStats(stats, s);
+        return stats;
+    }
+
+} // namespace cSzd
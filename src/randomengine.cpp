@@ -11,7 +11,7 @@ namespace cSzd
 
     ChessMove RandomEngine::move(const ChessBoard &cb)
     {
-        std::vector<ChessMove> moves;
+        MoveList moves;
         cb.generateLegalMoves(moves);
         if (moves.size() > 0) {
             return moves[randomizer(moves.size())];
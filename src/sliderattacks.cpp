@@ -0,0 +1,321 @@
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "cmdsuzdal/sliderattacks.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CSZD_PEXT_SUPPORTED
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace cSzd
+{
+    // Magic numbers used to compute the index of the attacks tables.
+    // These values have been found with a trial and error search using
+    // sparse random numbers (the classic approach, see for example
+    // https://www.chessprogramming.org/Looking_for_Magics)
+    constexpr BitBoardState BishopMagics[64]{
+        0x0003100401004A00ULL, 0x0024814802088018ULL, 0x000802104A060258ULL, 0x2004040485004200ULL,
+        0x0081114006000001ULL, 0x5902080288240C05ULL, 0x2088880450044100ULL, 0x4002012208047441ULL,
+        0x000424605C410208ULL, 0x02000401020A0214ULL, 0x1100211204004000ULL, 0x0000490411040400ULL,
+        0x041A040420000900ULL, 0x7014008804400000ULL, 0x1002008808029004ULL, 0x402000491C100200ULL,
+        0x5420040802844806ULL, 0x0444301001380100ULL, 0x8048029000202823ULL, 0x8404000801433210ULL,
+        0x0008200308401480ULL, 0x0000800100514010ULL, 0x080A100048020880ULL, 0x0801002B82809000ULL,
+        0x8010048011200200ULL, 0x0001200004189200ULL, 0x5054100001010024ULL, 0x080B080003014100ULL,
+        0xA000840084802020ULL, 0x0001010222006100ULL, 0x0A010C000600A400ULL, 0x0004842201012801ULL,
+        0x0032200481200840ULL, 0x048890088A140802ULL, 0x2802005000010904ULL, 0x080C020080080080ULL,
+        0x00400802008E4104ULL, 0x0450100040002400ULL, 0x082A208400051443ULL, 0x1042008E08810841ULL,
+        0x210C300404209209ULL, 0x0020480824200810ULL, 0x0082002028000410ULL, 0x0140002018001100ULL,
+        0x2000100A0090E606ULL, 0x0840428302100501ULL, 0x0E04882081020400ULL, 0x0024080200403024ULL,
+        0x0109080844048C19ULL, 0x0040240108080000ULL, 0x0030004044104644ULL, 0x0640111242062001ULL,
+        0x1049100810240230ULL, 0x4050082248C20000ULL, 0x9204040808610000ULL, 0x0010240800942400ULL,
+        0x0241010042224005ULL, 0x0000130108822001ULL, 0x8004800108880410ULL, 0x8015081002050400ULL,
+        0x1000002266208200ULL, 0x0800090408908100ULL, 0xC200302018012049ULL, 0x8440010409005100ULL
+    };
+
+    constexpr BitBoardState RookMagics[64]{
+        0x2080001880634000ULL, 0x0440082000401000ULL, 0x0280100080200008ULL, 0x0080100080080004ULL,
+        0x5080040080080003ULL, 0x8200040200011008ULL, 0x0880008002000100ULL, 0x0100082140820500ULL,
+        0x8000800040008021ULL, 0x0005400040201000ULL, 0x8300802000801000ULL, 0x2002001040220008ULL,
+        0x0084800400820800ULL, 0x8413000284010048ULL, 0x130400A104420810ULL, 0x0041000100008852ULL,
+        0x0040288000904000ULL, 0x1010004020004000ULL, 0x0012420022021480ULL, 0x002042000A220010ULL,
+        0x0268004004020040ULL, 0x2102808004010200ULL, 0x3020440048011082ULL, 0x0850020000996401ULL,
+        0x0060800080204000ULL, 0x1080200080804000ULL, 0x2101001100200044ULL, 0x0020080080100080ULL,
+        0x2008080080040080ULL, 0x0094000202000810ULL, 0x000A810080800200ULL, 0x4C00048A00104304ULL,
+        0x5000400024800080ULL, 0x0000200046401001ULL, 0x0008408022001200ULL, 0x0000080080801004ULL,
+        0x6CC0040801001100ULL, 0x0004001002020008ULL, 0x2206000402000108ULL, 0x000C040042003081ULL,
+        0x8000800040018020ULL, 0x0800200040008080ULL, 0x0120010040210017ULL, 0x0000080010008080ULL,
+        0x0018010008110004ULL, 0x808A000400808002ULL, 0x0006011008440042ULL, 0x0200011060820004ULL,
+        0x40024010800D2080ULL, 0x4040008040200280ULL, 0x0000805001200180ULL, 0x0520220040081200ULL,
+        0x4000800400080080ULL, 0x0000800400060180ULL, 0x0000821849100400ULL, 0x000C091444109200ULL,
+        0x0080010044102481ULL, 0x0420220100881042ULL, 0x0AA20D0010412001ULL, 0x0242000804204012ULL,
+        0x202200881004A002ULL, 0x0002001110681402ULL, 0x884A020108009004ULL, 0x0140068404411222ULL
+    };
+
+    // Directions of movement of the sliders ({stepNorth, stepEast})
+    constexpr int BishopDirections[4][2]{{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+    constexpr int RookDirections[4][2]{{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+    // -------------------------------------------------------------------------
+    // Slow (ray by ray) computation of the attacks of a slider: used only to
+    // fill the attacks tables. If relevantOnly is true, the returned state
+    // contains only the relevant occupancy cells of the rays, that is the
+    // cells of the rays excluding the last one of each direction
+    static BitBoardState slidingAttacks(Cell c, BitBoardState occupancy,
+                                        const int (&directions)[4][2], bool relevantOnly)
+    {
+        BitBoardState attacks = EmptyBB;
+        for (auto &d : directions) {
+            int r = static_cast<int>(rank(c)) + d[0];
+            int f = static_cast<int>(file(c)) + d[1];
+            while ((r >= 0) && (r < 8) && (f >= 0) && (f < 8)) {
+                if (relevantOnly) {
+                    int nextR = r + d[0];
+                    int nextF = f + d[1];
+                    if ((nextR < 0) || (nextR > 7) || (nextF < 0) || (nextF > 7))
+                        break;
+                }
+                attacks |= 1ULL << (r * 8 + f);
+                if (occupancy & (1ULL << (r * 8 + f)))
+                    break;
+                r += d[0];
+                f += d[1];
+            }
+        }
+        return attacks;
+    }
+
+    // -------------------------------------------------------------------------
+    // Returns the backend supported by the CPU
+    static SliderAttacksBackend cpuBackend()
+    {
+#if defined(CSZD_PEXT_SUPPORTED)
+        unsigned int eax, ebx, ecx, edx;
+        // Vendor and family: on AMD CPUs before Zen 3 (family 19h) PEXT is
+        // microcoded and much slower than a magic multiplication
+        if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx))
+            return MagicBackend;
+        bool amd = (ebx == 0x68747541);    // "Auth"enticAMD
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return MagicBackend;
+        unsigned int family = ((eax >> 8) & 0x0F) + ((eax >> 20) & 0xFF);
+        if (amd && (family < 0x19))
+            return MagicBackend;
+        // Structured extended features: BMI2 is bit 8 of EBX
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return MagicBackend;
+        return ((ebx & (1U << 8)) != 0) ? PextBackend : MagicBackend;
+#else
+        return MagicBackend;
+#endif
+    }
+
+    // Returns the backend to use: the one of the CPU, unless the magic
+    // bitboards are forced by the environment
+    static SliderAttacksBackend selectedBackend()
+    {
+        const char *forced = std::getenv("CSZD_SLIDER_ATTACKS");
+        if ((forced != nullptr) && (std::strcmp(forced, "magic") == 0))
+            return MagicBackend;
+        return cpuBackend();
+    }
+
+    // -------------------------------------------------------------------------
+    // Magic entry of a cell: relevant occupancy mask, magic number, shift
+    // and pointer to the first entry of the attacks of the cell
+    struct SliderMagic
+    {
+        BitBoardState mask;
+        BitBoardState magic;
+        unsigned int shift;
+        const BitBoardState *attacks;
+    };
+
+    // Both the backends map the relevant occupancies of the cell to the
+    // range [0, 2^popCount(mask)), but with different orders, so the
+    // tables are filled using the selected backend
+    static inline unsigned int magicIndex(const SliderMagic &m, BitBoardState occupancy)
+    {
+        return static_cast<unsigned int>(((occupancy & m.mask) * m.magic) >> m.shift);
+    }
+
+    static BitBoardState magicAttacks(const SliderMagic &m, BitBoardState occupancy)
+    {
+        return m.attacks[magicIndex(m, occupancy)];
+    }
+
+#if defined(CSZD_PEXT_SUPPORTED)
+    // Only these functions are compiled for BMI2: they are called only if
+    // the CPU supports it, so no BMI2 instruction can leak in the other code
+    __attribute__((target("bmi2")))
+    static unsigned int pextIndex(const SliderMagic &m, BitBoardState occupancy)
+    {
+        return static_cast<unsigned int>(_pext_u64(occupancy, m.mask));
+    }
+
+    __attribute__((target("bmi2")))
+    static BitBoardState pextAttacks(const SliderMagic &m, BitBoardState occupancy)
+    {
+        return m.attacks[_pext_u64(occupancy, m.mask)];
+    }
+#endif
+
+    // -------------------------------------------------------------------------
+    struct SliderAttacksTables
+    {
+        SliderMagic bishop[64];
+        SliderMagic rook[64];
+        std::vector<BitBoardState> attacks;
+        SliderAttacksBackend backend = MagicBackend;
+        // Lookup of the selected backend, bound when the tables are built
+        BitBoardState (*lookup)(const SliderMagic &m, BitBoardState occupancy) = magicAttacks;
+        BitBoardState between[64][64] = {};
+
+        explicit SliderAttacksTables(SliderAttacksBackend b)
+            : backend(b)
+        {
+#if defined(CSZD_PEXT_SUPPORTED)
+            if (backend == PextBackend)
+                lookup = pextAttacks;
+#endif
+            // 5248 entries are used by bishops, 102400 by rooks
+            attacks.resize(5248 + 102400);
+            BitBoardState *next = attacks.data();
+            next = fill(bishop, BishopMagics, BishopDirections, next);
+            fill(rook, RookMagics, RookDirections, next);
+            fillBetween(BishopDirections);
+            fillBetween(RookDirections);
+        }
+
+        unsigned int index(const SliderMagic &m, BitBoardState occupancy) const
+        {
+#if defined(CSZD_PEXT_SUPPORTED)
+            if (backend == PextBackend)
+                return pextIndex(m, occupancy);
+#endif
+            return magicIndex(m, occupancy);
+        }
+
+        BitBoardState *fill(SliderMagic (&magics)[64], const BitBoardState (&magicNumbers)[64],
+                            const int (&directions)[4][2], BitBoardState *next)
+        {
+            for (auto ndx = 0; ndx < 64; ndx++) {
+                Cell c = static_cast<Cell>(ndx);
+                SliderMagic &m = magics[c];
+                m.mask = slidingAttacks(c, EmptyBB, directions, true);
+                m.magic = magicNumbers[c];
+                m.shift = 64 - popCount(m.mask);
+                m.attacks = next;
+                // Enumerates all the subsets of the mask (Carry-Rippler trick)
+                // and stores the corresponding attacks in the table. The
+                // attacks are never empty, so an entry already filled with
+                // different attacks is a destructive collision of the index
+                BitBoardState occupancy = EmptyBB;
+                do {
+                    BitBoardState attacks = slidingAttacks(c, occupancy, directions, false);
+                    BitBoardState &entry = next[index(m, occupancy)];
+                    assert((entry == EmptyBB) || (entry == attacks));
+                    entry = attacks;
+                    occupancy = (occupancy - m.mask) & m.mask;
+                } while (occupancy != EmptyBB);
+                next += (1ULL << popCount(m.mask));
+            }
+            return next;
+        }
+
+        // Compares the lookups of the tables with the slow computation of
+        // the attacks, for every subset of the relevant occupancy of every
+        // cell (and with all the other cells busy, that shall be ignored)
+        bool verify(const SliderMagic (&magics)[64], const int (&directions)[4][2]) const
+        {
+            for (auto ndx = 0; ndx < 64; ndx++) {
+                Cell c = static_cast<Cell>(ndx);
+                const SliderMagic &m = magics[c];
+                BitBoardState occupancy = EmptyBB;
+                do {
+                    BitBoardState attacks = slidingAttacks(c, occupancy, directions, false);
+                    if ((lookup(m, occupancy) != attacks) || (lookup(m, occupancy | ~m.mask) != attacks))
+                        return false;
+                    occupancy = (occupancy - m.mask) & m.mask;
+                } while (occupancy != EmptyBB);
+            }
+            return true;
+        }
+
+        // Walks the rays from each cell: the cells between the starting
+        // cell and each cell of a ray are the ones already walked
+        void fillBetween(const int (&directions)[4][2])
+        {
+            for (auto ndx = 0; ndx < 64; ndx++) {
+                for (auto &d : directions) {
+                    BitBoardState walked = EmptyBB;
+                    int r = ndx / 8 + d[0];
+                    int f = ndx % 8 + d[1];
+                    while ((r >= 0) && (r < 8) && (f >= 0) && (f < 8)) {
+                        between[ndx][r * 8 + f] = walked;
+                        walked |= 1ULL << (r * 8 + f);
+                        r += d[0];
+                        f += d[1];
+                    }
+                }
+            }
+        }
+    };
+
+    // The tables are built (and the backend is selected) at the first call:
+    // the initialization of a function local static object is thread safe
+    // since C++11, and the tables are ready also for the lookups made by
+    // the static initializers of other translation units
+    static const SliderAttacksTables &sliderAttacksTables()
+    {
+        static const SliderAttacksTables tables(selectedBackend());
+        return tables;
+    }
+
+    // -------------------------------------------------------------------------
+    BitBoardState bishopAttacks(Cell c, BitBoardState occupancy)
+    {
+        const SliderAttacksTables &t = sliderAttacksTables();
+        return t.lookup(t.bishop[c], occupancy);
+    }
+
+    BitBoardState rookAttacks(Cell c, BitBoardState occupancy)
+    {
+        const SliderAttacksTables &t = sliderAttacksTables();
+        return t.lookup(t.rook[c], occupancy);
+    }
+
+    BitBoardState queenAttacks(Cell c, BitBoardState occupancy)
+    {
+        return bishopAttacks(c, occupancy) | rookAttacks(c, occupancy);
+    }
+
+    BitBoardState cellsBetween(Cell a, Cell b)
+    {
+        return sliderAttacksTables().between[a][b];
+    }
+
+    SliderAttacksBackend sliderAttacksBackend()
+    {
+        return sliderAttacksTables().backend;
+    }
+
+    SliderAttacksBackend cpuSliderAttacksBackend()
+    {
+        return cpuBackend();
+    }
+
+    bool verifySliderAttacksTables(SliderAttacksBackend backend)
+    {
+        // The PEXT instruction can be executed only by the CPUs supporting it
+        if ((backend == PextBackend) && (cpuBackend() != PextBackend))
+            return false;
+        auto t = std::make_unique<SliderAttacksTables>(backend);
+        return t->verify(t->bishop, BishopDirections) && t->verify(t->rook, RookDirections);
+    }
+
+} // namespace cSzd
@@ -0,0 +1,121 @@
+#include "cmdsuzdal/threadpool.h"
+
+namespace cSzd
+{
+    // The pool and the index of the worker running on the current thread
+    // (nullptr if the thread is not a worker): used to submit the subtasks
+    // of a task in the queue of the worker that executes it
+    static thread_local const ThreadPool *currentPool = nullptr;
+    static thread_local unsigned int currentWorker = 0;
+
+    // -----------------------------------------------------------------
+    ThreadPool::ThreadPool(unsigned int numThreads)
+    {
+        if (numThreads == 0)
+            numThreads = 1;
+        for (auto i = 0U; i < numThreads; i++)
+            queues.push_back(std::make_unique<WorkQueue>());
+        for (auto i = 0U; i < numThreads; i++)
+            workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (auto &w : workers)
+            w.join();
+    }
+
+    // -----------------------------------------------------------------
+    void ThreadPool::submit(std::function<void()> task)
+    {
+        unsigned int ndx = (currentPool == this) ? currentWorker :
+                           (nextQueue++ % queues.size());
+        ++pendingTasks;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            ++queuedTasks;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues[ndx]->mtx);
+            queues[ndx]->tasks.push_back(std::move(task));
+        }
+        workAvailable.notify_one();
+    }
+
+    void ThreadPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        allDone.wait(lock, [this] { return pendingTasks == 0; });
+        if (firstException) {
+            std::exception_ptr e = firstException;
+            firstException = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+    // -----------------------------------------------------------------
+    // Private methods
+
+    // -----------------------------------------------------------------
+    bool ThreadPool::popTask(unsigned int ndx, std::function<void()> &task)
+    {
+        // Newest task of the own queue first...
+        {
+            std::lock_guard<std::mutex> lock(queues[ndx]->mtx);
+            if (!queues[ndx]->tasks.empty()) {
+                task = std::move(queues[ndx]->tasks.back());
+                queues[ndx]->tasks.pop_back();
+                --queuedTasks;
+                return true;
+            }
+        }
+        // ...otherwise steal the oldest task of another queue
+        for (auto i = 1U; i < queues.size(); i++) {
+            WorkQueue &q = *queues[(ndx + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.mtx);
+            if (!q.tasks.empty()) {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+                --queuedTasks;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::workerLoop(unsigned int ndx)
+    {
+        currentPool = this;
+        currentWorker = ndx;
+        std::function<void()> task;
+        while (true) {
+            if (popTask(ndx, task)) {
+                try {
+                    task();
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if (!firstException)
+                        firstException = std::current_exception();
+                }
+                task = nullptr;
+                if (--pendingTasks == 0) {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    allDone.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mtx);
+            workAvailable.wait(lock, [this] { return stopping || (queuedTasks > 0); });
+            // The queued tasks are completed before stopping
+            if (stopping && (queuedTasks == 0))
+                return;
+        }
+    }
+
+} // namespace cSzd
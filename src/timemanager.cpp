@@ -0,0 +1,44 @@
+#include <algorithm>
+
+#include "cmdsuzdal/timemanager.h"
+
+namespace cSzd
+{
+
+    // -----------------------------------------------------------------
+    void TimeManager::start(const SearchLimits &limits, ArmyColor sideToMove)
+    {
+        using std::chrono::milliseconds;
+
+        startTime = std::chrono::steady_clock::now();
+        timeLimited = false;
+        optimum = maximum = milliseconds(0);
+
+        if (limits.moveTime.count() != 0) {
+            timeLimited = true;
+            optimum = maximum = std::max(limits.moveTime - MoveOverhead, milliseconds(1));
+            return;
+        }
+        if ((sideToMove > BlackArmy) || (limits.time[sideToMove].count() == 0))
+            return;
+
+        timeLimited = true;
+        milliseconds remaining = std::max(limits.time[sideToMove] - MoveOverhead, milliseconds(1));
+        milliseconds increment = limits.increment[sideToMove];
+        unsigned int movesToGo = (limits.movesToGo == 0) ? DefaultMovesToGo
+                                                         : std::min(limits.movesToGo, DefaultMovesToGo);
+
+        optimum = std::min(remaining / movesToGo + increment * 3 / 4, remaining);
+        if (movesToGo == 1)
+            maximum = remaining;
+        else
+            maximum = std::max(optimum, std::min(optimum * 5, remaining * 4 / 5));
+    }
+
+    std::chrono::milliseconds TimeManager::elapsed() const
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - startTime);
+    }
+
+} // namespace cSzd
@@ -0,0 +1,136 @@
+#include <algorithm>
+
+#include "cmdsuzdal/transpositiontable.h"
+
+namespace cSzd
+{
+    // The data of an entry are packed in 64 bits:
+    //   - bits  0-31: the move
+    //   - bits 32-47: the score (16 bits signed)
+    //   - bits 48-55: the depth
+    //   - bits 56-57: the bound
+    //   - bits 58-63: the age
+    static std::uint64_t packData(ChessMove move, int score, unsigned int depth,
+                                  TTBound bound, unsigned int age)
+    {
+        score = std::clamp(score, -32768, 32767);
+        return (move.to_ullong() & 0xFFFFFFFFULL) |
+               (static_cast<std::uint64_t>(static_cast<std::uint16_t>(score)) << 32) |
+               (static_cast<std::uint64_t>(std::min(depth, 255U)) << 48) |
+               (static_cast<std::uint64_t>(bound & 0x3) << 56) |
+               (static_cast<std::uint64_t>(age) << 58);
+    }
+
+    static TTData unpackData(std::uint64_t data)
+    {
+        TTData d;
+        d.move = ChessMove(data & 0xFFFFFFFFULL);
+        d.score = static_cast<std::int16_t>((data >> 32) & 0xFFFF);
+        d.depth = (data >> 48) & 0xFF;
+        d.bound = static_cast<TTBound>((data >> 56) & 0x3);
+        d.age = (data >> 58) & 0x3F;
+        return d;
+    }
+
+    // -----------------------------------------------------------------
+    TranspositionTable::TranspositionTable(std::size_t sizeMB)
+    {
+        resize(sizeMB);
+    }
+
+    void TranspositionTable::resize(std::size_t sizeMB)
+    {
+        // The number of buckets is the largest power of two fitting
+        // in the specified size (at least one bucket is allocated)
+        std::size_t n = (sizeMB << 20) / sizeof(Bucket);
+        std::size_t numBuckets = 1;
+        while ((numBuckets << 1) <= n)
+            numBuckets <<= 1;
+        buckets.reset();
+        buckets = std::make_unique<Bucket[]>(numBuckets);
+        mask = numBuckets - 1;
+        sizeInMB = sizeMB;
+        age = 0;
+    }
+
+    void TranspositionTable::clear()
+    {
+        for (auto i = 0U; i <= mask; i++) {
+            for (auto &e : buckets[i].entries) {
+                e.keyXorData.store(0, std::memory_order_relaxed);
+                e.data.store(0, std::memory_order_relaxed);
+            }
+        }
+        age = 0;
+    }
+
+    void TranspositionTable::newSearch()
+    {
+        age = (age + 1) & AgeMask;
+    }
+
+    // -----------------------------------------------------------------
+    bool TranspositionTable::probe(std::uint64_t key, TTData &data) const
+    {
+        for (auto &e : buckets[key & mask].entries) {
+            std::uint64_t d = e.data.load(std::memory_order_relaxed);
+            std::uint64_t keyXorData = e.keyXorData.load(std::memory_order_relaxed);
+            if ((keyXorData ^ d) == key) {
+                data = unpackData(d);
+                return data.bound != NoBound;
+            }
+        }
+        return false;
+    }
+
+    // -----------------------------------------------------------------
+    // The entry of the same position is updated (keeping its move if no
+    // move is specified), unless it contains the result of a deeper search
+    // of the current one. Otherwise the entry replaced is the one with the
+    // lowest depth, considering the entries of older searches less deep
+    void TranspositionTable::store(std::uint64_t key, ChessMove move, int score,
+                                   unsigned int depth, TTBound bound)
+    {
+        Entry *replaced = nullptr;
+        int replacedWorth = 0;
+        for (auto &e : buckets[key & mask].entries) {
+            std::uint64_t d = e.data.load(std::memory_order_relaxed);
+            std::uint64_t keyXorData = e.keyXorData.load(std::memory_order_relaxed);
+            TTData old = unpackData(d);
+            if ((keyXorData ^ d) == key) {
+                if ((bound != ExactBound) && (old.age == age) && (depth + 2 < old.depth))
+                    return;
+                if (move == InvalidMove)
+                    move = old.move;
+                replaced = &e;
+                break;
+            }
+            int worth = (old.bound == NoBound)
+                            ? -1000
+                            : static_cast<int>(old.depth) - 8 * static_cast<int>((age - old.age) & AgeMask);
+            if ((replaced == nullptr) || (worth < replacedWorth)) {
+                replaced = &e;
+                replacedWorth = worth;
+            }
+        }
+        std::uint64_t data = packData(move, score, depth, bound, age);
+        replaced->keyXorData.store(key ^ data, std::memory_order_relaxed);
+        replaced->data.store(data, std::memory_order_relaxed);
+    }
+
+    // -----------------------------------------------------------------
+    unsigned int TranspositionTable::hashfull() const
+    {
+        std::size_t numSampled = std::min<std::size_t>(mask + 1, 250);
+        unsigned int used = 0;
+        for (auto i = 0U; i < numSampled; i++) {
+            for (auto &e : buckets[i].entries) {
+                TTData d = unpackData(e.data.load(std::memory_order_relaxed));
+                if ((d.bound != NoBound) && (d.age == age))
+                    used++;
+            }
+        }
+        return static_cast<unsigned int>((used * 1000) / (numSampled * BucketSize));
+    }
+
+} // namespace cSzd
@@ -0,0 +1,26 @@
+#include "cmdsuzdal/zobrist.h"
+#include "cmdsuzdal/chessboard.h"
+
+namespace cSzd
+{
+
+    // -----------------------------------------------------------------
+    std::uint64_t zobristKey(const ChessBoard &cb)
+    {
+        std::uint64_t key = 0;
+        for (auto a = 0; a < 2; a++) {
+            for (auto p = 0U; p < NumPieceTypes; p++) {
+                for (Cell c : cb.armies[a].pieces[p])
+                    key ^= Zobrist.pieces[a][p][c];
+            }
+        }
+        if (cb.sideToMove == BlackArmy)
+            key ^= Zobrist.blackToMove;
+
+        key ^= castlingKey(cb.castlingAvailability.state());
+        key ^= enPassantKey(cb.enPassantTargetSquare.state());
+
+        return key;
+    }
+
+} // namespace cSzd
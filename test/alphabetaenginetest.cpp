@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/alphabetaengine.h"
+
+using namespace std;
+using namespace testing;
+
+namespace cSzd
+{
+    class AnAlphaBetaEngine: public Test {
+        public:
+            AlphaBetaEngine abEng {1};
+            static int whitePawnInE4Evaluator(const ChessBoard &cb)
+            {
+                int score = cb.armies[WhiteArmy].pieces[Pawn].isActive(e4) ? 1000 : 0;
+                return (cb.sideToMove == WhiteArmy) ? score : -score;
+            }
+            static bool isLegal(const ChessBoard &cb, const ChessMove &m)
+            {
+                MoveList moves;
+                cb.generateLegalMoves(moves);
+                return std::find(moves.begin(), moves.end(), m) != moves.end();
+            }
+        };
+
+    TEST_F(AnAlphaBetaEngine, GenerateInvalidMoveInStaleMateAndCheckMatePositions)
+    {
+        ASSERT_EQ(abEng.move(ChessBoard("8/8/8/3k4/8/8/5q2/7K w - - 0 1")), InvalidMove);
+        ASSERT_EQ(abEng.move(ChessBoard("R2k4/8/3K4/8/8/8/8/8 b - - 0 1")), InvalidMove);
+        ASSERT_EQ(abEng.move(ChessBoard(FENEmptyChessBoard)), InvalidMove);
+    }
+
+    TEST_F(AnAlphaBetaEngine, FindsTheMateInOne)
+    {
+        abEng.setLimits(SearchLimits{4, 0, std::chrono::milliseconds(0)});
+        ASSERT_EQ(abEng.move(ChessBoard("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1")), chessMove(Rook, a1, a8));
+        ASSERT_EQ(abEng.lastSearchInfo().score, MateScore - 1);
+        ASSERT_TRUE(isMateScore(abEng.lastSearchInfo().score));
+    }
+
+    TEST_F(AnAlphaBetaEngine, FindsTheMateInTwo)
+    {
+        // e.g. 1. Kf7 Kh7 2. Rh1#
+        abEng.setLimits(SearchLimits{5, 0, std::chrono::milliseconds(0)});
+        ChessMove m = abEng.move(ChessBoard("7k/8/5K2/8/8/8/8/R7 w - - 0 1"));
+        ASSERT_EQ(abEng.lastSearchInfo().score, MateScore - 3);
+        ASSERT_EQ(abEng.lastSearchInfo().pv.size(), 3);
+        ASSERT_EQ(abEng.lastSearchInfo().pv[0], m);
+    }
+
+    TEST_F(AnAlphaBetaEngine, CapturesTheUndefendedQueen)
+    {
+        abEng.setLimits(SearchLimits{3, 0, std::chrono::milliseconds(0)});
+        ASSERT_EQ(abEng.move(ChessBoard("4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1")), chessMove(Rook, d1, d5, Queen));
+    }
+
+    TEST_F(AnAlphaBetaEngine, DoesNotCaptureADefendedPawnWithTheQueen)
+    {
+        // Qxd5 is answered by cxd5 (found by the quiescence search)
+        abEng.setLimits(SearchLimits{1, 0, std::chrono::milliseconds(0)});
+        ChessMove m = abEng.move(ChessBoard("4k3/8/2p5/3p4/8/8/8/3QK3 w - - 0 1"));
+        ASSERT_NE(m, chessMove(Queen, d1, d5, Pawn));
+    }
+
+    TEST_F(AnAlphaBetaEngine, UsesThePluggableEvaluationFunction)
+    {
+        abEng.setEvaluator(whitePawnInE4Evaluator);
+        abEng.setLimits(SearchLimits{1, 0, std::chrono::milliseconds(0)});
+        ASSERT_EQ(abEng.move(ChessBoard()), chessMove(Pawn, e2, e4));
+        ASSERT_EQ(abEng.lastSearchInfo().score, 1000);
+    }
+
+    TEST_F(AnAlphaBetaEngine, ReportsTheInformationAfterEachIteration)
+    {
+        std::vector<SearchInfo> infos;
+        abEng.setInfoCallback([&infos](const SearchInfo &i) { infos.push_back(i); });
+        abEng.setLimits(SearchLimits{4, 0, std::chrono::milliseconds(0)});
+        ChessMove m = abEng.move(ChessBoard());
+        ASSERT_EQ(infos.size(), 4);
+        for (auto d = 0U; d < infos.size(); d++) {
+            ASSERT_EQ(infos[d].depth, d + 1);
+            ASSERT_GT(infos[d].nodes, 0);
+            ASSERT_FALSE(infos[d].pv.empty());
+            if (d > 0)
+                ASSERT_GT(infos[d].nodes, infos[d - 1].nodes);
+        }
+        ASSERT_EQ(infos.back().pv[0], m);
+        ASSERT_EQ(abEng.lastSearchInfo().depth, 4);
+    }
+
+    TEST_F(AnAlphaBetaEngine, StopsWhenTheNodesLimitIsReached)
+    {
+        ChessBoard cb {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+        abEng.setLimits(SearchLimits{0, 5000, std::chrono::milliseconds(0)});
+        ChessMove m = abEng.move(cb);
+        ASSERT_TRUE(isLegal(cb, m));
+        ASSERT_LE(abEng.lastSearchInfo().nodes, 5000);
+        ASSERT_LT(abEng.lastSearchInfo().depth, MaxSearchDepth);
+    }
+
+    TEST_F(AnAlphaBetaEngine, StopsWhenTheTimeLimitIsReached)
+    {
+        ChessBoard cb {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+        abEng.setLimits(SearchLimits{0, 0, std::chrono::milliseconds(100)});
+        auto start = std::chrono::steady_clock::now();
+        ChessMove m = abEng.move(cb);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        ASSERT_TRUE(isLegal(cb, m));
+        ASSERT_LT(elapsed, std::chrono::milliseconds(5000));
+    }
+    TEST_F(AnAlphaBetaEngine, TheNumberOfThreadsCanBeConfigured)
+    {
+        ASSERT_EQ(abEng.threads(), 1);
+        abEng.setThreads(4);
+        ASSERT_EQ(abEng.threads(), 4);
+        abEng.setThreads(0);
+        ASSERT_EQ(abEng.threads(), 1);
+        AlphaBetaEngine eng8 {1, 8};
+        ASSERT_EQ(eng8.threads(), 8);
+    }
+
+    TEST_F(AnAlphaBetaEngine, AMultithreadedSearchFindsTheSameMatesAndCaptures)
+    {
+        abEng.setThreads(4);
+        abEng.setLimits(SearchLimits{5, 0, std::chrono::milliseconds(0)});
+        ASSERT_EQ(abEng.move(ChessBoard("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1")), chessMove(Rook, a1, a8));
+        ASSERT_EQ(abEng.lastSearchInfo().score, MateScore - 1);
+        abEng.move(ChessBoard("7k/8/5K2/8/8/8/8/R7 w - - 0 1"));
+        ASSERT_EQ(abEng.lastSearchInfo().score, MateScore - 3);
+        ASSERT_EQ(abEng.move(ChessBoard("4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1")), chessMove(Rook, d1, d5, Queen));
+    }
+
+    TEST_F(AnAlphaBetaEngine, ReportsTheNodesOfEachThread)
+    {
+        abEng.setThreads(4);
+        abEng.setLimits(SearchLimits{5, 0, std::chrono::milliseconds(0)});
+        ChessBoard cb {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+        ASSERT_TRUE(isLegal(cb, abEng.move(cb)));
+        const SearchInfo &info = abEng.lastSearchInfo();
+        ASSERT_EQ(info.depth, 5);
+        ASSERT_EQ(info.threadNodes.size(), 4);
+        ASSERT_GT(info.threadNodes[0], 0);
+        std::uint64_t sum = 0;
+        for (auto n : info.threadNodes)
+            sum += n;
+        ASSERT_EQ(sum, info.nodes);
+    }
+
+    TEST_F(AnAlphaBetaEngine, AMultithreadedSearchStopsWhenTheTimeLimitIsReached)
+    {
+        ChessBoard cb {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+        abEng.setThreads(4);
+        abEng.setLimits(SearchLimits{0, 0, std::chrono::milliseconds(100)});
+        auto start = std::chrono::steady_clock::now();
+        ChessMove m = abEng.move(cb);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        ASSERT_TRUE(isLegal(cb, m));
+        ASSERT_LT(elapsed, std::chrono::milliseconds(5000));
+    }
+    TEST_F(AnAlphaBetaEngine, StopsWhenTheMateIsFound)
+    {
+        SearchLimits limits;
+        limits.mate = 2;
+        abEng.setLimits(limits);
+        abEng.move(ChessBoard("7k/8/5K2/8/8/8/8/R7 w - - 0 1"));
+        ASSERT_EQ(abEng.lastSearchInfo().score, MateScore - 3);
+        ASSERT_LE(abEng.lastSearchInfo().depth, 3);
+    }
+
+    TEST_F(AnAlphaBetaEngine, AllocatesTheSearchTimeFromTheClock)
+    {
+        ChessBoard cb {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+        SearchLimits limits;
+        limits.time[WhiteArmy] = std::chrono::milliseconds(3000);
+        limits.time[BlackArmy] = std::chrono::milliseconds(3000000);
+        abEng.setLimits(limits);
+        auto start = std::chrono::steady_clock::now();
+        ASSERT_TRUE(isLegal(cb, abEng.move(cb)));
+        // the allocated time is a small fraction of the clock: the search
+        // shall not use the whole clock (the bound leaves room for slow builds)
+        ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(3000));
+    }
+
+    TEST_F(AnAlphaBetaEngine, ASearchStartedInBackgroundCanBeStopped)
+    {
+        ChessBoard cb {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+        abEng.setThreads(2);
+        // the search has no limits: it ends only when it is stopped
+        std::future<ChessMove> result = abEng.startSearch(cb);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        abEng.stop();
+        ASSERT_EQ(result.wait_for(std::chrono::milliseconds(200)), std::future_status::ready);
+        ASSERT_TRUE(isLegal(cb, result.get()));
+    }
+
+    TEST_F(AnAlphaBetaEngine, ASearchStartedInBackgroundEndsWhenTheLimitsAreReached)
+    {
+        abEng.setLimits(SearchLimits{4, 0, std::chrono::milliseconds(0)});
+        std::future<ChessMove> result = abEng.startSearch(ChessBoard("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1"));
+        ASSERT_EQ(result.get(), chessMove(Rook, a1, a8));
+
+        // The engine can be reused, also stopping the search immediately
+        abEng.setLimits(SearchLimits{});
+        result = abEng.startSearch(ChessBoard());
+        abEng.stop();
+        ASSERT_TRUE(isLegal(ChessBoard(), result.get()));
+    }
+
+}   // namespace cSzd
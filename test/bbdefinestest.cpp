@@ -1,6 +1,7 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include "cmdsuzdal/bbdefines.h"
+#include "cmdsuzdal/cellnames.h"
 
 using namespace std;
 using namespace testing;
@@ -457,4 +458,62 @@ namespace cSzd
         ASSERT_EQ(nextRank(r_8), InvalidRank);
         ASSERT_EQ(nextRank(InvalidRank), InvalidRank);
     }
+
+    // --------------------------------------------------------
+    TEST(BBDefinesTester, BitManipulationPrimitivesTesting)
+    {
+        ASSERT_EQ(popCount(EmptyBB), 0);
+        ASSERT_EQ(popCount(AllCellsBB), 64);
+        ASSERT_EQ(popCount(DiagonalBB), 8);
+        ASSERT_EQ(lsb(1ULL), 0);
+        ASSERT_EQ(msb(1ULL), 0);
+        ASSERT_EQ(lsb(AllCellsBB), a1);
+        ASSERT_EQ(msb(AllCellsBB), h8);
+        ASSERT_EQ(lsb(RanksBB[r_5]), a5);
+        ASSERT_EQ(msb(RanksBB[r_5]), h5);
+        ASSERT_EQ(lsb(AntiDiagonalBB), h1);
+        ASSERT_EQ(msb(AntiDiagonalBB), a8);
+
+        BitBoardState bbs = FilesBB[f_c];
+        ASSERT_EQ(popLsb(bbs), c1);
+        ASSERT_EQ(popLsb(bbs), c2);
+        ASSERT_EQ(bbs, FilesBB[f_c] & ~(RanksBB[r_1] | RanksBB[r_2]));
+    }
+
+    // --------------------------------------------------------
+    TEST(BBDefinesTester, KingAttacksTableIsComputedCorrectly)
+    {
+        ASSERT_EQ(KingAttacks[a1], 0x0000000000000302ULL);
+        ASSERT_EQ(KingAttacks[h8], 0x40C0000000000000ULL);
+        ASSERT_EQ(KingAttacks[e5], 0x0000382838000000ULL);
+        for (auto c = 0; c < 64; c++)
+            ASSERT_EQ(KingAttacks[c], neighbour(static_cast<Cell>(c)));
+        ASSERT_EQ(neighbour(InvalidCell), EmptyBB);
+    }
+
+    // --------------------------------------------------------
+    TEST(BBDefinesTester, KnightAttacksTableIsComputedCorrectly)
+    {
+        ASSERT_EQ(KnightAttacks[a1], singlecell(b3) | singlecell(c2));
+        ASSERT_EQ(KnightAttacks[h8], singlecell(g6) | singlecell(f7));
+        ASSERT_EQ(KnightAttacks[d4], singlecell(c2) | singlecell(e2) | singlecell(b3) | singlecell(f3) |
+                                     singlecell(b5) | singlecell(f5) | singlecell(c6) | singlecell(e6));
+        static_assert(KnightAttacks[g1] == ((1ULL << e2) | (1ULL << f3) | (1ULL << h3)),
+                      "Knight attacks table shall be computed at compile time");
+    }
+
+    // --------------------------------------------------------
+    TEST(BBDefinesTester, PawnAttacksTablesAreComputedCorrectly)
+    {
+        // white pawns (index 0) attack towards north...
+        ASSERT_EQ(PawnAttacks[0][e4], singlecell(d5) | singlecell(f5));
+        ASSERT_EQ(PawnAttacks[0][a2], singlecell(b3));
+        ASSERT_EQ(PawnAttacks[0][h7], singlecell(g8));
+        ASSERT_EQ(PawnAttacks[0][c8], EmptyBB);
+        // ...black pawns (index 1) towards south
+        ASSERT_EQ(PawnAttacks[1][e5], singlecell(d4) | singlecell(f4));
+        ASSERT_EQ(PawnAttacks[1][h7], singlecell(g6));
+        ASSERT_EQ(PawnAttacks[1][a2], singlecell(b1));
+        ASSERT_EQ(PawnAttacks[1][f1], EmptyBB);
+    }
 }
\ No newline at end of file
@@ -457,6 +457,69 @@ namespace cSzd
         ASSERT_EQ(bb.popCount(), 64);
     }
 
+    // bit scan tests
+    TEST(BBTester, LsbAndMsbOfAnEmptyBitBoardAreInvalidCells)
+    {
+        BitBoard bb;
+        ASSERT_EQ(bb.lsb(), InvalidCell);
+        ASSERT_EQ(bb.msb(), InvalidCell);
+        ASSERT_EQ(bb.popLsb(), InvalidCell);
+    }
+    TEST(BBTester, LsbAndMsbOfASingleCellBitBoardAreTheActiveCell)
+    {
+        BitBoard bb {d6};
+        ASSERT_EQ(bb.lsb(), d6);
+        ASSERT_EQ(bb.msb(), d6);
+    }
+    TEST(BBTester, LsbAndMsbOfTheBoardCenterAreD4AndE5)
+    {
+        BitBoard bb(BoardCenterBB);
+        ASSERT_EQ(bb.lsb(), d4);
+        ASSERT_EQ(bb.msb(), e5);
+    }
+    TEST(BBTester, PopLsbReturnsTheActiveCellsInAscendingOrderAndEmptiesTheBitBoard)
+    {
+        BitBoard bb({h8, a1, e4, c2});
+        ASSERT_EQ(bb.popLsb(), a1);
+        ASSERT_EQ(bb.popLsb(), c2);
+        ASSERT_EQ(bb.popLsb(), e4);
+        ASSERT_EQ(bb.popLsb(), h8);
+        ASSERT_EQ(bb, BitBoard(EmptyBB));
+    }
+
+    // active cells iteration tests
+    TEST(BBTester, IterationOverAnEmptyBitBoardVisitsNoCells)
+    {
+        BitBoard bb;
+        auto visited = 0;
+        for (Cell c : bb) {
+            (void) c;
+            ++visited;
+        }
+        ASSERT_EQ(visited, 0);
+        ASSERT_TRUE(bb.begin() == bb.end());
+    }
+    TEST(BBTester, IterationVisitsOnlyTheActiveCellsInAscendingOrder)
+    {
+        BitBoard bb({g7, b2, h8, a1, d4});
+        std::vector<Cell> visited;
+        for (Cell c : bb)
+            visited.push_back(c);
+        ASSERT_EQ(visited, std::vector<Cell>({a1, b2, d4, g7, h8}));
+    }
+    TEST(BBTester, IterationOverAFullBoardVisitsAllTheCells)
+    {
+        BitBoard bb(AllCellsBB);
+        BitBoard rebuilt;
+        auto visited = 0;
+        for (Cell c : bb) {
+            rebuilt.setCell(c);
+            ++visited;
+        }
+        ASSERT_EQ(visited, 64);
+        ASSERT_EQ(rebuilt, bb);
+    }
+
     // Check funtions tests
     TEST(BBTester, IfCellE3IsActiveThereAreActiveCellsInRank3AndFileE)
     {
@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include "cmdsuzdal/chessboard.h"
@@ -80,6 +82,71 @@ namespace cSzd
                                                     RanksBB[r_7] | RanksBB[r_8]));
     }
 
+    TEST(ChessBoardTester, LoadingAnInvalidFENDoesNotModifyTheBoard)
+    {
+        ChessBoard cb {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+        ChessBoard cb2 = cb;
+        ASSERT_EQ(cb.loadPosition("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2 w KQkq - 0 1"), FENInvalidRank);
+        ASSERT_EQ(cb, cb2);
+        ASSERT_EQ(cb.loadPosition(FENInitialStandardPosition), FENNoError);
+        ASSERT_EQ(cb, ChessBoard());
+        ASSERT_EQ(ChessBoard(FENRecord(FENInitialStandardPosition)), ChessBoard());
+    }
+
+    TEST(ChessBoardTester, ConstructingFromAnInvalidFENGivesAnEmptyNotValidBoard)
+    {
+        ChessBoard cb {"not a FEN"};
+        ASSERT_FALSE(cb.isValid());
+        ASSERT_EQ(cb.sideToMove, InvalidArmy);
+        ASSERT_EQ(cb.wholeArmyBitBoard(), BitBoard(EmptyBB));
+        ASSERT_EQ(cb, ChessBoard(FENEmptyChessBoard));
+        ASSERT_FALSE(ChessBoard("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2 w KQkq - 0 1").isValid());
+
+        // the same for an invalid FENRecord, whose error is returned
+        ASSERT_EQ(cb.loadPosition(FENRecord("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQxq - 0 1")), FENInvalidCastling);
+        ASSERT_EQ(cb, ChessBoard(FENEmptyChessBoard));
+        ASSERT_EQ(cb.loadPosition(FENRecord(FENInitialStandardPosition)), FENNoError);
+        ASSERT_EQ(cb, ChessBoard());
+    }
+
+    TEST(ChessBoardTester, ToFENWritesTheFENOfThePosition)
+    {
+        for (auto fen : {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                         "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                         "rnbqkr2/ppp1ppbp/3p1n2/8/1PPPPPp1/P1N5/6PP/1RBQKBNR b Kq f3 0 8",
+                         "r1bq1rk1/pp2n1b1/2ppNnpp/3Ppp2/1PP1P3/2N1BB2/P4PPP/R2QR1K1 b - - 1 14",
+                         "8/8/8/8/8/8/8/8 - - - 0 1",
+                         "4k3/8/8/8/8/8/8/4K2R w K - 4294967295 4294967295"}) {
+            ChessBoard cb {fen};
+            char buf[MaxFENLength];
+            ASSERT_EQ(cb.toFEN(buf), std::strlen(fen));
+            ASSERT_STREQ(buf, fen);
+            ASSERT_EQ(cb.toFEN(), fen);
+        }
+        ASSERT_EQ(ChessBoard().toFEN(), FENInitialStandardPosition);
+    }
+
+    TEST(ChessBoardTester, ToFENAndLoadPositionRoundTripAfterTheMoves)
+    {
+        ChessBoard cb {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+        MoveList moves;
+        cb.generateLegalMoves(moves);
+        for (auto &m : moves) {
+            ChessBoard after = cb;
+            after.doMove(m);
+            MoveList replies;
+            after.generateLegalMoves(replies);
+            for (auto &r : replies) {
+                ChessBoard b = after;
+                b.doMove(r);
+                ChessBoard loaded;
+                ASSERT_EQ(loaded.loadPosition(b.toFEN()), FENNoError);
+                ASSERT_EQ(loaded, b) << b.toFEN();
+                ASSERT_EQ(loaded.toFEN(), b.toFEN());
+            }
+        }
+    }
+
     // Assignment Operator
     TEST(ChessBoardTester, CheckAssignmentOperatorOfStandardInitialPosition)
     {
@@ -1101,6 +1168,43 @@ namespace cSzd
         ASSERT_TRUE(std::find(blackMoves.begin(), blackMoves.end(), chessMove(Queen, c7, d8)) != blackMoves.end());
     }
 
+    TEST(ChessBoardTester, CheckLegalMovesOfPinnedPiecesAreOnlyAlongThePinRays)
+    {
+        // https://lichess.org/editor/k3r3/8/8/8/1b5q/8/3BRN2/4K3_w_-_-_0_1
+        ChessBoard cb {"k3r3/8/8/8/1b5q/8/3BRN2/4K3 w - - 0 1"};
+        ASSERT_TRUE(cb.isValid());
+        ASSERT_EQ(cb.armyInCheck(), InvalidArmy);
+
+        std::vector<ChessMove> whiteMoves;
+        cb.generateLegalMoves(whiteMoves, Rook);
+        ASSERT_EQ(whiteMoves.size(), 6);
+        ASSERT_TRUE(std::find(whiteMoves.begin(), whiteMoves.end(), chessMove(Rook, e2, e3)) != whiteMoves.end());
+        ASSERT_TRUE(std::find(whiteMoves.begin(), whiteMoves.end(), chessMove(Rook, e2, e7)) != whiteMoves.end());
+        ASSERT_TRUE(std::find(whiteMoves.begin(), whiteMoves.end(), chessMove(Rook, e2, e8, Rook)) != whiteMoves.end());
+        cb.generateLegalMoves(whiteMoves, Bishop);
+        ASSERT_EQ(whiteMoves.size(), 2);
+        ASSERT_TRUE(std::find(whiteMoves.begin(), whiteMoves.end(), chessMove(Bishop, d2, c3)) != whiteMoves.end());
+        ASSERT_TRUE(std::find(whiteMoves.begin(), whiteMoves.end(), chessMove(Bishop, d2, b4, Bishop)) != whiteMoves.end());
+        cb.generateLegalMoves(whiteMoves, Knight);
+        ASSERT_EQ(whiteMoves.size(), 0);
+    }
+
+    TEST(ChessBoardTester, CheckLegalMovesInDoubleCheckAreOnlyKingMoves)
+    {
+        // https://lichess.org/editor/4r2k/8/8/1Q6/8/3n4/8/4K3_w_-_-_0_1
+        ChessBoard cb {"4r2k/8/8/1Q6/8/3n4/8/4K3 w - - 0 1"};
+        ASSERT_TRUE(cb.isValid());
+        ASSERT_EQ(cb.armyInCheck(), WhiteArmy);
+        ASSERT_FALSE(cb.isCheckMate());
+
+        std::vector<ChessMove> whiteMoves;
+        cb.generateLegalMoves(whiteMoves);
+        ASSERT_EQ(whiteMoves.size(), 3);
+        ASSERT_TRUE(std::find(whiteMoves.begin(), whiteMoves.end(), chessMove(King, e1, d1)) != whiteMoves.end());
+        ASSERT_TRUE(std::find(whiteMoves.begin(), whiteMoves.end(), chessMove(King, e1, d2)) != whiteMoves.end());
+        ASSERT_TRUE(std::find(whiteMoves.begin(), whiteMoves.end(), chessMove(King, e1, f1)) != whiteMoves.end());
+    }
+
     // --- PAWNS ---
     TEST(ChessBoardTester, CheckLegalMovesOfPawnsFromLineDifferentFromStartNoCapturesAndNoCheckConsiderations)
     {
@@ -2222,6 +2326,110 @@ namespace cSzd
         cb.doMove(chessMove(Pawn, c4, b3, Pawn));
         ASSERT_EQ(cb, ChessBoard("rnbqkbnr/pp1ppppp/8/8/8/1p3NP1/P1PPPP1P/RNBQKB1R w KQkq - 0 4"));
     }
+    TEST(ChessBoardTester, CheckEnPassantCaptureIsNotLegalIfItDiscoversACheckOnTheRank)
+    {
+        // Capturing en passant would remove both the pawns from the 5th rank,
+        // exposing the white king to the black rook
+        ChessBoard cb{"4k3/8/8/K2pP2r/8/8/8/8 w - d6 0 2"};
+        std::vector<ChessMove> moves;
+        cb.generateLegalMoves(moves, Pawn);
+        ASSERT_EQ(moves.size(), 1);
+        ASSERT_EQ(moves[0], chessMove(Pawn, e5, e6));
+    }
+    TEST(ChessBoardTester, CheckEnPassantCaptureIsNotLegalIfItDiscoversACheckOnTheRank_Black)
+    {
+        // exd3 would expose the black king to the white rook on the 4th rank
+        ChessBoard cb{"8/8/8/8/R2Pp2k/8/8/4K3 b - d3 0 1"};
+        std::vector<ChessMove> moves;
+        cb.generateLegalMoves(moves, Pawn);
+        ASSERT_EQ(moves.size(), 1);
+        ASSERT_EQ(moves[0], chessMove(Pawn, e4, e3));
+    }
+    TEST(ChessBoardTester, CheckEnPassantCaptureIsLegalIfTheRankIsStillBlocked)
+    {
+        // the white knight still covers the black king after exd3
+        ChessBoard cb{"8/8/8/8/RN1Pp2k/8/8/4K3 b - d3 0 1"};
+        std::vector<ChessMove> moves;
+        cb.generateLegalMoves(moves, Pawn);
+        ASSERT_EQ(moves.size(), 2);
+        ASSERT_TRUE(std::find(moves.begin(), moves.end(), chessMove(Pawn, e4, d3, Pawn)) != moves.end());
+    }
+
+    // -----------------------------------------------------------------------------
+    // doMove(): promotions
+    // -----------------------------------------------------------------------------
+    TEST(ChessBoardTester, CheckPromotionMove_WhiteQueen)
+    {
+        ChessBoard cb{"4k3/1P6/8/8/8/8/8/4K3 w - - 0 1"};
+        cb.doMove(chessMove(Pawn, b7, b8, InvalidPiece, Queen));
+        ASSERT_EQ(cb, ChessBoard("1Q2k3/8/8/8/8/8/8/4K3 b - - 0 1"));
+    }
+    TEST(ChessBoardTester, CheckPromotionMove_BlackKnightWithCapture)
+    {
+        ChessBoard cb{"4k3/8/8/8/8/8/6p1/4K2R b K - 0 1"};
+        cb.doMove(chessMove(Pawn, g2, h1, Rook, Knight));
+        ASSERT_EQ(cb, ChessBoard("4k3/8/8/8/8/8/8/4K2n w - - 0 2"));
+    }
+    TEST(ChessBoardTester, CheckPromotionMove_ThePromotedPieceReplacesThePawn)
+    {
+        for (auto p : {Queen, Rook, Bishop, Knight}) {
+            ChessBoard cb{"4k3/1P6/8/8/8/8/8/4K3 w - - 0 1"};
+            cb.doMove(chessMove(Pawn, b7, b8, InvalidPiece, p));
+            ASSERT_EQ(cb.armies[WhiteArmy].pieces[Pawn], BitBoard(EmptyBB));
+            ASSERT_EQ(cb.armies[WhiteArmy].pieces[p], BitBoard(b8));
+        }
+    }
+
+    // -----------------------------------------------------------------------------
+    // undoMove()
+    // -----------------------------------------------------------------------------
+    TEST(ChessBoardTester, UndoMoveRestoresThePositionBeforeTheMove)
+    {
+        const std::vector<std::pair<std::string, ChessMove>> cases {
+            {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", chessMove(Pawn, e2, e4)},
+            {"r1bqkbnr/ppp2ppp/2n1p3/3pP3/8/5N2/PPPP1PPP/RNBQKB1R w KQkq d6 0 4", chessMove(Pawn, e5, d6, Pawn)},
+            {"rnbqkbnr/pp1ppppp/8/8/1Pp5/5NP1/P1PPPP1P/RNBQKB1R b KQkq b3 0 3", chessMove(Pawn, c4, b3, Pawn)},
+            {"r3kbnr/pppq1ppp/2npb3/4p3/4P3/2NPB3/PPPQ1PPP/R3KBNR w KQkq - 4 6", chessMove(King, e1, c1)},
+            {"r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 4 6", chessMove(King, e8, g8)},
+            {"r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 4 6", chessMove(Rook, a1, a8, Rook)},
+            {"4k3/8/8/8/8/8/6p1/4K2R b K - 3 1", chessMove(Pawn, g2, h1, Rook, Knight)},
+            {"4k3/1P6/8/8/8/8/8/4K3 w - - 0 1", chessMove(Pawn, b7, b8, InvalidPiece, Queen)},
+        };
+        for (auto &c : cases) {
+            ChessBoard cb {c.first};
+            UndoInfo undo = cb.doMove(c.second);
+            ASSERT_NE(cb, ChessBoard(c.first));
+            cb.undoMove(c.second, undo);
+            ASSERT_EQ(cb, ChessBoard(c.first));
+        }
+    }
+
+    // Executes and undoes all the moves of the tree of the given depth
+    static void checkDoUndoOfTheMovesTree(ChessBoard &cb, unsigned int depth)
+    {
+        if (depth == 0)
+            return;
+        std::vector<ChessMove> moves;
+        cb.generateLegalMoves(moves);
+        for (auto &m : moves) {
+            ChessBoard before = cb;
+            UndoInfo undo = cb.doMove(m);
+            checkDoUndoOfTheMovesTree(cb, depth - 1);
+            cb.undoMove(m, undo);
+            ASSERT_EQ(cb, before);
+        }
+    }
+
+    TEST(ChessBoardTester, UndoMoveRestoresAllThePositionsOfTheMovesTree)
+    {
+        for (auto fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                         "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                         "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"}) {
+            ChessBoard cb {fen};
+            checkDoUndoOfTheMovesTree(cb, 3);
+            ASSERT_EQ(cb, ChessBoard(fen));
+        }
+    }
 
     // -----------------------------------------------------------------------------
     // generateLegalMoves(): check for castling moves
@@ -2648,6 +2856,215 @@ namespace cSzd
         ASSERT_TRUE(std::find(blackMoves.begin(), blackMoves.end(), chessMove(King, e8, e7)) != blackMoves.end());
         ASSERT_TRUE(std::find(blackMoves.begin(), blackMoves.end(), chessMove(King, e8, d8)) != blackMoves.end());
     }
+    TEST(ChessBoardTester, White000IsPossibleWhenB1IsControlledByTheEnemy)
+    {
+        // the king does not pass on b1, so the black rook does not inhibit 0-0-0
+        ChessBoard cb {"1r2k3/8/8/8/8/8/8/R3K3 w Q - 0 1"};
+        ASSERT_TRUE(cb.isValid());
+        std::vector<ChessMove> whiteMoves;
+        cb.generateLegalMoves(whiteMoves, King);
+        ASSERT_EQ(whiteMoves.size(), 6);
+        ASSERT_TRUE(std::find(whiteMoves.begin(), whiteMoves.end(), chessMove(King, e1, c1)) != whiteMoves.end());
+    }
+    TEST(ChessBoardTester, Black000IsPossibleWhenB8IsControlledByTheEnemy)
+    {
+        ChessBoard cb {"r3k3/8/8/8/8/8/8/1R2K3 b q - 0 1"};
+        ASSERT_TRUE(cb.isValid());
+        std::vector<ChessMove> blackMoves;
+        cb.generateLegalMoves(blackMoves, King);
+        ASSERT_EQ(blackMoves.size(), 6);
+        ASSERT_TRUE(std::find(blackMoves.begin(), blackMoves.end(), chessMove(King, e8, c8)) != blackMoves.end());
+    }
+    TEST(ChessBoardTester, CastlingIsNotInhibitedByACheckToTheOtherKing)
+    {
+        // Only the king of the side to move is checked: the black king in
+        // check makes the position not valid, but the generator shall still
+        // consider the white king (not in check) for the castling moves
+        ChessBoard cb {"4k3/8/8/8/4R3/8/8/R3K2R w KQ - 0 1"};
+        ASSERT_EQ(cb.armyInCheck(), BlackArmy);
+        std::vector<ChessMove> whiteMoves;
+        cb.generateLegalMoves(whiteMoves, King);
+        ASSERT_EQ(whiteMoves.size(), 7);
+        ASSERT_TRUE(std::find(whiteMoves.begin(), whiteMoves.end(), chessMove(King, e1, g1)) != whiteMoves.end());
+        ASSERT_TRUE(std::find(whiteMoves.begin(), whiteMoves.end(), chessMove(King, e1, c1)) != whiteMoves.end());
+    }
+
+    // Tests for the attackers and the static exchange evaluation
+    TEST(ChessBoardTester, AttackersToReturnsThePiecesOfBothArmiesAttackingACell)
+    {
+        ChessBoard cb {"4k3/2n5/8/3p4/4P3/2N5/8/3RK3 w - - 0 1"};
+        BitBoardState occupancy = cb.wholeArmyBitBoard().state();
+        ASSERT_EQ(cb.attackersTo(d5, occupancy), BitBoard({c7, e4, c3, d1}).state());
+        ASSERT_EQ(cb.attackersTo(d5, occupancy & ~BitBoard({c7, d1}).state()), BitBoard({e4, c3}).state());
+        ASSERT_EQ(cb.attackersTo(d4, occupancy), BitBoard({d1}).state());
+        ASSERT_EQ(cb.attackersTo(d6, occupancy), EmptyBB);
+        ASSERT_EQ(cb.attackersTo(d6, occupancy & ~BitBoard(d5).state()), BitBoard({d1}).state());
+    }
+
+    TEST(ChessBoardTester, IsAttackedChecksTheAttacksOfEachPieceType)
+    {
+        ChessBoard cb {"4k3/2n5/8/3p4/4P3/2N5/8/3RK3 w - - 0 1"};
+        ASSERT_TRUE(cb.isAttacked(d5, WhiteArmy));      // pawn, knight and rook
+        ASSERT_TRUE(cb.isAttacked(d5, BlackArmy));      // knight
+        ASSERT_TRUE(cb.isAttacked(f5, WhiteArmy));      // pawn
+        ASSERT_FALSE(cb.isAttacked(e5, WhiteArmy));     // pawns do not attack forward
+        ASSERT_TRUE(cb.isAttacked(e4, BlackArmy));      // black pawn
+        ASSERT_TRUE(cb.isAttacked(d4, WhiteArmy));      // rook
+        ASSERT_FALSE(cb.isAttacked(d6, WhiteArmy));     // the rook is blocked by the pawn
+        ASSERT_TRUE(cb.isAttacked(f7, BlackArmy));      // king
+        ASSERT_TRUE(cb.isAttacked(f2, WhiteArmy));      // king
+        ASSERT_FALSE(cb.isAttacked(h5, WhiteArmy));
+        ASSERT_FALSE(cb.isAttacked(a1, BlackArmy));
+        ASSERT_FALSE(cb.isAttacked(a1, InvalidArmy));
+    }
+
+    TEST(ChessBoardTester, IsAttackedIsConsistentWithTheControlledCells)
+    {
+        for (auto fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                         "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                         "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"}) {
+            ChessBoard cb {fen};
+            for (auto a : {WhiteArmy, BlackArmy}) {
+                BitBoard controlled = cb.controlledCells(a);
+                for (auto c = 0; c < 64; c++)
+                    ASSERT_EQ(cb.isAttacked(static_cast<Cell>(c), a), controlled.isActive(static_cast<Cell>(c)));
+            }
+        }
+    }
+
+    TEST(ChessBoardTester, StaticExchangeEvaluationOfSimpleCaptures)
+    {
+        ASSERT_EQ(ChessBoard("4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1").see(chessMove(Pawn, e4, d5, Pawn)), 100);
+        ASSERT_EQ(ChessBoard("4k3/8/4p3/3p4/4P3/8/8/4K3 w - - 0 1").see(chessMove(Pawn, e4, d5, Pawn)), 0);
+        ASSERT_EQ(ChessBoard("4k3/8/2p5/3p4/8/8/8/3QK3 w - - 0 1").see(chessMove(Queen, d1, d5, Pawn)), -800);
+        ASSERT_EQ(ChessBoard("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1").see(chessMove(Pawn, e5, d6, Pawn)), 100);
+        ASSERT_EQ(ChessBoard("4k3/8/8/3p4/8/8/8/3QK3 w - - 0 1").see(chessMove(Queen, d1, d2)), 0);
+        ASSERT_EQ(ChessBoard("4k3/8/2p5/8/8/8/8/3QK3 w - - 0 1").see(chessMove(Queen, d1, d5)), -900);
+    }
+
+    TEST(ChessBoardTester, StaticExchangeEvaluationConsidersTheXRayAttackers)
+    {
+        // Rxd5 Rxd5 Qxd5
+        ASSERT_EQ(ChessBoard("3rk3/8/8/3p4/8/8/3R4/3QK3 w - - 0 1").see(chessMove(Rook, d2, d5, Pawn)), 100);
+        // Rxd5 cxd5 Qxd5: the rook is lost for two pawns
+        ASSERT_EQ(ChessBoard("4k3/8/2p5/3p4/8/8/3R4/3QK3 w - - 0 1").see(chessMove(Rook, d2, d5, Pawn)), -300);
+    }
+
+    TEST(ChessBoardTester, StaticExchangeEvaluationWithKingsAndPromotions)
+    {
+        // The king recaptures only if the piece is not defended
+        ASSERT_EQ(ChessBoard("3rk3/8/8/8/8/8/3N4/4K3 b - - 0 1").see(chessMove(Rook, d8, d2, Knight)), -180);
+        ASSERT_EQ(ChessBoard("3qk3/3r4/8/8/8/8/3N4/4K3 b - - 0 1").see(chessMove(Rook, d7, d2, Knight)), 320);
+        ASSERT_EQ(ChessBoard("8/1P2k3/8/8/8/8/8/4K3 w - - 0 1").see(chessMove(Pawn, b7, b8, InvalidPiece, Queen)), 800);
+        ASSERT_EQ(ChessBoard("1r6/P3k3/8/8/8/8/8/4K3 w - - 0 1").see(chessMove(Pawn, a7, b8, Rook, Queen)), 1300);
+        ASSERT_EQ(ChessBoard("8/P3k3/8/8/8/8/8/r3K3 w - - 0 1").see(chessMove(Pawn, a7, a8, InvalidPiece, Queen)), -100);
+        ASSERT_EQ(ChessBoard("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1").see(chessMove(King, e1, g1)), 0);
+    }
+
+    TEST(ChessBoardTester, StaticExchangeEvaluationThresholdIsConsistentWithTheFullEvaluation)
+    {
+        for (auto fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                         "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                         "rnbqkb1r/pp1p1ppp/2p5/4P3/2B5/8/PPP1NnPP/RNBQK2R w KQkq - 0 6",
+                         "3rk3/3r4/8/3p4/2B5/4N3/3R4/3QK3 w - - 0 1"}) {
+            ChessBoard cb {fen};
+            MoveList moves;
+            cb.generateLegalMoves(moves);
+            for (auto &m : moves) {
+                int s = cb.see(m);
+                for (auto t : {s - 1000, s - 1, s, s + 1, s + 1000, -500, 0, 500})
+                    ASSERT_EQ(cb.seeGE(m, t), s >= t) << cb << m << " threshold " << t;
+            }
+        }
+    }
+
+    // Tests for the generation of the captures and of the quiet moves
+    TEST(ChessBoardTester, CapturesAndQuietMovesArePartitionsOfTheLegalMoves)
+    {
+        for (auto fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                         "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                         "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+                         "r3k2r/ppp2ppp/n2q1n2/2bpp3/B3P1bP/3PBN2/PPP2PP1/RN1QK2R b KQkq - 2 8"}) {
+            ChessBoard cb {fen};
+            MoveList all, captures, quiets;
+            cb.generateLegalMoves(all);
+            cb.generateLegalMoves(captures, CaptureMoves);
+            cb.generateLegalMoves(quiets, QuietMoves);
+            ASSERT_EQ(captures.size() + quiets.size(), all.size());
+            for (auto &m : captures)
+                ASSERT_TRUE(isACaptureOrPromotion(m)) << m;
+            for (auto &m : quiets)
+                ASSERT_FALSE(isACaptureOrPromotion(m)) << m;
+            std::vector<ChessMove> merged(captures.begin(), captures.end());
+            merged.insert(merged.end(), quiets.begin(), quiets.end());
+            ASSERT_THAT(merged, UnorderedElementsAreArray(all.begin(), all.end()));
+        }
+    }
+
+    TEST(ChessBoardTester, CaptureMovesIncludeEnPassantAndAllThePromotions)
+    {
+        ChessBoard cb {"4k3/1P6/8/3pP3/8/8/8/4K3 w - d6 0 1"};
+        MoveList captures;
+        cb.generateLegalMoves(captures, CaptureMoves);
+        std::vector<ChessMove> expected {chessMove(Pawn, e5, d6, Pawn),
+                                         chessMove(Pawn, b7, b8, InvalidPiece, Queen),
+                                         chessMove(Pawn, b7, b8, InvalidPiece, Rook),
+                                         chessMove(Pawn, b7, b8, InvalidPiece, Bishop),
+                                         chessMove(Pawn, b7, b8, InvalidPiece, Knight)};
+        ASSERT_THAT(std::vector<ChessMove>(captures.begin(), captures.end()), UnorderedElementsAreArray(expected));
+        MoveList quiets;
+        cb.generateLegalMoves(quiets, QuietMoves, Pawn);
+        ASSERT_THAT(std::vector<ChessMove>(quiets.begin(), quiets.end()), ElementsAre(chessMove(Pawn, e5, e6)));
+    }
+
+    TEST(ChessBoardTester, IsLegalAcceptsOnlyTheLegalMovesOfThePosition)
+    {
+        ChessBoard cb {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+        MoveList moves;
+        cb.generateLegalMoves(moves);
+        for (auto &m : moves)
+            ASSERT_TRUE(cb.isLegal(m)) << m;
+        ASSERT_FALSE(cb.isLegal(InvalidMove));
+        ASSERT_FALSE(cb.isLegal(chessMove(Queen, f3, f7)));            // blocked
+        ASSERT_FALSE(cb.isLegal(chessMove(Knight, e5, f7)));           // the pawn is not captured
+        ASSERT_FALSE(cb.isLegal(chessMove(Pawn, e4, e5)));             // occupied
+        ASSERT_FALSE(cb.isLegal(chessMove(Bishop, a6, b5)));           // not a white piece
+        ASSERT_TRUE(cb.isLegal(chessMove(King, e1, g1)));
+        ChessBoard pinned {"4k3/4r3/8/8/8/8/4N3/4K3 w - - 0 1"};
+        ASSERT_FALSE(pinned.isLegal(chessMove(Knight, e2, c3)));
+    }
+
+    // Tests for the conversion of the SAN moves
+    TEST(ChessBoardTester, ResolvesTheSANMovesAgainstTheLegalMoves)
+    {
+        ChessBoard cb {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+        MoveList moves;
+        cb.generateLegalMoves(moves);
+        ASSERT_EQ(resolveSANMove(cb, moves, "Bxa6"), chessMove(Bishop, e2, a6, Bishop));
+        ASSERT_EQ(resolveSANMove(cb, moves, "Ba6"), chessMove(Bishop, e2, a6, Bishop));
+        ASSERT_EQ(resolveSANMove(cb, moves, "O-O"), chessMove(King, e1, g1));
+        ASSERT_EQ(resolveSANMove(cb, moves, "0-0-0+"), chessMove(King, e1, c1));
+        ASSERT_EQ(resolveSANMove(cb, moves, "gxh3"), chessMove(Pawn, g2, h3, Pawn));
+        ASSERT_EQ(resolveSANMove(cb, moves, "d6"), chessMove(Pawn, d5, d6));
+        ASSERT_EQ(resolveSANMove(cb, moves, "Rb1"), chessMove(Rook, a1, b1));
+        // Not legal or not SAN
+        for (auto m : {"", "O", "O-O-O-O", "Ke3", "Qxf9", "e2e4x", "Zf3", "x", "+"})
+            ASSERT_EQ(resolveSANMove(cb, moves, m), InvalidMove) << m;
+
+        // Ambiguous without the starting file or rank
+        ChessBoard n {"4k3/8/8/8/8/5N2/8/1N2K3 w - - 0 1"};
+        n.generateLegalMoves(moves);
+        ASSERT_EQ(resolveSANMove(n, moves, "Nd2"), InvalidMove);
+        ASSERT_EQ(resolveSANMove(n, moves, "Nbd2"), chessMove(Knight, b1, d2));
+        ASSERT_EQ(resolveSANMove(n, moves, "N3d2"), chessMove(Knight, f3, d2));
+        ASSERT_EQ(resolveSANMove(n, moves, "Nf3xd2"), chessMove(Knight, f3, d2));
+
+        ChessBoard p {"8/P1k5/K7/8/8/8/8/8 w - - 0 1"};
+        p.generateLegalMoves(moves);
+        ASSERT_EQ(resolveSANMove(p, moves, "a8=N+"), chessMove(Pawn, a7, a8, InvalidPiece, Knight));
+        ASSERT_EQ(resolveSANMove(p, moves, "a8Q"), chessMove(Pawn, a7, a8, InvalidPiece, Queen));
+        ASSERT_EQ(resolveSANMove(p, moves, "a8"), InvalidMove);
+    }
 
     // Test for the << operator
     TEST(ChessBoardTester, CheckIoStreamOperator_EmptyArmy)
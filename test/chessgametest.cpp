@@ -963,6 +963,17 @@ namespace cSzd
         ASSERT_EQ(cg.checkNotationMove("0-0-0"), chessMove(King, e8, c8));
         ASSERT_EQ(cg.checkNotationMove("000"), chessMove(King, e8, c8));
     }
+    TEST_F(AChessGameEngine, HasNotationToMoveMethod_FromAnItalianGame_ConvertCastlingWrittenWithLetterO)
+    {
+        cg.loadPosition("r3k2r/ppp2ppp/3p1q2/n1b1p3/2B1P1b1/2NP1N2/PPPQ1PPP/R3K2R w KQkq - 0 9");
+        // PGN castling notation
+        ASSERT_EQ(cg.checkNotationMove("O-O"), chessMove(King, e1, g1));
+        ASSERT_EQ(cg.checkNotationMove("O-O+"), chessMove(King, e1, g1));
+        ASSERT_EQ(cg.checkNotationMove("O-O-O"), chessMove(King, e1, c1));
+        ASSERT_EQ(cg.checkNotationMove("OOO"), chessMove(King, e1, c1));
+        ASSERT_EQ(cg.checkNotationMove("O-0"), InvalidMove);
+        ASSERT_EQ(cg.checkNotationMove("O"), InvalidMove);
+    }
     TEST_F(AChessGameEngine, HasNotationToMoveMethod_FromAnItalianGame_WhiteToMove_PositionNotValidForCastling)
     {
         cg.loadPosition("r4rk1/ppp2ppp/3p1q2/n1b1p3/2B1P1b1/2NP1N2/PPPQ1PPP/2KR3R w - - 2 10");
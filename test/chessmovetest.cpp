@@ -274,4 +274,23 @@ namespace cSzd
         printChessMove(os, InvalidMove);
         ASSERT_EQ(os.str(), "InvalidMove");
     }
+
+    TEST(ChessMoveTester, TestPrintUCIFunction)
+    {
+        std::ostringstream os;
+        printUCIMove(os, chessMove(Pawn, e2, e4));
+        ASSERT_EQ(os.str(), "e2e4");
+
+        os.str(std::string());
+        printUCIMove(os, chessMove(King, e8, c8));
+        ASSERT_EQ(os.str(), "e8c8");
+
+        os.str(std::string());
+        printUCIMove(os, chessMove(Pawn, g2, h1, Rook, Knight));
+        ASSERT_EQ(os.str(), "g2h1n");
+
+        os.str(std::string());
+        printUCIMove(os, InvalidMove);
+        ASSERT_EQ(os.str(), "0000");
+    }
 }
@@ -0,0 +1,109 @@
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/epdrecord.h"
+
+using namespace std;
+using namespace testing;
+
+namespace cSzd
+{
+    constexpr std::string_view EPDKiwipete
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -"};
+
+    TEST(EPDRecordTester, ParsesThePositionAndTheOperations)
+    {
+        EPDRecord r;
+        ASSERT_EQ(r.loadRecord(std::string(EPDKiwipete) + " bm Bxa6 Qxf6; id \"kiwi pete; test\"; c0 \"first\"; noop;"), FENNoError);
+        ASSERT_EQ(r.board(), ChessBoard(std::string(EPDKiwipete) + " 0 1"));
+        ASSERT_THAT(r.operations, ElementsAre(EPDOperation{"bm", {"Bxa6", "Qxf6"}},
+                                              EPDOperation{"id", {"kiwi pete; test"}},
+                                              EPDOperation{"c0", {"first"}},
+                                              EPDOperation{"noop", {}}));
+        ASSERT_EQ(r.id(), "kiwi pete; test");
+        ASSERT_EQ(r.comment(), "first");
+        ASSERT_EQ(r.comment(1), "");
+        ASSERT_EQ(r.operation("am"), nullptr);
+        ASSERT_NE(r.operation("noop"), nullptr);
+    }
+
+    TEST(EPDRecordTester, AcceptsTheRecordsOfThePublishedSuites)
+    {
+        // The final semicolon is missing
+        EPDRecord r1 {std::string(EPDKiwipete) + " bm Bxa6; id \"kiwipete\""};
+        ASSERT_EQ(r1.id(), "kiwipete");
+        ASSERT_EQ(r1.operations.size(), 2U);
+
+        // The operations start with a semicolon (perft suites)
+        EPDRecord r2 {std::string(EPDKiwipete) + " ;D1 48 ;D2 2039"};
+        ASSERT_THAT(r2.operations, ElementsAre(EPDOperation{"D1", {"48"}}, EPDOperation{"D2", {"2039"}}));
+
+        // No operations
+        EPDRecord r3 {EPDKiwipete};
+        ASSERT_TRUE(r3.operations.empty());
+        ASSERT_EQ(r3.board(), ChessBoard(std::string(EPDKiwipete) + " 0 1"));
+    }
+
+    TEST(EPDRecordTester, ReturnsTheErrorOfInvalidRecords)
+    {
+        EPDRecord r;
+        ASSERT_EQ(r.loadRecord(std::string(EPDKiwipete) + " 1bm Bxa6;"), EPDInvalidOperation);
+        ASSERT_TRUE(r.operations.empty());
+        ASSERT_EQ(r.loadRecord(std::string(EPDKiwipete) + " id \"unterminated;"), EPDInvalidOperation);
+        ASSERT_EQ(r.loadRecord("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2 w KQkq - bm Bxa6;"), FENInvalidRank);
+        ASSERT_EQ(r.loadRecord("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq"), FENMissingField);
+        ASSERT_TRUE(r.operations.empty());
+    }
+
+    TEST(EPDRecordTester, TheMoveCounterOperationsSetTheBoardCounters)
+    {
+        EPDRecord r {std::string(EPDKiwipete) + " hmvc 7; fmvn 42;"};
+        ASSERT_EQ(r.board(), ChessBoard(std::string(EPDKiwipete) + " 7 42"));
+    }
+
+    TEST(EPDRecordTester, ConvertsTheBestAndAvoidMovesInLegalMoves)
+    {
+        EPDRecord r {std::string(EPDKiwipete) + " bm Bxa6 O-O d5d6 Ke3; am 0-0-0 gxh3 a2a4;"};
+        ASSERT_THAT(r.bestMoves(), ElementsAre(chessMove(Bishop, e2, a6, Bishop),
+                                               chessMove(King, e1, g1),
+                                               chessMove(Pawn, d5, d6)));
+        ASSERT_THAT(r.avoidMoves(), ElementsAre(chessMove(King, e1, c1),
+                                                chessMove(Pawn, g2, h3, Pawn),
+                                                chessMove(Pawn, a2, a4)));
+
+        EPDRecord p {"8/P1k5/K7/8/8/8/8/8 w - - bm a8=N+ a7a8q;"};
+        ASSERT_THAT(p.bestMoves(), ElementsAre(chessMove(Pawn, a7, a8, InvalidPiece, Knight),
+                                               chessMove(Pawn, a7, a8, InvalidPiece, Queen)));
+    }
+
+    TEST(EPDRecordTester, ConvertsTheFullyDisambiguatedMovesAndThePromotionsWithoutEquals)
+    {
+        EPDRecord r {"4k3/1P6/8/8/8/5N2/8/1N2K3 w - - bm Nb1d2 b8Q; am Nd2 b8;"};
+        ASSERT_THAT(r.bestMoves(), ElementsAre(chessMove(Knight, b1, d2),
+                                               chessMove(Pawn, b7, b8, InvalidPiece, Queen)));
+        // Ambiguous or incomplete moves
+        ASSERT_TRUE(r.avoidMoves().empty());
+    }
+
+    TEST(EPDRecordTester, EPDMoveReturnsInvalidMoveForUnrecognizedMoves)
+    {
+        ChessBoard cb {std::string(EPDKiwipete) + " 0 1"};
+        for (auto m : {"", "O", "O-", "0", "x", "!!", "+", "Nx", "exd", "e9", "a1a1", "e2e4q", "Qxf9", "O-O-O-O"})
+            ASSERT_EQ(epdMove(cb, m), InvalidMove) << m;
+    }
+
+    TEST(EPDRecordTester, ReturnsThePerftCountsOrderedByDepth)
+    {
+        EPDRecord r {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - ;D3 8902 ;D1 20 ;Dx 5 ;D2 400 ;D4"};
+        std::vector<EPDPerftCount> counts = r.perftCounts();
+        ASSERT_EQ(counts.size(), 3U);
+        for (auto i = 0U; i < counts.size(); i++)
+            ASSERT_EQ(counts[i].depth, i + 1);
+        ASSERT_EQ(counts[0].nodes, 20U);
+        ASSERT_EQ(counts[1].nodes, 400U);
+        ASSERT_EQ(counts[2].nodes, 8902U);
+    }
+
+}   // namespace cSzd
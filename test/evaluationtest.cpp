@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/evaluation.h"
+#include "cmdsuzdal/chessboard.h"
+
+using namespace std;
+using namespace testing;
+
+namespace cSzd
+{
+
+    // --------------------------------------------------------
+    TEST(EvaluationTester, TheInitialPositionIsBalanced)
+    {
+        ChessBoard cb;
+        ASSERT_EQ(cb.evalAccumulator.mg, 0);
+        ASSERT_EQ(cb.evalAccumulator.eg, 0);
+        ASSERT_EQ(cb.evalAccumulator.phase, MaxGamePhase);
+        ASSERT_EQ(pestoEvaluation(cb), 0);
+        ASSERT_TRUE(cb.evalAccumulator == computeEvalAccumulator(cb));
+    }
+
+    // --------------------------------------------------------
+    TEST(EvaluationTester, TheScoreIsFromThePointOfViewOfTheSideToMove)
+    {
+        ChessBoard w {"4k3/8/8/8/8/8/8/3QK3 w - - 0 1"};
+        ChessBoard b {"4k3/8/8/8/8/8/8/3QK3 b - - 0 1"};
+        ASSERT_GT(pestoEvaluation(w), 800);
+        ASSERT_EQ(pestoEvaluation(b), -pestoEvaluation(w));
+    }
+
+    // --------------------------------------------------------
+    TEST(EvaluationTester, MirroredPositionsHaveTheSameEvaluation)
+    {
+        // The same positions with the colors swapped and the board mirrored
+        ChessBoard cb1 {"r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4"};
+        ChessBoard cb2 {"rnbqk2r/pppp1ppp/5n2/2b1p3/4P3/2N2N2/PPPP1PPP/R1BQKB1R b KQkq - 4 4"};
+        ASSERT_EQ(pestoEvaluation(cb1), pestoEvaluation(cb2));
+        ASSERT_EQ(cb1.evalAccumulator.phase, cb2.evalAccumulator.phase);
+    }
+
+    // --------------------------------------------------------
+    TEST(EvaluationTester, InPawnEndingsOnlyTheEndgameValuesAreUsed)
+    {
+        // Pawn in e2: endgame value 94 + 13, middlegame value 82 - 15
+        ChessBoard cb {"4k3/8/8/8/8/8/4P3/4K3 w - - 0 1"};
+        ASSERT_EQ(cb.evalAccumulator.phase, 0);
+        ASSERT_EQ(pestoEvaluation(cb), taperedScore(cb.evalAccumulator));
+        ASSERT_EQ(cb.evalAccumulator.mg - computeEvalAccumulator(ChessBoard("4k3/8/8/8/8/8/8/4K3 w - - 0 1")).mg, 82 - 15);
+        ASSERT_EQ(cb.evalAccumulator.eg - computeEvalAccumulator(ChessBoard("4k3/8/8/8/8/8/8/4K3 w - - 0 1")).eg, 94 + 13);
+    }
+
+    // --------------------------------------------------------
+    // Walks the moves tree checking that the accumulator updated
+    // incrementally is always equal to the one computed from scratch
+    static void checkIncrementalEvaluationOfTheMovesTree(ChessBoard &cb, unsigned int depth)
+    {
+        ASSERT_TRUE(cb.evalAccumulator == computeEvalAccumulator(cb));
+        if (depth == 0)
+            return;
+        MoveList moves;
+        cb.generateLegalMoves(moves);
+        for (auto &m : moves) {
+            EvalAccumulator before = cb.evalAccumulator;
+            UndoInfo undo = cb.doMove(m);
+            checkIncrementalEvaluationOfTheMovesTree(cb, depth - 1);
+            cb.undoMove(m, undo);
+            ASSERT_TRUE(cb.evalAccumulator == before);
+        }
+    }
+    TEST(EvaluationTester, TheIncrementalAccumulatorIsEqualToTheOneComputedFromScratch)
+    {
+        ChessBoard cb;
+        for (auto fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                         "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+                         "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                         "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"}) {
+            cb.loadPosition(fen);
+            checkIncrementalEvaluationOfTheMovesTree(cb, 3);
+        }
+    }
+
+} // namespace cSzd
@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
@@ -264,4 +266,90 @@ namespace cSzd
         ASSERT_TRUE(fr1 == fr2);
     }
 
+    // Single pass parser
+    TEST(FENRecordTester, ParseFENFillsThePieceSetsAndTheStateFields)
+    {
+        FENPosition pos;
+        ASSERT_EQ(parseFEN(FENExampleCastlingEnPassantTest, pos), FENNoError);
+        FENRecord f {FENExampleCastlingEnPassantTest};
+        for (auto a : {WhiteArmy, BlackArmy}) {
+            for (auto p : {King, Queen, Bishop, Knight, Rook, Pawn})
+                ASSERT_EQ(BitBoard(pos.pieces[a][p]), f.extractBitBoard(a, p));
+        }
+        ASSERT_EQ(pos.sideToMove, BlackArmy);
+        ASSERT_EQ(BitBoard(pos.castlingAvailability), BitBoard({g1, c8}));
+        ASSERT_EQ(BitBoard(pos.enPassantTargetSquare), BitBoard({f3}));
+        ASSERT_EQ(pos.halfMoveClock, 0);
+        ASSERT_EQ(pos.fullMoves, 8);
+
+        ASSERT_EQ(parseFEN(FENExampleE97Position, pos), FENNoError);
+        ASSERT_EQ(pos.halfMoveClock, 1);
+        ASSERT_EQ(pos.fullMoves, 14);
+        ASSERT_EQ(parseFEN(FENEmptyChessBoard, pos), FENNoError);
+        ASSERT_EQ(pos.sideToMove, InvalidArmy);
+    }
+
+    TEST(FENRecordTester, ParseFENAcceptsExtraBlanksAndMissingMoveCounters)
+    {
+        FENPosition pos;
+        ASSERT_EQ(parseFEN("  rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR   b  KQkq e3 0   1 \r\n", pos), FENNoError);
+        ASSERT_EQ(BitBoard(pos.enPassantTargetSquare), BitBoard({e3}));
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3", pos), FENNoError);
+        ASSERT_EQ(pos.halfMoveClock, 0);
+        ASSERT_EQ(pos.fullMoves, 1);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 7", pos), FENNoError);
+        ASSERT_EQ(pos.halfMoveClock, 7);
+        ASSERT_EQ(pos.fullMoves, 1);
+    }
+
+    TEST(FENRecordTester, ParseFENReturnsTheErrorOfMalformedStrings)
+    {
+        FENPosition pos;
+        ASSERT_EQ(parseFEN("", pos), FENMissingField);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq", pos), FENMissingField);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNX w KQkq - 0 1", pos), FENInvalidPiece);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", pos), FENInvalidPiece);
+        ASSERT_EQ(parseFEN("rnbqkbnr/ppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", pos), FENInvalidRank);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNRR w KQkq - 0 1", pos), FENInvalidRank);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKB1 w KQkq - 0 1", pos), FENInvalidRank);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", pos), FENInvalidNumberOfRanks);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", pos), FENInvalidNumberOfRanks);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1", pos), FENInvalidActiveArmy);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR wb KQkq - 0 1", pos), FENInvalidActiveArmy);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQxq - 0 1", pos), FENInvalidCastling);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KKq - 0 1", pos), FENInvalidCastling);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e9 0 1", pos), FENInvalidEnPassant);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e 0 1", pos), FENInvalidEnPassant);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - -1 1", pos), FENInvalidHalfMoveClock);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1x", pos), FENInvalidFullMoves);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 4294967296", pos), FENInvalidFullMoves);
+        ASSERT_EQ(parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 c0", pos), FENTrailingCharacters);
+        ASSERT_STREQ(fenErrorDescription(FENInvalidCastling), "invalid castling availability");
+    }
+
+    TEST(FENRecordTester, LoadPositionReturnsTheParserError)
+    {
+        FENRecord f;
+        ASSERT_EQ(f.loadPosition(FENExampleE97Position), FENNoError);
+        ASSERT_EQ(f.loadPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 c0"), FENTrailingCharacters);
+        ASSERT_EQ(f.sideToMove(), InvalidArmy);
+    }
+
+    TEST(FENRecordTester, TheExtractedPositionOfAnInvalidRecordIsTheEmptyChessBoard)
+    {
+        FENPosition empty;
+        ASSERT_EQ(parseFEN(FENEmptyChessBoard, empty), FENNoError);
+        // invalid piece placement and invalid state field (with a valid placement)
+        for (auto fen : {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBN w KQkq - 0 1",
+                         "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQxq - 0 1"}) {
+            FENRecord f {fen};
+            FENPosition pos;
+            ASSERT_NE(f.extractPosition(pos), FENNoError) << fen;
+            ASSERT_EQ(std::memcmp(pos.pieces, empty.pieces, sizeof(pos.pieces)), 0) << fen;
+            ASSERT_EQ(pos.sideToMove, InvalidArmy) << fen;
+            ASSERT_EQ(pos.castlingAvailability, EmptyBB) << fen;
+        }
+        ASSERT_EQ(FENRecord("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBN w KQkq - 0 1").extractBitBoard(), BitBoard(EmptyBB));
+    }
+
 } // namespace cSzd
@@ -0,0 +1,59 @@
+#include <algorithm>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/movelist.h"
+#include "cmdsuzdal/chessboard.h"
+
+using namespace std;
+using namespace testing;
+
+namespace cSzd
+{
+
+    // --------------------------------------------------------
+    TEST(MoveListTester, ANewMoveListIsEmpty)
+    {
+        MoveList ml;
+        ASSERT_TRUE(ml.empty());
+        ASSERT_EQ(ml.size(), 0);
+        ASSERT_EQ(ml.begin(), ml.end());
+        ASSERT_EQ(ml.capacity(), 256);
+    }
+
+    // --------------------------------------------------------
+    TEST(MoveListTester, MovesAreStoredInInsertionOrder)
+    {
+        MoveList ml;
+        ml.push_back(chessMove(Pawn, e2, e4));
+        ml.push_back(chessMove(Knight, g1, f3));
+        ml.push_back(chessMove(Bishop, f1, c4));
+        ASSERT_FALSE(ml.empty());
+        ASSERT_EQ(ml.size(), 3);
+        ASSERT_EQ(ml[0], chessMove(Pawn, e2, e4));
+        ASSERT_EQ(ml[1], chessMove(Knight, g1, f3));
+        ASSERT_EQ(ml.back(), chessMove(Bishop, f1, c4));
+        ASSERT_THAT(ml, ElementsAre(chessMove(Pawn, e2, e4), chessMove(Knight, g1, f3),
+                                    chessMove(Bishop, f1, c4)));
+        ASSERT_TRUE(std::find(ml.begin(), ml.end(), chessMove(Knight, g1, f3)) != ml.end());
+
+        ml.pop_back();
+        ASSERT_EQ(ml.size(), 2);
+        ml.clear();
+        ASSERT_TRUE(ml.empty());
+    }
+
+    // --------------------------------------------------------
+    TEST(MoveListTester, MoveListAndVectorGenerationsGiveTheSameMoves)
+    {
+        // A position with 218 legal moves (the maximum known)
+        ChessBoard cb {"R6R/3Q4/1Q4Q1/4Q3/2Q4Q/Q4Q2/pp1Q4/kBNN1KB1 w - - 0 1"};
+        MoveList ml;
+        std::vector<ChessMove> mv;
+        cb.generateLegalMoves(ml);
+        cb.generateLegalMoves(mv);
+        ASSERT_EQ(ml.size(), 218);
+        ASSERT_TRUE(std::equal(ml.begin(), ml.end(), mv.begin(), mv.end()));
+    }
+
+} // namespace cSzd
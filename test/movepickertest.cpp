@@ -0,0 +1,121 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/movepicker.h"
+
+using namespace std;
+using namespace testing;
+
+namespace cSzd
+{
+    const char *KiwipeteFEN = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+    std::vector<ChessMove> pickAll(MovePicker &picker)
+    {
+        std::vector<ChessMove> picked;
+        ChessMove m;
+        while ((m = picker.nextMove()) != InvalidMove)
+            picked.push_back(m);
+        return picked;
+    }
+
+    std::vector<ChessMove> legalMoves(const ChessBoard &cb)
+    {
+        MoveList moves;
+        cb.generateLegalMoves(moves);
+        return std::vector<ChessMove>(moves.begin(), moves.end());
+    }
+
+    TEST(MovePickerTester, ReturnsAllTheLegalMovesExactlyOnce)
+    {
+        for (auto fen : {KiwipeteFEN,
+                         "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                         "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+                         "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"}) {
+            ChessBoard cb {fen};
+            std::vector<ChessMove> all = legalMoves(cb);
+            ChessMove killers[NumKillers] = {all.back(), all[all.size() / 2]};
+            HistoryTable history;
+            history.update(cb.sideToMove, all[1], 100);
+            MovePicker picker {cb, all[0], killers, &history};
+            ASSERT_THAT(pickAll(picker), UnorderedElementsAreArray(all)) << cb;
+            ASSERT_EQ(picker.stage(), DoneStage);
+            ASSERT_EQ(picker.nextMove(), InvalidMove);
+        }
+    }
+
+    TEST(MovePickerTester, IgnoresTheIllegalTranspositionTableAndKillerMoves)
+    {
+        ChessBoard cb {KiwipeteFEN};
+        ChessMove killers[NumKillers] = {chessMove(Pawn, e4, e5), chessMove(Knight, b1, c3)};
+        MovePicker picker {cb, chessMove(Queen, f3, f7), killers, nullptr};
+        ASSERT_THAT(pickAll(picker), UnorderedElementsAreArray(legalMoves(cb)));
+    }
+
+    TEST(MovePickerTester, ReturnsTheMovesInStages)
+    {
+        ChessBoard cb {KiwipeteFEN};
+        ChessMove ttMove = chessMove(Bishop, e2, a6, Bishop);
+        ChessMove killers[NumKillers] = {chessMove(Pawn, a2, a3), chessMove(Pawn, g2, g3)};
+        HistoryTable history;
+        history.update(WhiteArmy, chessMove(Queen, f3, f4), 400);
+        history.update(WhiteArmy, chessMove(King, e1, g1), 200);
+        MovePicker picker {cb, ttMove, killers, &history};
+        std::vector<ChessMove> picked = pickAll(picker);
+
+        ASSERT_EQ(picked[0], ttMove);
+        // The good captures, most valuable victim first
+        unsigned int i = 1;
+        int lastVictim = SEEPieceValues[King];
+        for (; isACaptureOrPromotion(picked[i]) && cb.seeGE(picked[i], 0); i++) {
+            int victim = SEEPieceValues[chessMoveGetTakenPiece(picked[i])];
+            ASSERT_LE(victim, lastVictim) << picked[i];
+            lastVictim = victim;
+        }
+        ASSERT_GT(i, 1U);
+        ASSERT_EQ(picked[i++], killers[0]);
+        ASSERT_EQ(picked[i++], killers[1]);
+        ASSERT_EQ(picked[i++], chessMove(Queen, f3, f4));
+        ASSERT_EQ(picked[i++], chessMove(King, e1, g1));
+        for (; (i < picked.size()) && !isACaptureOrPromotion(picked[i]); i++)
+            ;
+        // The losing captures are the last ones (Qxf6 gxf6, Qxh3 gxh3...)
+        ASSERT_LT(i, picked.size());
+        for (; i < picked.size(); i++)
+            ASSERT_FALSE(cb.seeGE(picked[i], 0)) << picked[i];
+    }
+
+    TEST(MovePickerTester, GeneratesTheMovesOnlyWhenNeeded)
+    {
+        ChessBoard cb {KiwipeteFEN};
+        MovePicker picker {cb, chessMove(Bishop, e2, a6, Bishop), nullptr, nullptr};
+        ASSERT_EQ(picker.nextMove(), chessMove(Bishop, e2, a6, Bishop));
+        ASSERT_EQ(picker.movesGenerated(), 0U);
+        picker.nextMove();
+        ASSERT_EQ(picker.stage(), GoodCapturesStage);
+        MoveList captures;
+        cb.generateLegalMoves(captures, CaptureMoves);
+        ASSERT_EQ(picker.movesGenerated(), captures.size());
+        pickAll(picker);
+        ASSERT_EQ(picker.movesGenerated(), legalMoves(cb).size());
+    }
+
+    TEST(MovePickerTester, QuiescencePickerReturnsOnlyTheCapturesNotLosingMaterial)
+    {
+        for (auto fen : {KiwipeteFEN,
+                         "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"}) {
+            ChessBoard cb {fen};
+            std::vector<ChessMove> expected;
+            for (auto &m : legalMoves(cb)) {
+                if (isACaptureOrPromotion(m) && cb.seeGE(m, 0))
+                    expected.push_back(m);
+            }
+            // Only the captures are accepted as transposition table moves
+            MovePicker picker {cb, chessMove(Pawn, a2, a3)};
+            ASSERT_THAT(pickAll(picker), UnorderedElementsAreArray(expected)) << cb;
+            ASSERT_EQ(picker.stage(), DoneStage);
+        }
+    }
+
+}   // namespace cSzd
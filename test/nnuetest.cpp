@@ -0,0 +1,179 @@
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/nnue.h"
+#include "cmdsuzdal/alphabetaengine.h"
+#include "tempfilestest.h"
+
+using namespace std;
+using namespace testing;
+
+namespace cSzd
+{
+    class ANNUE: public TempFilesTest {
+        public:
+            static std::string netFile;
+            NNUE nnue {netFile};
+
+            // Writes a network file with random weights
+            static void SetUpTestSuite()
+            {
+                netFile = testing::TempDir() + "cmdsuzdal_random.nnue";
+                std::vector<char> data(NNUEFileSize, 0);
+                std::memcpy(data.data(), "CSZDNNUE", 8);
+                std::uint32_t hdr[5] = {1, NNUEFeatures, NNUEHiddenSize, NNUEDense1Size, NNUEDense2Size};
+                std::memcpy(data.data() + 8, hdr, sizeof(hdr));
+
+                std::mt19937 rng(20211017);
+                auto fill16 = [&](std::size_t offset, std::size_t n, int lo, int hi) {
+                    std::uniform_int_distribution<int> d(lo, hi);
+                    for (auto i = 0U; i < n; i++) {
+                        auto v = static_cast<std::int16_t>(d(rng));
+                        std::memcpy(data.data() + offset + i * 2, &v, 2);
+                    }
+                };
+                auto fill32 = [&](std::size_t offset, std::size_t n, int lo, int hi) {
+                    std::uniform_int_distribution<int> d(lo, hi);
+                    for (auto i = 0U; i < n; i++) {
+                        auto v = static_cast<std::int32_t>(d(rng));
+                        std::memcpy(data.data() + offset + i * 4, &v, 4);
+                    }
+                };
+                auto fill8 = [&](std::size_t offset, std::size_t n, int lo, int hi) {
+                    std::uniform_int_distribution<int> d(lo, hi);
+                    for (auto i = 0U; i < n; i++)
+                        data[offset + i] = static_cast<char>(d(rng));
+                };
+                fill16(NNUEFTBiasesOffset, NNUEHiddenSize, 0, 64);
+                fill16(NNUEFTWeightsOffset, std::size_t(NNUEFeatures) * NNUEHiddenSize, -32, 32);
+                fill32(NNUEDense1BiasesOffset, NNUEDense1Size, -2000, 2000);
+                fill8(NNUEDense1WeightsOffset, NNUEDense1Size * 2 * NNUEHiddenSize, -127, 127);
+                fill32(NNUEDense2BiasesOffset, NNUEDense2Size, -2000, 2000);
+                fill8(NNUEDense2WeightsOffset, NNUEDense2Size * NNUEDense1Size, -127, 127);
+                fill32(NNUEOutputBiasOffset, 1, -2000, 2000);
+                fill8(NNUEOutputWeightsOffset, NNUEDense2Size, -127, 127);
+
+                std::FILE *f = std::fopen(netFile.c_str(), "wb");
+                ASSERT_NE(f, nullptr);
+                ASSERT_EQ(std::fwrite(data.data(), 1, data.size(), f), data.size());
+                std::fclose(f);
+            }
+            static void TearDownTestSuite() { std::remove(netFile.c_str()); }
+
+            // Walks the moves tree checking that the accumulators updated
+            // incrementally are equal to the ones computed from scratch
+            void checkUpdates(ChessBoard &cb, std::vector<NNUEAccumulator> &stack,
+                              unsigned int depth, unsigned int ply)
+            {
+                NNUEAccumulator fresh;
+                nnue.refresh(cb, fresh);
+                ASSERT_EQ(std::memcmp(&fresh, &stack[ply], sizeof(fresh)), 0) << cb;
+                if (depth == 0)
+                    return;
+                MoveList moves;
+                cb.generateLegalMoves(moves);
+                for (auto &m : moves) {
+                    UndoInfo undo = cb.doMove(m);
+                    nnue.update(cb, m, undo, stack[ply], stack[ply + 1]);
+                    checkUpdates(cb, stack, depth - 1, ply + 1);
+                    cb.undoMove(m, undo);
+                }
+            }
+    };
+    std::string ANNUE::netFile;
+
+    TEST_F(ANNUE, LoadsAValidNetworkFile)
+    {
+        ASSERT_TRUE(nnue.isLoaded());
+        NNUE other;
+        ASSERT_FALSE(other.isLoaded());
+        ASSERT_TRUE(other.load(netFile));
+        ASSERT_TRUE(other.isLoaded());
+    }
+
+    TEST_F(ANNUE, DoesNotLoadMissingOrInvalidFiles)
+    {
+        NNUE other;
+        ASSERT_FALSE(other.load(testing::TempDir() + "cmdsuzdal_missing.nnue"));
+
+        std::string data(NNUEFileSize, '\0');
+        std::memcpy(&data[0], "CSZDNNUF", 8);
+        ASSERT_FALSE(other.load(writeFile("cmdsuzdal_bad.nnue", data)));
+        ASSERT_FALSE(other.load(writeFile("cmdsuzdal_short.nnue", std::string(1024, '\0'))));
+        ASSERT_FALSE(other.isLoaded());
+    }
+
+    TEST_F(ANNUE, FeaturesOfTheBlackPerspectiveAreVerticallyMirrored)
+    {
+        ASSERT_EQ(nnueFeature(WhiteArmy, e1, WhiteArmy, Queen, d1), (e1 * 10 + 0) * 64 + d1);
+        ASSERT_EQ(nnueFeature(BlackArmy, e8, BlackArmy, Queen, d8), nnueFeature(WhiteArmy, e1, WhiteArmy, Queen, d1));
+        ASSERT_EQ(nnueFeature(BlackArmy, e8, WhiteArmy, Pawn, e2), nnueFeature(WhiteArmy, e1, BlackArmy, Pawn, e7));
+    }
+
+    TEST_F(ANNUE, UpdatesTheAccumulatorIncrementally)
+    {
+        std::vector<NNUEAccumulator> stack(4);
+        for (auto fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                         "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                         "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"}) {
+            ChessBoard cb {fen};
+            nnue.refresh(cb, stack[0]);
+            checkUpdates(cb, stack, 3, 0);
+        }
+    }
+
+    TEST_F(ANNUE, AllTheKernelsComputeTheSameResults)
+    {
+        std::vector<NNUEAccumulator> accs(3);
+        std::vector<int> scores;
+        ChessBoard cb {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+        ChessMove m = chessMove(Bishop, e2, a6, Bishop);
+        for (auto k : {ScalarKernels, SSSE3Kernels, AVX2Kernels}) {
+            nnue.setKernels(k);
+            ASSERT_LE(nnue.kernels(), nnueBestKernels());
+            NNUEAccumulator acc;
+            nnue.refresh(cb, acc);
+            ChessBoard after = cb;
+            UndoInfo undo = after.doMove(m);
+            nnue.update(after, m, undo, acc, accs[k]);
+            scores.push_back(nnue.evaluate(acc, cb.sideToMove));
+            scores.push_back(nnue.evaluate(accs[k], after.sideToMove));
+        }
+        ASSERT_EQ(std::memcmp(&accs[0], &accs[1], sizeof(NNUEAccumulator)), 0);
+        ASSERT_EQ(std::memcmp(&accs[0], &accs[2], sizeof(NNUEAccumulator)), 0);
+        ASSERT_THAT(scores, ElementsAre(scores[0], scores[1], scores[0], scores[1], scores[0], scores[1]));
+    }
+
+    TEST_F(ANNUE, EvaluatesTheMirroredPositionsInTheSameWay)
+    {
+        NNUEAccumulator acc, mirroredAcc;
+        ChessBoard cb {"4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1"};
+        ChessBoard mirrored {"3rk3/8/8/8/3Q4/8/8/4K3 b - - 0 1"};
+        nnue.refresh(cb, acc);
+        nnue.refresh(mirrored, mirroredAcc);
+        ASSERT_EQ(nnue.evaluate(acc, cb.sideToMove), nnue.evaluate(mirroredAcc, mirrored.sideToMove));
+    }
+
+    TEST_F(ANNUE, CanBeUsedByTheAlphaBetaEngine)
+    {
+        AlphaBetaEngine abEng {1, 2};
+        abEng.setNetwork(&nnue);
+        abEng.setLimits(SearchLimits{4, 0, std::chrono::milliseconds(0)});
+        ASSERT_EQ(abEng.move(ChessBoard("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1")), chessMove(Rook, a1, a8));
+        ASSERT_EQ(abEng.lastSearchInfo().score, MateScore - 1);
+        // (the random network does not know the values of the pieces, so
+        // a quiet position is used to keep the quiescence search short)
+        ChessBoard cb {"4k3/pp6/8/8/8/8/5PP1/4K3 w - - 0 1"};
+        ChessMove m = abEng.move(cb);
+        MoveList moves;
+        cb.generateLegalMoves(moves);
+        ASSERT_NE(std::find(moves.begin(), moves.end(), m), moves.end());
+        ASSERT_FALSE(isMateScore(abEng.lastSearchInfo().score));
+    }
+
+}   // namespace cSzd
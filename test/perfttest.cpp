@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/perft.h"
+
+using namespace std;
+using namespace testing;
+
+namespace cSzd
+{
+
+    // --------------------------------------------------------
+    TEST(PerftTester, PerftAtDepthZeroIsOneNode)
+    {
+        ASSERT_EQ(perft(ChessBoard(), 0), 1);
+        ASSERT_TRUE(perftDivide(ChessBoard(), 0).empty());
+    }
+
+    // --------------------------------------------------------
+    TEST(PerftTester, PerftOfTheInitialPosition)
+    {
+        ChessBoard cb;
+        ASSERT_EQ(perft(cb, 1), 20);
+        ASSERT_EQ(perft(cb, 2), 400);
+        ASSERT_EQ(perft(cb, 3), 8902);
+    }
+
+    // --------------------------------------------------------
+    TEST(PerftTester, PerftOfPositionsWithCastlingPromotionsAndEnPassant)
+    {
+        // Kiwipete
+        ASSERT_EQ(perft(ChessBoard("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"), 3), 97862);
+        ASSERT_EQ(perft(ChessBoard("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"), 4), 43238);
+        ASSERT_EQ(perft(ChessBoard("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"), 3), 9467);
+        ASSERT_EQ(perft(ChessBoard("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"), 3), 62379);
+    }
+
+    // --------------------------------------------------------
+    TEST(PerftTester, PerftDivideSumsToPerft)
+    {
+        ChessBoard cb {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"};
+        auto entries = perftDivide(cb, 3);
+        ASSERT_EQ(entries.size(), 46);
+        std::uint64_t nodes = 0;
+        for (auto &e : entries)
+            nodes += e.nodes;
+        ASSERT_EQ(nodes, 89890);
+
+        // the divide entries follow the order of the generated moves
+        std::vector<ChessMove> moves;
+        cb.generateLegalMoves(moves);
+        for (auto i = 0U; i < moves.size(); i++)
+            ASSERT_EQ(entries[i].move, moves[i]);
+    }
+
+    // --------------------------------------------------------
+    TEST(PerftTester, HashedPerftGivesTheSameResults)
+    {
+        PerftHashTable hashTable(1);
+        ASSERT_EQ(hashTable.numEntries(), 65536);
+        ChessBoard cb {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+        ASSERT_EQ(perft(cb, 3, &hashTable), 97862);
+        // second run: the results come from the hash table
+        ASSERT_EQ(perft(cb, 3, &hashTable), 97862);
+        ASSERT_EQ(perft(cb, 2, &hashTable), 2039);
+        hashTable.clear();
+        ASSERT_EQ(perft(cb, 3, &hashTable), 97862);
+    }
+
+    // --------------------------------------------------------
+    TEST(PerftTester, MultithreadedPerftDivideGivesTheSameResults)
+    {
+        ThreadPool pool(4);
+        PerftHashTable hashTable(1);
+        ChessBoard cb {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"};
+        for (auto depth = 1U; depth <= 3; depth++) {
+            auto serial = perftDivide(cb, depth);
+            auto parallel = perftDivide(cb, depth, pool);
+            auto parallelHashed = perftDivide(cb, depth, pool, &hashTable);
+            ASSERT_EQ(parallel.size(), serial.size());
+            ASSERT_EQ(parallelHashed.size(), serial.size());
+            for (auto i = 0U; i < serial.size(); i++) {
+                ASSERT_EQ(parallel[i].move, serial[i].move);
+                ASSERT_EQ(parallel[i].nodes, serial[i].nodes);
+                ASSERT_EQ(parallelHashed[i].move, serial[i].move);
+                ASSERT_EQ(parallelHashed[i].nodes, serial[i].nodes);
+            }
+        }
+    }
+
+} // namespace cSzd
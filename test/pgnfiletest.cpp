@@ -0,0 +1,183 @@
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/pgnfile.h"
+#include "tempfilestest.h"
+
+using namespace std;
+using namespace testing;
+
+namespace cSzd
+{
+    const std::string PGNOperaGame =
+        "[Event \"Paris\"]\n"
+        "[Site \"Paris FRA\"]\n"
+        "[Date \"1858.??.??\"]\n"
+        "[White \"Paul Morphy\"]\n"
+        "[Black \"Duke Karl / Count Isouard\"]\n"
+        "[Result \"1-0\"]\n"
+        "\n"
+        "1. e4 e5 2. Nf3 d6 3. d4 Bg4 4. dxe5 Bxf3 5. Qxf3 dxe5 6. Bc4 Nf6 7. Qb3 Qe7\n"
+        "8. Nc3 c6 9. Bg5 b5 10. Nxb5 cxb5 11. Bxb5+ Nbd7 12. O-O-O Rd8 13. Rxd7 Rxd7\n"
+        "14. Rd1 Qe6 15. Bxd7+ Nxd7 16. Qb8+ Nxb8 17. Rd8# 1-0\n";
+
+    const std::string PGNAnnotatedGame =
+        "[Event \"Test \\\"annotated\\\"\"]\n"
+        "[Result \"1/2-1/2\"]\n"
+        "\n"
+        "1.e4 Nf6 {Alekhine defence} 2. e5 d5 $5 3. exd6 (3. d4 c5 (3... Bf5) 4. c3) 3... exd6\n"
+        "4. Nf3 Be7 ; the bishop is developed\n"
+        "5. Bc4!? 0-0 6. O-O Nc6 1/2-1/2\n";
+
+    const std::string PGNPromotionGame =
+        "[Event \"Promotion\"]\n"
+        "[SetUp \"1\"]\n"
+        "[FEN \"4k3/1P6/8/8/8/8/K7/8 w - - 0 1\"]\n"
+        "\n"
+        "1. b8=Q+ Kd7 (1... Ke7 2. Qe5+) 2. Qb5+ Kc7 *\n";
+
+    class APGNFile: public TempFilesTest {};
+
+    // The position reached replaying the moves of a game
+    ChessBoard finalPosition(const PGNGame &game, const std::string &fen = "")
+    {
+        ChessBoard cb;
+        if (!fen.empty())
+            cb.loadPosition(fen);
+        for (auto &m : game.moves)
+            cb.doMove(m);
+        return cb;
+    }
+
+    TEST(PGNFileTester, DecodesTheTagsTheMovesAndTheResultOfAGame)
+    {
+        PGNGame game;
+        ASSERT_EQ(parsePGNGame(PGNOperaGame, game), PGNNoError);
+        ASSERT_EQ(game.tags.size(), 6U);
+        ASSERT_EQ(game.tags["White"], "Paul Morphy");
+        ASSERT_EQ(game.tags["Black"], "Duke Karl / Count Isouard");
+        ASSERT_EQ(game.moves.size(), 33U);
+        ASSERT_EQ(game.moves[22], chessMove(King, e1, c1));
+        ASSERT_EQ(game.result, "1-0");
+        ASSERT_EQ(finalPosition(game), ChessBoard("1n1Rkb1r/p4ppp/4q3/4p1B1/4P3/8/PPP2PPP/2K5 b k - 1 17"));
+    }
+
+    TEST(PGNFileTester, SkipsTheCommentsTheVariationsAndTheAnnotations)
+    {
+        PGNGame game;
+        ASSERT_EQ(parsePGNGame(PGNAnnotatedGame, game), PGNNoError);
+        ASSERT_EQ(game.tags["Event"], "Test \"annotated\"");
+        ASSERT_EQ(game.moves.size(), 12U);
+        ASSERT_EQ(game.moves[4], chessMove(Pawn, e5, d6, Pawn));
+        ASSERT_EQ(game.moves[9], chessMove(King, e8, g8));
+        ASSERT_EQ(game.moves[10], chessMove(King, e1, g1));
+        ASSERT_EQ(game.result, "1/2-1/2");
+
+        ASSERT_EQ(parsePGNGame(PGNPromotionGame, game), PGNNoError);
+        ASSERT_THAT(game.moves, ElementsAre(chessMove(Pawn, b7, b8, InvalidPiece, Queen),
+                                            chessMove(King, e8, d7),
+                                            chessMove(Queen, b8, b5),
+                                            chessMove(King, d7, c7)));
+        ASSERT_EQ(game.result, "*");
+        ASSERT_EQ(finalPosition(game, game.tags["FEN"]), ChessBoard("8/2k5/8/1Q6/8/8/K7/8 w - - 3 3"));
+    }
+
+    TEST(PGNFileTester, ReturnsTheErrorOfInvalidGames)
+    {
+        PGNGame game;
+        ASSERT_EQ(parsePGNGame("[Event Paris]\n\n1. e4 *", game), PGNInvalidTag);
+        ASSERT_EQ(parsePGNGame("[Event \"Paris\"\n\n1. e4 *", game), PGNInvalidTag);
+        ASSERT_EQ(parsePGNGame("[FEN \"8/8/8\"]\n\n1. e4 *", game), PGNInvalidPosition);
+        ASSERT_EQ(parsePGNGame("1. e4 e5 2. e5 *", game), PGNInvalidMove);
+        ASSERT_EQ(game.moves.size(), 2U);
+        ASSERT_EQ(parsePGNGame("1. e4 {open comment e5 *", game), PGNUnterminatedComment);
+        ASSERT_EQ(parsePGNGame("1. e4 (1. d4 d5 *", game), PGNUnterminatedVariation);
+        ASSERT_EQ(parsePGNGame("1. e4 ) e5 *", game), PGNUnterminatedVariation);
+
+        // Without the result the game ends with the text
+        ASSERT_EQ(parsePGNGame("[Result \"0-1\"]\n1. f3 e5 2. g4 Qh4#", game), PGNNoError);
+        ASSERT_EQ(game.moves.size(), 4U);
+        ASSERT_EQ(game.result, "0-1");
+    }
+
+    TEST_F(APGNFile, FindsTheGameBoundaries)
+    {
+        std::string content = PGNOperaGame + "\n" + PGNAnnotatedGame + "\n\n" + PGNPromotionGame;
+        PGNFile pf {writeFile("cmdsuzdal_test.pgn", content)};
+        ASSERT_TRUE(pf.isOpen());
+        std::size_t second = content.find("[Event \"Test");
+        std::size_t third = content.find("[Event \"Promotion");
+        ASSERT_EQ(pf.nextGame(0), 0U);
+        ASSERT_EQ(pf.nextGame(1), second);
+        ASSERT_EQ(pf.nextGame(second), second);
+        ASSERT_EQ(pf.nextGame(second + 1), third);
+        ASSERT_EQ(pf.nextGame(content.find("[Result \"1/2-1/2")), third);
+        ASSERT_EQ(pf.nextGame(third + 1), content.size());
+        ASSERT_EQ(pf.nextGame(content.size() + 10), content.size());
+
+        std::vector<std::size_t> offsets;
+        PGNFileStats stats = pf.forEach([&offsets](const PGNGame &game) { offsets.push_back(game.offset); });
+        ASSERT_EQ(stats.games, 3U);
+        ASSERT_EQ(stats.moves, 33U + 12U + 4U);
+        ASSERT_EQ(stats.errors, 0U);
+        ASSERT_THAT(offsets, ElementsAre(0U, second, third));
+
+        // Resumes from the second game
+        offsets.clear();
+        stats = pf.forEach([&offsets](const PGNGame &game) { offsets.push_back(game.offset); }, second);
+        ASSERT_EQ(stats.games, 2U);
+        ASSERT_THAT(offsets, ElementsAre(second, third));
+    }
+
+    TEST_F(APGNFile, DecodesTheGamesInParallel)
+    {
+        // More than 2 MB, so the file is split in chunks and windows
+        std::string content;
+        std::size_t firstErrorOffset = 0;
+        std::size_t numGames = 0;
+        for (auto i = 0U; content.size() < 3 * 1024 * 1024; i++) {
+            if (i == 1234) {
+                firstErrorOffset = content.size();
+                content += "[Event \"Invalid\"]\n\n1. e4 e5 2. Ke3 *\n\n";
+            }
+            content += PGNOperaGame + "\n" + PGNAnnotatedGame + "\n" + PGNPromotionGame + "\n";
+            numGames += 3;
+        }
+        PGNFile pf {writeFile("cmdsuzdal_many.pgn", content)};
+
+        std::size_t seqMoves = 0;
+        PGNFileStats seqStats = pf.forEach([&seqMoves](const PGNGame &game) { seqMoves += game.moves.size(); });
+        ASSERT_EQ(seqStats.games, numGames);
+        ASSERT_EQ(seqStats.moves, seqMoves);
+        ASSERT_EQ(seqStats.errors, 1U);
+        ASSERT_EQ(seqStats.firstError, PGNInvalidMove);
+        ASSERT_EQ(seqStats.firstErrorOffset, firstErrorOffset);
+
+        std::mutex mtx;
+        std::vector<std::size_t> offsets;
+        ThreadPool pool(4);
+        PGNFileStats parStats = pf.forEach([&](const PGNGame &game) {
+            EXPECT_EQ(game.moves.size(), (game.tags.at("Event") == "Paris") ? 33U : ((game.tags.at("Event") == "Promotion") ? 4U : 12U));
+            std::lock_guard<std::mutex> lock(mtx);
+            offsets.push_back(game.offset);
+        }, pool);
+        ASSERT_EQ(parStats.games, numGames);
+        ASSERT_EQ(parStats.moves, seqStats.moves);
+        ASSERT_EQ(parStats.errors, 1U);
+        ASSERT_EQ(parStats.firstErrorOffset, firstErrorOffset);
+        ASSERT_EQ(offsets.size(), numGames);
+
+        // Resumes from the middle of the file
+        std::size_t resume = pf.nextGame(content.size() / 2);
+        std::size_t expected = 0;
+        for (auto o : offsets)
+            expected += (o >= resume) ? 1 : 0;
+        PGNFileStats resumed = pf.forEach([](const PGNGame &) {}, pool, resume);
+        ASSERT_EQ(resumed.games, expected);
+        ASSERT_EQ(resumed.errors, 0U);
+    }
+
+}   // namespace cSzd
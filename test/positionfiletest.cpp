@@ -0,0 +1,165 @@
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/positionfile.h"
+#include "tempfilestest.h"
+
+using namespace std;
+using namespace testing;
+
+namespace cSzd
+{
+    class APositionFile: public TempFilesTest {
+        public:
+            // The FEN strings of the positions reached in two plies from
+            // Kiwipete (more than 2000 lines, so the file is split in chunks)
+            static std::vector<std::string> manyFENs()
+            {
+                std::vector<std::string> fens;
+                ChessBoard cb {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+                MoveList moves;
+                cb.generateLegalMoves(moves);
+                for (auto &m : moves) {
+                    UndoInfo undo = cb.doMove(m);
+                    MoveList replies;
+                    cb.generateLegalMoves(replies);
+                    for (auto &r : replies) {
+                        UndoInfo undo2 = cb.doMove(r);
+                        fens.push_back(cb.toFEN());
+                        cb.undoMove(r, undo2);
+                    }
+                    cb.undoMove(m, undo);
+                }
+                return fens;
+            }
+    };
+
+    TEST(PositionFileTester, FindNewlineReturnsTheFirstNewlineOrTheEnd)
+    {
+        std::string s(100, 'x');
+        for (auto len = 0U; len <= s.size(); len++) {
+            ASSERT_EQ(findNewline(s.data(), s.data() + len), s.data() + len);
+            for (auto nl = 0U; nl < len; nl++) {
+                std::string t = s;
+                t[nl] = '\n';
+                if (nl + 3 < len)
+                    t[nl + 3] = '\n';
+                ASSERT_EQ(findNewline(t.data(), t.data() + len), t.data() + nl);
+            }
+        }
+    }
+
+    TEST_F(APositionFile, DoesNotOpenMissingFiles)
+    {
+        PositionFile pf;
+        ASSERT_FALSE(pf.open(testing::TempDir() + "cmdsuzdal_missing.fen"));
+        ASSERT_FALSE(pf.isOpen());
+        std::vector<ChessBoard> positions;
+        PositionFileStats stats = pf.load(positions);
+        ASSERT_EQ(stats.positions, 0U);
+        ASSERT_TRUE(positions.empty());
+    }
+
+    TEST_F(APositionFile, LoadsTheValidPositionsAndCountsTheErrors)
+    {
+        std::string content = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1\n"
+                              "\n"
+                              "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1\r\n"
+                              "  \t\r\n"
+                              "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBN w KQkq - 0 1\n"
+                              "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -\n"
+                              "not a position\n"
+                              "rnbqkr2/ppp1ppbp/3p1n2/8/1PPPPPp1/P1N5/6PP/1RBQKBNR b Kq f3 0 8";
+        PositionFile pf {writeFile("cmdsuzdal_test.fen", content)};
+        ASSERT_TRUE(pf.isOpen());
+        ASSERT_EQ(pf.format(), FENFile);
+        ASSERT_EQ(pf.contents(), content);
+
+        std::vector<ChessBoard> positions;
+        PositionFileStats stats = pf.load(positions);
+        ASSERT_EQ(stats.lines, 6U);
+        ASSERT_EQ(stats.positions, 4U);
+        ASSERT_EQ(stats.errors, 2U);
+        ASSERT_EQ(stats.firstError, FENInvalidRank);
+        ASSERT_EQ(stats.firstErrorOffset, content.find("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBN "));
+        ASSERT_THAT(positions, ElementsAre(ChessBoard(),
+                                           ChessBoard("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+                                           ChessBoard("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"),
+                                           ChessBoard("rnbqkr2/ppp1ppbp/3p1n2/8/1PPPPPp1/P1N5/6PP/1RBQKBNR b Kq f3 0 8")));
+    }
+
+    TEST_F(APositionFile, IgnoresTheOperationsOfTheEPDFiles)
+    {
+        std::string content = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - bm e2a6; id \"kiwipete\";\n"
+                              "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -\n";
+        PositionFile pf {writeFile("cmdsuzdal_test.epd", content)};
+        ASSERT_EQ(pf.format(), EPDFile);
+        std::vector<ChessBoard> positions;
+        PositionFileStats stats = pf.load(positions);
+        ASSERT_EQ(stats.positions, 2U);
+        ASSERT_EQ(stats.errors, 0U);
+        ASSERT_EQ(positions[0], ChessBoard("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"));
+
+        // The same lines are not valid FEN strings
+        pf.setFormat(FENFile);
+        positions.clear();
+        stats = pf.load(positions);
+        ASSERT_EQ(stats.positions, 1U);
+        ASSERT_EQ(stats.firstError, FENInvalidHalfMoveClock);
+    }
+
+    TEST_F(APositionFile, LoadsTheChunksInParallelInTheOrderOfTheFile)
+    {
+        std::vector<std::string> fens = manyFENs();
+        std::string content;
+        for (auto i = 0U; i < fens.size(); i++) {
+            content += fens[i] + "\n";
+            if (i % 500 == 0)
+                content += "invalid line\n";
+        }
+        PositionFile pf {writeFile("cmdsuzdal_many.fen", content)};
+        ASSERT_GT(content.size(), 2 * 64 * 1024U);
+
+        std::vector<ChessBoard> sequential, parallel;
+        PositionFileStats seqStats = pf.load(sequential);
+        ThreadPool pool(4);
+        PositionFileStats parStats = pf.load(parallel, pool);
+        ASSERT_EQ(seqStats.positions, fens.size());
+        ASSERT_EQ(parStats.positions, fens.size());
+        ASSERT_EQ(parStats.errors, seqStats.errors);
+        ASSERT_EQ(parStats.firstErrorOffset, seqStats.firstErrorOffset);
+        ASSERT_EQ(parStats.firstErrorOffset, content.find("invalid line"));
+        ASSERT_EQ(parallel, sequential);
+        for (auto i = 0U; i < fens.size(); i += 97)
+            ASSERT_EQ(parallel[i].toFEN(), fens[i]);
+    }
+
+    TEST_F(APositionFile, PassesThePositionsAndTheirOffsetsToTheCallback)
+    {
+        std::vector<std::string> fens = manyFENs();
+        std::string content;
+        for (auto &f : fens)
+            content += f + "\n";
+        PositionFile pf {writeFile("cmdsuzdal_many.fen", content)};
+
+        std::mutex mtx;
+        std::vector<std::size_t> offsets;
+        ThreadPool pool(4);
+        PositionFileStats stats = pf.forEach([&](const ChessBoard &cb, std::size_t offset) {
+            std::string_view line = pf.contents().substr(offset, content.find('\n', offset) - offset);
+            EXPECT_EQ(cb.toFEN(), line);
+            std::lock_guard<std::mutex> lock(mtx);
+            offsets.push_back(offset);
+        }, pool);
+        ASSERT_EQ(stats.positions, fens.size());
+        ASSERT_EQ(offsets.size(), fens.size());
+
+        std::size_t count = 0;
+        pf.forEach([&count](const ChessBoard &, std::size_t) { count++; });
+        ASSERT_EQ(count, fens.size());
+    }
+
+}   // namespace cSzd
@@ -0,0 +1,172 @@
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/bitboard.h"
+#include "cmdsuzdal/sliderattacks.h"
+
+using namespace std;
+using namespace testing;
+
+namespace cSzd
+{
+    // Reference implementation: explores the rays one cell at a time
+    BitBoardState rayByRayAttacks(Cell c, BitBoardState occupancy, bool diagonals)
+    {
+        const int bishopDirs[4][2] {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+        const int rookDirs[4][2] {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        BitBoardState attacks = EmptyBB;
+        for (auto &d : (diagonals ? bishopDirs : rookDirs)) {
+            Cell t = calcCellAfterSteps(c, d[0], d[1]);
+            while (t != InvalidCell) {
+                attacks |= singlecell(t);
+                if (occupancy & singlecell(t))
+                    break;
+                t = calcCellAfterSteps(t, d[0], d[1]);
+            }
+        }
+        return attacks;
+    }
+
+    // --------------------------------------------------------
+    TEST(SliderAttacksTester, AttacksOnAnEmptyBoardAreTheMasks)
+    {
+        for (auto ndx = 0; ndx < 64; ndx++) {
+            Cell c = static_cast<Cell>(ndx);
+            ASSERT_EQ(bishopAttacks(c, EmptyBB), diagonalsMask(c) ^ singlecell(c));
+            ASSERT_EQ(rookAttacks(c, EmptyBB), fileRankMask(c) ^ singlecell(c));
+            ASSERT_EQ(queenAttacks(c, EmptyBB), queenMask(c) ^ singlecell(c));
+        }
+    }
+
+    // --------------------------------------------------------
+    TEST(SliderAttacksTester, BusyCellsAreTheLastAttackedCellsOfTheRays)
+    {
+        //   _ _ _ _ _ _ _ _
+        // 8| | | | | | | | |
+        // 7| | | | |x| | | |
+        // 6| | | | | | | | |
+        // 5| | |x| | | | | |
+        // 4| | | | |R| |x| |
+        // 3| | | | | | | | |
+        // 2| | |x| | | | | |
+        // 1|_|_|_|_|_|_|_|_|
+        //   a b c d e f g h
+        BitBoardState occupancy = BitBoard({e7, c5, g4, c2, e4}).state();
+        ASSERT_EQ(BitBoard(rookAttacks(e4, occupancy)),
+                  BitBoard({e5, e6, e7, f4, g4, e3, e2, e1, d4, c4, b4, a4}));
+        ASSERT_EQ(BitBoard(bishopAttacks(e4, occupancy)),
+                  BitBoard({f5, g6, h7, d5, c6, b7, a8, f3, g2, h1, d3, c2}));
+        ASSERT_EQ(BitBoard(queenAttacks(e4, occupancy)),
+                  BitBoard(rookAttacks(e4, occupancy) | bishopAttacks(e4, occupancy)));
+    }
+
+    // --------------------------------------------------------
+    TEST(SliderAttacksTester, AttacksWithRandomOccupanciesMatchTheRayByRayComputation)
+    {
+        std::mt19937_64 rng(20210429);
+        for (auto i = 0; i < 2000; i++) {
+            // sparse random occupancy
+            BitBoardState occupancy = rng() & rng();
+            for (auto ndx = 0; ndx < 64; ndx++) {
+                Cell c = static_cast<Cell>(ndx);
+                ASSERT_EQ(bishopAttacks(c, occupancy), rayByRayAttacks(c, occupancy, true));
+                ASSERT_EQ(rookAttacks(c, occupancy), rayByRayAttacks(c, occupancy, false));
+            }
+        }
+    }
+
+    // Relevant occupancy cells of a slider: the cells of the rays on an
+    // empty board excluding the last one of each direction
+    BitBoardState relevantOccupancy(Cell c, bool diagonals)
+    {
+        const int bishopDirs[4][2] {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+        const int rookDirs[4][2] {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        BitBoardState mask = EmptyBB;
+        for (auto &d : (diagonals ? bishopDirs : rookDirs)) {
+            Cell t = calcCellAfterSteps(c, d[0], d[1]);
+            while ((t != InvalidCell) && (calcCellAfterSteps(t, d[0], d[1]) != InvalidCell)) {
+                mask |= singlecell(t);
+                t = calcCellAfterSteps(t, d[0], d[1]);
+            }
+        }
+        return mask;
+    }
+
+    // --------------------------------------------------------
+    TEST(SliderAttacksTester, AttacksOfAllTheRelevantOccupanciesMatchTheRayByRayComputation)
+    {
+        // Every subset of the relevant cells of every cell is checked, so
+        // any destructive collision of the table indexes is detected. The
+        // cells outside the relevant ones are filled with random noise,
+        // that shall not change the attacks
+        std::mt19937_64 rng(20210502);
+        for (auto diagonals : {true, false}) {
+            for (auto ndx = 0; ndx < 64; ndx++) {
+                Cell c = static_cast<Cell>(ndx);
+                BitBoardState mask = relevantOccupancy(c, diagonals);
+                BitBoardState subset = EmptyBB;
+                do {
+                    BitBoardState occupancy = subset | (rng() & ~mask);
+                    BitBoardState attacks = diagonals ? bishopAttacks(c, occupancy) : rookAttacks(c, occupancy);
+                    ASSERT_EQ(attacks, rayByRayAttacks(c, subset, diagonals));
+                    subset = (subset - mask) & mask;
+                } while (subset != EmptyBB);
+            }
+        }
+    }
+
+    // --------------------------------------------------------
+    TEST(SliderAttacksTester, TheTablesOfEachBackendMatchTheRayByRayComputation)
+    {
+        // The magic tables are verified also when the PEXT backend is used
+        ASSERT_TRUE(verifySliderAttacksTables(MagicBackend));
+        if (cpuSliderAttacksBackend() == PextBackend)
+            ASSERT_TRUE(verifySliderAttacksTables(PextBackend));
+        else
+            ASSERT_FALSE(verifySliderAttacksTables(PextBackend));
+    }
+
+    // Lookup made by a static initializer: the tables shall be built also
+    // if the lookup is made before the initialization of the library ones
+    static const BitBoardState StaticInitRookAttacks = rookAttacks(a1, EmptyBB);
+
+    TEST(SliderAttacksTester, LookupsCanBeMadeByTheStaticInitializers)
+    {
+        ASSERT_EQ(StaticInitRookAttacks, fileRankMask(a1) ^ singlecell(a1));
+    }
+
+    // --------------------------------------------------------
+    TEST(SliderAttacksTester, CellsBetweenAlignedAndNotAlignedCells)
+    {
+        ASSERT_EQ(BitBoard(cellsBetween(a1, h8)), BitBoard({b2, c3, d4, e5, f6, g7}));
+        ASSERT_EQ(BitBoard(cellsBetween(h8, a1)), BitBoard({b2, c3, d4, e5, f6, g7}));
+        ASSERT_EQ(BitBoard(cellsBetween(e1, e8)), BitBoard({e2, e3, e4, e5, e6, e7}));
+        ASSERT_EQ(BitBoard(cellsBetween(b7, f7)), BitBoard({c7, d7, e7}));
+        ASSERT_EQ(BitBoard(cellsBetween(h2, b8)), BitBoard({g3, f4, e5, d6, c7}));
+        ASSERT_EQ(cellsBetween(e4, e5), EmptyBB);
+        ASSERT_EQ(cellsBetween(e4, e4), EmptyBB);
+        ASSERT_EQ(cellsBetween(a1, b3), EmptyBB);
+        ASSERT_EQ(cellsBetween(c2, h8), EmptyBB);
+    }
+
+    // --------------------------------------------------------
+    TEST(SliderAttacksTester, TheCPUBackendIsUsedUnlessTheMagicOneIsForcedByTheEnvironment)
+    {
+        const char *forced = std::getenv("CSZD_SLIDER_ATTACKS");
+        if ((forced != nullptr) && (std::strcmp(forced, "magic") == 0))
+            ASSERT_EQ(sliderAttacksBackend(), MagicBackend);
+        else
+            ASSERT_EQ(sliderAttacksBackend(), cpuSliderAttacksBackend());
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        // PEXT is selected only on CPUs supporting BMI2
+        if (cpuSliderAttacksBackend() == PextBackend)
+            ASSERT_TRUE(__builtin_cpu_supports("bmi2"));
+#else
+        ASSERT_EQ(cpuSliderAttacksBackend(), MagicBackend);
+#endif
+    }
+
+} // namespace cSzd
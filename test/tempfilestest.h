@@ -0,0 +1,41 @@
+#if !defined CSZD_TEMPFILESTEST_HEADER
+#define CSZD_TEMPFILESTEST_HEADER
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace cSzd
+{
+    // Fixture of the tests reading files: the files written in the
+    // temporary directory are removed at the end of each test. If a file
+    // cannot be written, the test fails (and the file is missing)
+    class TempFilesTest: public testing::Test {
+        public:
+            std::vector<std::string> files;
+
+            std::string writeFile(const std::string &name, const std::string &content)
+            {
+                std::string fileName = testing::TempDir() + name;
+                std::FILE *f = std::fopen(fileName.c_str(), "wb");
+                if (f == nullptr) {
+                    ADD_FAILURE() << "Cannot write " << fileName;
+                    return fileName;
+                }
+                EXPECT_EQ(std::fwrite(content.data(), 1, content.size(), f), content.size());
+                std::fclose(f);
+                files.push_back(fileName);
+                return fileName;
+            }
+            void TearDown() override
+            {
+                for (auto &f : files)
+                    std::remove(f.c_str());
+            }
+    };
+
+} // namespace cSzd
+
+#endif // #if !defined CSZD_TEMPFILESTEST_HEADER
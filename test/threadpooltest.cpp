@@ -0,0 +1,69 @@
+#include <atomic>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/threadpool.h"
+
+using namespace std;
+using namespace testing;
+
+namespace cSzd
+{
+
+    // --------------------------------------------------------
+    TEST(ThreadPoolTester, APoolHasAtLeastOneThread)
+    {
+        ThreadPool pool(0);
+        ASSERT_EQ(pool.size(), 1);
+        ThreadPool pool4(4);
+        ASSERT_EQ(pool4.size(), 4);
+    }
+
+    // --------------------------------------------------------
+    TEST(ThreadPoolTester, AllTheSubmittedTasksAreExecutedBeforeWaitReturns)
+    {
+        ThreadPool pool(4);
+        std::atomic<int> counter {0};
+        for (auto i = 0; i < 1000; i++)
+            pool.submit([&counter] { ++counter; });
+        pool.wait();
+        ASSERT_EQ(counter, 1000);
+
+        // the pool can be reused after a wait
+        for (auto i = 0; i < 10; i++)
+            pool.submit([&counter] { ++counter; });
+        pool.wait();
+        ASSERT_EQ(counter, 1010);
+    }
+
+    // --------------------------------------------------------
+    TEST(ThreadPoolTester, TasksCanSubmitOtherTasks)
+    {
+        ThreadPool pool(3);
+        std::atomic<int> counter {0};
+        for (auto i = 0; i < 10; i++) {
+            pool.submit([&pool, &counter] {
+                for (auto j = 0; j < 10; j++)
+                    pool.submit([&counter] { ++counter; });
+            });
+        }
+        pool.wait();
+        ASSERT_EQ(counter, 100);
+    }
+
+    // --------------------------------------------------------
+    TEST(ThreadPoolTester, TheExceptionOfATaskIsPropagatedByWait)
+    {
+        ThreadPool pool(2);
+        std::atomic<int> counter {0};
+        pool.submit([] { throw std::runtime_error("task failure"); });
+        for (auto i = 0; i < 10; i++)
+            pool.submit([&counter] { ++counter; });
+        ASSERT_THROW(pool.wait(), std::runtime_error);
+        ASSERT_EQ(counter, 10);
+        // the exception is reported only once
+        pool.wait();
+    }
+
+} // namespace cSzd
@@ -0,0 +1,95 @@
+#include <chrono>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/timemanager.h"
+
+using namespace std;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace cSzd
+{
+
+    // --------------------------------------------------------
+    TEST(TimeManagerTester, WithoutTimeLimitsTheSearchIsNotTimeLimited)
+    {
+        TimeManager tm;
+        SearchLimits limits;
+        limits.depth = 10;
+        tm.start(limits, WhiteArmy);
+        ASSERT_FALSE(tm.isTimeLimited());
+        ASSERT_TRUE(tm.canStartNewIteration());
+        ASSERT_FALSE(tm.timeIsUp());
+    }
+
+    // --------------------------------------------------------
+    TEST(TimeManagerTester, TheFixedTimePerMoveIsUsedLessTheOverhead)
+    {
+        TimeManager tm;
+        SearchLimits limits;
+        limits.moveTime = 500ms;
+        limits.time[WhiteArmy] = 60000ms;
+        tm.start(limits, WhiteArmy);
+        ASSERT_TRUE(tm.isTimeLimited());
+        ASSERT_EQ(tm.optimumTime(), 500ms - TimeManager::MoveOverhead);
+        ASSERT_EQ(tm.maximumTime(), 500ms - TimeManager::MoveOverhead);
+
+        // at least 1 ms is always allocated
+        limits.moveTime = 5ms;
+        tm.start(limits, WhiteArmy);
+        ASSERT_EQ(tm.optimumTime(), 1ms);
+        ASSERT_EQ(tm.maximumTime(), 1ms);
+    }
+
+    // --------------------------------------------------------
+    TEST(TimeManagerTester, TheTimeIsAllocatedFromTheClockOfTheSideToMove)
+    {
+        TimeManager tm;
+        SearchLimits limits;
+        limits.time[WhiteArmy] = 60010ms;
+        limits.time[BlackArmy] = 30010ms;
+        tm.start(limits, WhiteArmy);
+        ASSERT_EQ(tm.optimumTime(), 2000ms);
+        ASSERT_EQ(tm.maximumTime(), 10000ms);
+        tm.start(limits, BlackArmy);
+        ASSERT_EQ(tm.optimumTime(), 1000ms);
+        ASSERT_EQ(tm.maximumTime(), 5000ms);
+
+        // The increment is mostly used
+        limits.increment[BlackArmy] = 2000ms;
+        tm.start(limits, BlackArmy);
+        ASSERT_EQ(tm.optimumTime(), 2500ms);
+        ASSERT_EQ(tm.maximumTime(), 12500ms);
+    }
+
+    // --------------------------------------------------------
+    TEST(TimeManagerTester, TheMovesToGoAreConsidered)
+    {
+        TimeManager tm;
+        SearchLimits limits;
+        limits.time[WhiteArmy] = 10010ms;
+        limits.movesToGo = 10;
+        tm.start(limits, WhiteArmy);
+        ASSERT_EQ(tm.optimumTime(), 1000ms);
+        ASSERT_EQ(tm.maximumTime(), 5000ms);
+        // The last move before the time control can use all the time
+        limits.movesToGo = 1;
+        tm.start(limits, WhiteArmy);
+        ASSERT_EQ(tm.optimumTime(), 10000ms);
+        ASSERT_EQ(tm.maximumTime(), 10000ms);
+    }
+
+    // --------------------------------------------------------
+    TEST(TimeManagerTester, TheAllocatedTimeNeverExceedsTheRemainingTime)
+    {
+        TimeManager tm;
+        SearchLimits limits;
+        limits.time[WhiteArmy] = 5ms;
+        limits.increment[WhiteArmy] = 10000ms;
+        tm.start(limits, WhiteArmy);
+        ASSERT_EQ(tm.optimumTime(), 1ms);
+        ASSERT_EQ(tm.maximumTime(), 1ms);
+    }
+
+} // namespace cSzd
@@ -0,0 +1,130 @@
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/transpositiontable.h"
+
+using namespace std;
+using namespace testing;
+
+namespace cSzd
+{
+
+    // --------------------------------------------------------
+    TEST(TranspositionTableTester, TheNumberOfEntriesDependsOnTheSizeInMB)
+    {
+        TranspositionTable tt(1);
+        ASSERT_EQ(tt.sizeMB(), 1);
+        ASSERT_EQ(tt.numEntries(), (1 << 20) / 16);
+        tt.resize(4);
+        ASSERT_EQ(tt.sizeMB(), 4);
+        ASSERT_EQ(tt.numEntries(), (4 << 20) / 16);
+        tt.resize(0);
+        ASSERT_EQ(tt.numEntries(), 4);
+    }
+
+    // --------------------------------------------------------
+    TEST(TranspositionTableTester, StoredDataAreFoundWithTheSameKey)
+    {
+        TranspositionTable tt(1);
+        TTData d;
+        std::uint64_t key = 0x123456789ABCDEF0ULL;
+        ASSERT_FALSE(tt.probe(key, d));
+
+        ChessMove m = chessMove(Pawn, e7, e8, InvalidPiece, Queen);
+        tt.store(key, m, -1234, 7, LowerBound);
+        ASSERT_TRUE(tt.probe(key, d));
+        ASSERT_EQ(d.move, m);
+        ASSERT_EQ(d.score, -1234);
+        ASSERT_EQ(d.depth, 7);
+        ASSERT_EQ(d.bound, LowerBound);
+        ASSERT_EQ(d.age, 0);
+        ASSERT_FALSE(tt.probe(key ^ 1, d));
+
+        // Updating the entry without a move keeps the old one
+        tt.store(key, InvalidMove, 25, 8, ExactBound);
+        ASSERT_TRUE(tt.probe(key, d));
+        ASSERT_EQ(d.move, m);
+        ASSERT_EQ(d.score, 25);
+        ASSERT_EQ(d.bound, ExactBound);
+
+        tt.clear();
+        ASSERT_FALSE(tt.probe(key, d));
+    }
+
+    // --------------------------------------------------------
+    TEST(TranspositionTableTester, ResizingTheTableClearsIt)
+    {
+        TranspositionTable tt(1);
+        TTData d;
+        tt.store(42, InvalidMove, 0, 1, ExactBound);
+        ASSERT_TRUE(tt.probe(42, d));
+        tt.resize(2);
+        ASSERT_FALSE(tt.probe(42, d));
+    }
+
+    // --------------------------------------------------------
+    TEST(TranspositionTableTester, TheShallowestEntryOfTheBucketIsReplaced)
+    {
+        TranspositionTable tt(1);
+        TTData d;
+        // keys mapped in the same bucket
+        const std::uint64_t stride = tt.numEntries() / 4;
+        for (auto i = 0U; i < 4; i++)
+            tt.store(stride * (i + 1), InvalidMove, 0, 10 - i, ExactBound);
+        tt.store(stride * 5, InvalidMove, 0, 5, ExactBound);
+        ASSERT_TRUE(tt.probe(stride * 1, d));
+        ASSERT_TRUE(tt.probe(stride * 2, d));
+        ASSERT_TRUE(tt.probe(stride * 3, d));
+        ASSERT_FALSE(tt.probe(stride * 4, d));
+        ASSERT_TRUE(tt.probe(stride * 5, d));
+
+        // In a new search, the old entries are replaced first
+        tt.newSearch();
+        tt.store(stride * 6, InvalidMove, 0, 1, ExactBound);
+        tt.store(stride * 7, InvalidMove, 0, 1, ExactBound);
+        ASSERT_TRUE(tt.probe(stride * 6, d));
+        ASSERT_TRUE(tt.probe(stride * 7, d));
+        ASSERT_EQ(d.age, 1);
+        ASSERT_TRUE(tt.probe(stride * 1, d));
+    }
+
+    // --------------------------------------------------------
+    TEST(TranspositionTableTester, HashfullCountsTheEntriesOfTheCurrentSearch)
+    {
+        TranspositionTable tt(1);
+        ASSERT_EQ(tt.hashfull(), 0);
+        for (std::uint64_t key = 0; key < tt.numEntries(); key++)
+            tt.store(key * 0x9E3779B97F4A7C15ULL, InvalidMove, 0, 1, ExactBound);
+        ASSERT_GT(tt.hashfull(), 500);
+        tt.newSearch();
+        ASSERT_EQ(tt.hashfull(), 0);
+    }
+
+    // --------------------------------------------------------
+    TEST(TranspositionTableTester, ConcurrentAccessesNeverReturnCorruptedData)
+    {
+        // A small table and many threads writing the same buckets: the
+        // data found for a key shall always be the ones stored for it
+        TranspositionTable tt(0);
+        std::vector<std::thread> threads;
+        for (auto t = 0; t < 4; t++) {
+            threads.emplace_back([&tt, t] {
+                TTData d;
+                for (std::uint64_t i = 0; i < 200000; i++) {
+                    std::uint64_t key = (i % 64) * 0x9E3779B97F4A7C15ULL + 1;
+                    int score = static_cast<int>(key % 30000);
+                    tt.store(key, ChessMove(t), score, (key >> 8) % 64, ExactBound);
+                    if (tt.probe(key, d)) {
+                        ASSERT_EQ(d.score, score);
+                        ASSERT_EQ(d.depth, (key >> 8) % 64);
+                    }
+                }
+            });
+        }
+        for (auto &th : threads)
+            th.join();
+    }
+
+} // namespace cSzd
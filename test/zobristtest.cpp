@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <iterator>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "cmdsuzdal/zobrist.h"
+#include "cmdsuzdal/chessboard.h"
+
+using namespace std;
+using namespace testing;
+
+namespace cSzd
+{
+
+    // --------------------------------------------------------
+    TEST(ZobristTester, TheKeysAreAllDifferent)
+    {
+        std::vector<std::uint64_t> keys;
+        for (auto a = 0; a < 2; a++)
+            for (auto p = 0U; p < NumPieceTypes; p++)
+                for (auto c = 0; c < 64; c++)
+                    keys.push_back(Zobrist.pieces[a][p][c]);
+        keys.push_back(Zobrist.blackToMove);
+        keys.insert(keys.end(), std::begin(Zobrist.castling), std::end(Zobrist.castling));
+        keys.insert(keys.end(), std::begin(Zobrist.enPassantFile), std::end(Zobrist.enPassantFile));
+        std::sort(keys.begin(), keys.end());
+        ASSERT_TRUE(std::adjacent_find(keys.begin(), keys.end()) == keys.end());
+    }
+
+    // --------------------------------------------------------
+    TEST(ZobristTester, TheSamePositionReachedWithDifferentMoveOrdersHasTheSameKey)
+    {
+        ChessBoard cb1;
+        cb1.doMove(chessMove(Knight, g1, f3));
+        cb1.doMove(chessMove(Knight, g8, f6));
+        cb1.doMove(chessMove(Knight, b1, c3));
+        ChessBoard cb2;
+        cb2.doMove(chessMove(Knight, b1, c3));
+        cb2.doMove(chessMove(Knight, g8, f6));
+        cb2.doMove(chessMove(Knight, g1, f3));
+        ASSERT_EQ(zobristKey(cb1), zobristKey(cb2));
+        ASSERT_EQ(zobristKey(cb1), zobristKey(ChessBoard("rnbqkb1r/pppppppp/5n2/8/8/2N2N2/PPPPPPPP/R1BQKB1R b KQkq - 3 2")));
+    }
+
+    // --------------------------------------------------------
+    TEST(ZobristTester, SideToMoveCastlingRightsAndEnPassantChangeTheKey)
+    {
+        std::uint64_t key = zobristKey(ChessBoard("r3k2r/8/8/3pP3/8/8/8/R3K2R w KQkq d6 0 1"));
+        ASSERT_EQ(zobristKey(ChessBoard("r3k2r/8/8/3pP3/8/8/8/R3K2R w KQkq d6 0 1")), key);
+        ASSERT_EQ(zobristKey(ChessBoard("r3k2r/8/8/3pP3/8/8/8/R3K2R w KQkq d6 10 20")), key);
+        ASSERT_NE(zobristKey(ChessBoard("r3k2r/8/8/3pP3/8/8/8/R3K2R w KQkq - 0 1")), key);
+        ASSERT_NE(zobristKey(ChessBoard("r3k2r/8/8/3pP3/8/8/8/R3K2R w Qkq d6 0 1")), key);
+        ASSERT_NE(zobristKey(ChessBoard("r3k2r/8/8/3pP3/8/8/8/R3K2R w Kkq d6 0 1")), key);
+        ASSERT_NE(zobristKey(ChessBoard("r3k2r/8/8/3pP3/8/8/8/R3K2R w KQq d6 0 1")), key);
+        ASSERT_NE(zobristKey(ChessBoard("r3k2r/8/8/3pP3/8/8/8/R3K2R w KQk d6 0 1")), key);
+        ASSERT_NE(zobristKey(ChessBoard("r3k2r/8/8/3pP3/8/8/8/R3K2R b KQkq - 0 1")),
+                  zobristKey(ChessBoard("r3k2r/8/8/3pP3/8/8/8/R3K2R w KQkq - 0 1")));
+    }
+    // --------------------------------------------------------
+    // Walks the moves tree checking that the key updated incrementally by
+    // doMove() and undoMove() is always equal to the key computed from scratch
+    static void checkIncrementalKeyOfTheMovesTree(ChessBoard &cb, unsigned int depth)
+    {
+        ASSERT_EQ(cb.hashKey, zobristKey(cb));
+        if (depth == 0)
+            return;
+        MoveList moves;
+        cb.generateLegalMoves(moves);
+        for (auto &m : moves) {
+            std::uint64_t keyBefore = cb.hashKey;
+            UndoInfo undo = cb.doMove(m);
+            checkIncrementalKeyOfTheMovesTree(cb, depth - 1);
+            cb.undoMove(m, undo);
+            ASSERT_EQ(cb.hashKey, keyBefore);
+        }
+    }
+    TEST(ZobristTester, TheIncrementalKeyIsEqualToTheKeyComputedFromScratch)
+    {
+        ChessBoard cb;
+        ASSERT_EQ(cb.hashKey, zobristKey(cb));
+        // Castling, captures of rooks, promotions and en passant captures
+        for (auto fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                         "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+                         "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                         "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"}) {
+            cb.loadPosition(fen);
+            checkIncrementalKeyOfTheMovesTree(cb, 3);
+        }
+    }
+
+    // --------------------------------------------------------
+    TEST(ZobristTester, TheKeyIsUpdatedAfterADirectModificationOfTheBoard)
+    {
+        ChessBoard cb1;
+        ChessBoard cb2 {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1"};
+        ASSERT_NE(cb1.hashKey, cb2.hashKey);
+        ASSERT_TRUE(cb1 != cb2);
+        // The boards are equal, but the key is stale until it is updated
+        cb2.sideToMove = WhiteArmy;
+        ASSERT_TRUE(cb1 == cb2);
+        ASSERT_NE(cb1.hashKey, cb2.hashKey);
+        cb2.updateHashKey();
+        ASSERT_EQ(cb1.hashKey, cb2.hashKey);
+        ASSERT_TRUE(cb1 == cb2);
+    }
+
+} // namespace cSzd
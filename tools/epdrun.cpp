@@ -0,0 +1,267 @@
+// -----------------------------------------------------------------------------
+// cmdsuzdal_epdrun: EPD test suites runner of the Commander Suzdal Library
+//
+// Usage:
+//   cmdsuzdal_epdrun [options] <EPD file>
+//      searches each position of the file with the AlphaBetaEngine and
+//      checks the selected move against the best moves (bm) and the moves
+//      to avoid (am) of the record. The records without bm and am
+//      operations are skipped
+//   cmdsuzdal_epdrun [options] --perft [<max depth>] <EPD file>
+//      verifies the perft counts (D1..Dn operations) of each position, up
+//      to the specified depth (default: all the counts)
+// The positions are processed in parallel; the results are reported in the
+// order of the file, followed by the number of solved positions, the time
+// per position and the total nodes per second. The exit status is not zero
+// if the file cannot be read, if some records are not valid or if some
+// perft counts are wrong (the perft mode is also executed by CTest).
+//
+// Options:
+//   --threads <n>    number of positions processed in parallel (default:
+//                    the number of hardware threads)
+//   --depth <n>      search depth (default 0, no limit)
+//   --movetime <ms>  search time per position (default 1000 ms, when the
+//                    depth is not specified)
+//   --hash <MB>      size of the transposition table of each search
+//                    (default 16)
+// -----------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cmdsuzdal/alphabetaengine.h"
+#include "cmdsuzdal/epdrecord.h"
+#include "cmdsuzdal/perft.h"
+#include "cmdsuzdal/positionfile.h"
+
+using namespace cSzd;
+
+namespace
+{
+    struct EPDRunOptions {
+        unsigned int threads = std::max(std::thread::hardware_concurrency(), 1U);
+        bool perft = false;
+        unsigned int maxPerftDepth = ~0U;
+        unsigned int depth = 0;
+        std::chrono::milliseconds moveTime {0};
+        std::size_t hashMB = 16;
+    };
+
+    enum EPDResult : unsigned int { Solved, NotSolved, Skipped, InvalidRecord };
+
+    struct EPDRunEntry {
+        std::string line;
+        std::size_t lineNumber = 0;
+        EPDResult result = Skipped;
+        std::string detail;
+        std::uint64_t nodes = 0;
+        double seconds = 0.0;
+    };
+
+    double elapsedSeconds(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::string uciMoves(const std::vector<ChessMove> &moves)
+    {
+        std::ostringstream os;
+        for (auto &m : moves)
+            printUCIMove(os << ((&m == &moves[0]) ? "" : " "), m);
+        return os.str();
+    }
+
+    // --------------------------------------------------------------
+    void runPerft(const EPDRecord &record, const EPDRunOptions &options, EPDRunEntry &entry)
+    {
+        std::vector<EPDPerftCount> counts = record.perftCounts();
+        ChessBoard cb = record.board();
+        entry.result = Skipped;
+        std::ostringstream os;
+        for (auto &c : counts) {
+            if (c.depth > options.maxPerftDepth)
+                continue;
+            std::uint64_t nodes = perft(cb, c.depth);
+            entry.nodes += nodes;
+            os << "D" << c.depth << " " << nodes;
+            if (nodes != c.nodes) {
+                os << " (expected " << c.nodes << ")";
+                entry.result = NotSolved;
+            }
+            else if (entry.result == Skipped) {
+                entry.result = Solved;
+            }
+            os << "; ";
+        }
+        entry.detail = os.str();
+    }
+
+    void runSearch(const EPDRecord &record, const EPDRunOptions &options, EPDRunEntry &entry)
+    {
+        std::vector<ChessMove> best = record.bestMoves();
+        std::vector<ChessMove> avoid = record.avoidMoves();
+        if (best.empty() && avoid.empty()) {
+            entry.result = Skipped;
+            return;
+        }
+
+        AlphaBetaEngine engine {options.hashMB, 1};
+        engine.setLimits(SearchLimits{options.depth, 0, options.moveTime});
+        ChessMove m = engine.move(record.board());
+        entry.nodes = engine.lastSearchInfo().nodes;
+
+        bool ok = (best.empty() || (std::find(best.begin(), best.end(), m) != best.end())) &&
+                  (std::find(avoid.begin(), avoid.end(), m) == avoid.end());
+        entry.result = ok ? Solved : NotSolved;
+        std::ostringstream os;
+        printUCIMove(os, m);
+        if (!best.empty())
+            os << " (bm " << uciMoves(best) << ")";
+        if (!avoid.empty())
+            os << " (am " << uciMoves(avoid) << ")";
+        entry.detail = os.str();
+    }
+
+    void runEntry(const EPDRunOptions &options, EPDRunEntry &entry)
+    {
+        auto start = std::chrono::steady_clock::now();
+        EPDRecord record;
+        FENError e = record.loadRecord(entry.line);
+        if (e != FENNoError) {
+            entry.result = InvalidRecord;
+            entry.detail = fenErrorDescription(e);
+        }
+        else if (options.perft) {
+            runPerft(record, options, entry);
+        }
+        else {
+            runSearch(record, options, entry);
+        }
+        entry.seconds = elapsedSeconds(start);
+        if (!record.id().empty())
+            entry.detail = "[" + record.id() + "] " + entry.detail;
+    }
+
+    // --------------------------------------------------------------
+    int runSuite(const std::string &fileName, const EPDRunOptions &options)
+    {
+        PositionFile file;
+        if (!file.open(fileName)) {
+            std::cerr << "Cannot read " << fileName << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // The not blank lines of the file
+        std::vector<EPDRunEntry> entries;
+        std::string_view contents = file.contents();
+        std::size_t lineNumber = 0;
+        for (const char *p = contents.data(), *end = p + contents.size(); p < end; ) {
+            const char *eol = findNewline(p, end);
+            std::string line(p, static_cast<std::size_t>(eol - p));
+            lineNumber++;
+            p = eol + 1;
+            if (line.find_first_not_of(" \t\r") != std::string::npos) {
+                entries.emplace_back();
+                entries.back().line = line;
+                entries.back().lineNumber = lineNumber;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            ThreadPool pool(options.threads);
+            for (auto &entry : entries)
+                pool.submit([&options, &entry] { runEntry(options, entry); });
+            pool.wait();
+        }
+        double seconds = elapsedSeconds(start);
+
+        const char *resultNames[] = {"OK     ", "FAIL   ", "SKIP   ", "INVALID"};
+        unsigned int count[4] = {};
+        std::uint64_t nodes = 0;
+        double positionSeconds = 0.0;
+        for (auto &entry : entries) {
+            count[entry.result]++;
+            nodes += entry.nodes;
+            positionSeconds += entry.seconds;
+            std::cout << std::setw(5) << entry.lineNumber << " " << resultNames[entry.result] << " "
+                      << std::fixed << std::setprecision(3) << entry.seconds << " s  " << entry.detail << std::endl;
+        }
+        unsigned int run = count[Solved] + count[NotSolved];
+        std::cout << std::endl << "Solved:   " << count[Solved] << " / " << run;
+        if (count[Skipped] > 0)
+            std::cout << " (" << count[Skipped] << " skipped)";
+        if (count[InvalidRecord] > 0)
+            std::cout << " (" << count[InvalidRecord] << " invalid)";
+        std::cout << std::endl;
+        std::cout << "Time:     " << std::fixed << std::setprecision(3) << seconds << " s ("
+                  << ((run > 0) ? positionSeconds / run : 0.0) << " s per position, "
+                  << options.threads << " threads)" << std::endl;
+        std::cout << "Nodes:    " << nodes << std::endl;
+        std::cout << "NPS:      " << ((seconds > 0.0) ? static_cast<std::uint64_t>(nodes / seconds) : 0) << std::endl;
+
+        bool failed = (count[InvalidRecord] > 0) || (options.perft && (count[NotSolved] > 0));
+        return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    // --------------------------------------------------------------
+    int usage(const char *progName)
+    {
+        std::cerr << "Usage: " << progName << " [options] <EPD file>" << std::endl;
+        std::cerr << "       " << progName << " [options] --perft [<max depth>] <EPD file>" << std::endl;
+        std::cerr << "Options:" << std::endl;
+        std::cerr << "  --threads <n>    positions processed in parallel (default: hardware threads)" << std::endl;
+        std::cerr << "  --depth <n>      search depth (default 0, no limit)" << std::endl;
+        std::cerr << "  --movetime <ms>  search time per position (default 1000 ms without depth)" << std::endl;
+        std::cerr << "  --hash <MB>      transposition table size of each search (default 16)" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    bool isNumber(const std::string &s)
+    {
+        return !s.empty() && std::all_of(s.begin(), s.end(), [](char ch) { return (ch >= '0') && (ch <= '9'); });
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        EPDRunOptions options;
+        std::vector<std::string> args;
+        for (auto i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if ((arg == "--threads") && (i + 1 < argc))
+                options.threads = std::stoul(argv[++i]);
+            else if ((arg == "--depth") && (i + 1 < argc))
+                options.depth = std::stoul(argv[++i]);
+            else if ((arg == "--movetime") && (i + 1 < argc))
+                options.moveTime = std::chrono::milliseconds(std::stoul(argv[++i]));
+            else if ((arg == "--hash") && (i + 1 < argc))
+                options.hashMB = std::stoul(argv[++i]);
+            else if (arg == "--perft") {
+                options.perft = true;
+                if ((i + 2 < argc) && isNumber(argv[i + 1]))
+                    options.maxPerftDepth = std::stoul(argv[++i]);
+            }
+            else
+                args.push_back(arg);
+        }
+        if ((args.size() != 1) || (options.threads == 0))
+            return usage(argv[0]);
+        if ((options.depth == 0) && (options.moveTime.count() == 0))
+            options.moveTime = std::chrono::milliseconds(1000);
+        return runSuite(args[0], options);
+    }
+    catch (const std::logic_error &) {
+        // a numeric argument is not a number
+        return usage(argv[0]);
+    }
+}
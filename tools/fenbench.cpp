@@ -0,0 +1,147 @@
+// -----------------------------------------------------------------------------
+// cmdsuzdal_fenbench: FEN serialization and parsing benchmark of the
+// Commander Suzdal Library
+//
+// Usage:
+//   cmdsuzdal_fenbench [--iterations <n>] [--depth <d>]
+//      collects the positions reached in <d> plies (default 2) from a set
+//      of reference positions, then measures the speed (positions per
+//      second) of ChessBoard::toFEN(), of ChessBoard::loadPosition() from
+//      a FEN string and of the round trip, repeating each measure <n>
+//      times (default 10) on all the positions. The round trip shall
+//      give back the same position: the exit status is not zero if it
+//      does not (the benchmark is also executed by CTest)
+// -----------------------------------------------------------------------------
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cmdsuzdal/chessboard.h"
+
+using namespace cSzd;
+
+namespace
+{
+    const std::vector<const char *> ReferencePositions {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    };
+
+    void collectPositions(ChessBoard &cb, unsigned int depth, std::vector<ChessBoard> &positions)
+    {
+        positions.push_back(cb);
+        if (depth == 0)
+            return;
+        MoveList moves;
+        cb.generateLegalMoves(moves);
+        for (auto &m : moves) {
+            UndoInfo undo = cb.doMove(m);
+            collectPositions(cb, depth - 1, positions);
+            cb.undoMove(m, undo);
+        }
+    }
+
+    double elapsedSeconds(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void printSpeed(const char *name, std::uint64_t positions, double seconds)
+    {
+        std::cout << std::left << std::setw(14) << name << std::right << std::setw(12)
+                  << ((seconds > 0.0) ? static_cast<std::uint64_t>(positions / seconds) : 0)
+                  << " positions/s  (" << std::fixed << std::setprecision(1)
+                  << ((positions > 0) ? seconds * 1e9 / positions : 0.0) << " ns/position)"
+                  << std::endl;
+    }
+
+    // --------------------------------------------------------------
+    int runBenchmark(unsigned int iterations, unsigned int depth)
+    {
+        std::vector<ChessBoard> positions;
+        for (auto fen : ReferencePositions) {
+            ChessBoard cb {fen};
+            collectPositions(cb, depth, positions);
+        }
+
+        // The FEN strings are written in a single buffer, as in a pipeline
+        // emitting them
+        std::vector<char> fens(positions.size() * MaxFENLength);
+        std::vector<std::size_t> lengths(positions.size());
+        std::uint64_t total = std::uint64_t(iterations) * positions.size();
+        std::cout << "Positions:    " << positions.size() << " x " << iterations << " iterations" << std::endl;
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto it = 0U; it < iterations; it++) {
+            for (auto i = 0U; i < positions.size(); i++)
+                lengths[i] = positions[i].toFEN(&fens[i * MaxFENLength]);
+        }
+        printSpeed("toFEN", total, elapsedSeconds(start));
+
+        ChessBoard loaded;
+        std::uint64_t checksum = 0;
+        start = std::chrono::steady_clock::now();
+        for (auto it = 0U; it < iterations; it++) {
+            for (auto i = 0U; i < positions.size(); i++) {
+                loaded.loadPosition(std::string_view(&fens[i * MaxFENLength], lengths[i]));
+                checksum += loaded.hashKey;
+            }
+        }
+        printSpeed("loadPosition", total, elapsedSeconds(start));
+
+        unsigned int failures = 0;
+        char buf[MaxFENLength];
+        start = std::chrono::steady_clock::now();
+        for (auto it = 0U; it < iterations; it++) {
+            for (auto &cb : positions) {
+                std::size_t len = cb.toFEN(buf);
+                if ((loaded.loadPosition(std::string_view(buf, len)) != FENNoError) || (loaded != cb)) {
+                    if (failures++ == 0)
+                        std::cerr << "Round trip failed: " << buf << std::endl;
+                }
+            }
+        }
+        printSpeed("round trip", total, elapsedSeconds(start));
+        std::cout << "Checksum:     " << std::hex << checksum << std::dec << std::endl;
+        std::cout << "Failures:     " << failures << std::endl;
+        return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // --------------------------------------------------------------
+    int usage(const char *progName)
+    {
+        std::cerr << "Usage: " << progName << " [--iterations <n>] [--depth <d>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        unsigned int iterations = 10;
+        unsigned int depth = 2;
+        for (auto i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if ((arg == "--iterations") && (i + 1 < argc))
+                iterations = std::stoul(argv[++i]);
+            else if ((arg == "--depth") && (i + 1 < argc))
+                depth = std::stoul(argv[++i]);
+            else
+                return usage(argv[0]);
+        }
+        return runBenchmark(iterations, depth);
+    }
+    catch (const std::logic_error &) {
+        // a numeric argument is not a number
+        return usage(argv[0]);
+    }
+}
@@ -0,0 +1,241 @@
+// -----------------------------------------------------------------------------
+// cmdsuzdal_perft: perft driver of the Commander Suzdal Library
+//
+// Usage:
+//   cmdsuzdal_perft [options] "<FEN string>" <depth>
+//      prints the number of leaf nodes reached from each legal move of the
+//      position ("divide" output), the total number of nodes and the speed
+//   cmdsuzdal_perft [options] --suite [<max depth>]
+//      runs the built-in suite of reference positions, comparing the results
+//      with the well known expected values. The exit status is not zero if
+//      any of the results is wrong (the suite is also executed by CTest)
+//
+// Options:
+//   --threads <n>   number of threads used to split the tree (default 1)
+//   --hash <MB>     size of the shared hash table of the subtrees results
+//                   (default 0, no hash table)
+//   --speedup       repeats the count with a single thread and reports the
+//                   speed-up obtained with the specified number of threads
+// -----------------------------------------------------------------------------
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cmdsuzdal/perft.h"
+
+using namespace cSzd;
+
+namespace
+{
+    // --- Reference positions ------------------------
+    // Sources: the Chess Programming Wiki "Perft Results" page (standard
+    // positions) and the well known list of perft positions by Martin Sedlak
+    // (special cases of en passant, castling and promotion)
+    struct PerftResult {
+        unsigned int depth;
+        std::uint64_t nodes;
+    };
+    struct PerftSuiteEntry {
+        const char *name;
+        const char *fen;
+        std::vector<PerftResult> expected;
+    };
+
+    const std::vector<PerftSuiteEntry> PerftSuite {
+        {"Initial position", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+            {{1, 20}, {2, 400}, {3, 8902}, {4, 197281}, {5, 4865609}}},
+        {"Kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+            {{1, 48}, {2, 2039}, {3, 97862}, {4, 4085603}}},
+        {"Position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+            {{1, 14}, {2, 191}, {3, 2812}, {4, 43238}, {5, 674624}}},
+        {"Position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+            {{1, 6}, {2, 264}, {3, 9467}, {4, 422333}}},
+        {"Position 4 mirrored", "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+            {{1, 6}, {2, 264}, {3, 9467}, {4, 422333}}},
+        {"Position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+            {{1, 44}, {2, 1486}, {3, 62379}, {4, 2103487}}},
+        {"Position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+            {{1, 46}, {2, 2079}, {3, 89890}, {4, 3894594}}},
+        {"Illegal en passant (pin)", "3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1", {{6, 1134888}}},
+        {"Illegal en passant (discovered check)", "8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1", {{6, 1015133}}},
+        {"En passant capture checks opponent", "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", {{6, 1440467}}},
+        {"Short castling gives check", "5k2/8/8/8/8/8/8/4K2R w K - 0 1", {{6, 661072}}},
+        {"Long castling gives check", "3k4/8/8/8/8/8/8/R3K3 w Q - 0 1", {{6, 803711}}},
+        {"Castling rights", "r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1", {{4, 1274206}}},
+        {"Castling prevented", "r3k2r/8/3Q4/8/8/5q2/8/R3K2R b KQkq - 0 1", {{4, 1720476}}},
+        {"Promote out of check", "2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1", {{6, 3821001}}},
+        {"Discovered check", "8/8/1P2K3/8/2n5/1q6/8/5k2 b - - 0 1", {{5, 1004658}}},
+        {"Promote to give check", "4k3/1P6/8/8/8/8/K7/8 w - - 0 1", {{6, 217342}}},
+        {"Underpromote to check", "8/P1k5/K7/8/8/8/8/8 w - - 0 1", {{6, 92683}}},
+        {"Self stalemate", "K1k5/8/P7/8/8/8/8/8 w - - 0 1", {{6, 2217}}},
+        {"Stalemate and checkmate", "8/k1P5/8/1K6/8/8/8/8 w - - 0 1", {{7, 567584}}},
+        {"Double check", "8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1", {{4, 23527}}},
+    };
+
+    // --------------------------------------------------------------
+    struct PerftOptions {
+        unsigned int threads = 1;
+        std::size_t hashMB = 0;
+        bool speedup = false;
+    };
+
+    double elapsedSeconds(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::uint64_t nodesPerSecond(std::uint64_t nodes, double seconds)
+    {
+        return (seconds > 0.0) ? static_cast<std::uint64_t>(nodes / seconds) : 0;
+    }
+
+    // Perft divide using the specified number of threads and hash table
+    // size (a new hash table is used for each run, so the timings of
+    // different runs can be compared)
+    std::vector<PerftDivideEntry> divide(const ChessBoard &cb, unsigned int depth,
+                                         unsigned int threads, std::size_t hashMB,
+                                         double &seconds)
+    {
+        std::unique_ptr<PerftHashTable> hashTable;
+        if (hashMB > 0)
+            hashTable = std::make_unique<PerftHashTable>(hashMB);
+        std::vector<PerftDivideEntry> entries;
+        auto start = std::chrono::steady_clock::now();
+        if (threads > 1) {
+            ThreadPool pool(threads);
+            entries = perftDivide(cb, depth, pool, hashTable.get());
+        }
+        else {
+            entries = perftDivide(cb, depth, hashTable.get());
+        }
+        seconds = elapsedSeconds(start);
+        return entries;
+    }
+
+    std::uint64_t totalNodes(const std::vector<PerftDivideEntry> &entries, unsigned int depth)
+    {
+        std::uint64_t nodes = (depth == 0) ? 1 : 0;
+        for (auto &e : entries)
+            nodes += e.nodes;
+        return nodes;
+    }
+
+    void printSpeedup(const ChessBoard &cb, unsigned int depth, const PerftOptions &options,
+                      double seconds, const char *indent)
+    {
+        double singleThreadSeconds;
+        divide(cb, depth, 1, options.hashMB, singleThreadSeconds);
+        std::cout << indent << "Speed-up: " << std::fixed << std::setprecision(2)
+                  << ((seconds > 0.0) ? singleThreadSeconds / seconds : 0.0) << " ("
+                  << options.threads << " threads vs 1 thread, " << std::setprecision(3)
+                  << singleThreadSeconds << " s)" << std::endl;
+    }
+
+    // --------------------------------------------------------------
+    int runDivide(const std::string &fen, unsigned int depth, const PerftOptions &options)
+    {
+        ChessBoard cb {fen};
+        if (!cb.isValid()) {
+            std::cerr << "Invalid position: " << fen << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        double seconds;
+        auto entries = divide(cb, depth, options.threads, options.hashMB, seconds);
+        for (auto &e : entries)
+            printUCIMove(std::cout, e.move) << ": " << e.nodes << std::endl;
+        std::uint64_t nodes = totalNodes(entries, depth);
+        std::cout << std::endl << "Moves:    " << entries.size() << std::endl;
+        std::cout << "Nodes:    " << nodes << std::endl;
+        std::cout << "Time:     " << std::fixed << std::setprecision(3) << seconds << " s" << std::endl;
+        std::cout << "NPS:      " << nodesPerSecond(nodes, seconds) << std::endl;
+        if (options.speedup)
+            printSpeedup(cb, depth, options, seconds, "");
+        return EXIT_SUCCESS;
+    }
+
+    // --------------------------------------------------------------
+    int runSuite(unsigned int maxDepth, const PerftOptions &options)
+    {
+        unsigned int failures = 0;
+        std::uint64_t suiteNodes = 0;
+        auto suiteStart = std::chrono::steady_clock::now();
+        for (auto &entry : PerftSuite) {
+            ChessBoard cb {entry.fen};
+            std::cout << entry.name << " [" << entry.fen << "]" << std::endl;
+            for (auto &result : entry.expected) {
+                if (result.depth > maxDepth)
+                    continue;
+                double seconds;
+                auto entries = divide(cb, result.depth, options.threads, options.hashMB, seconds);
+                std::uint64_t nodes = totalNodes(entries, result.depth);
+                bool ok = (nodes == result.nodes);
+                std::cout << "  depth " << result.depth << ": " << std::setw(10) << nodes
+                          << (ok ? "  OK  " : "  FAIL") << " (expected " << result.nodes
+                          << ", " << nodesPerSecond(nodes, seconds) << " nps)" << std::endl;
+                if (!ok)
+                    ++failures;
+                suiteNodes += nodes;
+            }
+        }
+        double seconds = elapsedSeconds(suiteStart);
+        std::cout << std::endl << "Nodes:    " << suiteNodes << std::endl;
+        std::cout << "Time:     " << std::fixed << std::setprecision(3) << seconds << " s" << std::endl;
+        std::cout << "NPS:      " << nodesPerSecond(suiteNodes, seconds) << std::endl;
+        std::cout << "Failures: " << failures << std::endl;
+        return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // --------------------------------------------------------------
+    int usage(const char *progName)
+    {
+        std::cerr << "Usage: " << progName << " [options] \"<FEN string>\" <depth>" << std::endl;
+        std::cerr << "       " << progName << " [options] --suite [<max depth>]" << std::endl;
+        std::cerr << "Options:" << std::endl;
+        std::cerr << "  --threads <n>  number of threads (default 1)" << std::endl;
+        std::cerr << "  --hash <MB>    size of the hash table (default 0, no hash table)" << std::endl;
+        std::cerr << "  --speedup      reports the speed-up over a single thread" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        PerftOptions options;
+        std::vector<std::string> args;
+        for (auto i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if ((arg == "--threads") && (i + 1 < argc))
+                options.threads = std::stoul(argv[++i]);
+            else if ((arg == "--hash") && (i + 1 < argc))
+                options.hashMB = std::stoul(argv[++i]);
+            else if (arg == "--speedup")
+                options.speedup = true;
+            else
+                args.push_back(arg);
+        }
+        if (options.threads == 0)
+            return usage(argv[0]);
+
+        if (!args.empty() && (args[0] == "--suite")) {
+            if (args.size() > 2)
+                return usage(argv[0]);
+            unsigned int maxDepth = (args.size() == 2) ? std::stoul(args[1]) : ~0U;
+            return runSuite(maxDepth, options);
+        }
+        if (args.size() != 2)
+            return usage(argv[0]);
+        return runDivide(args[0], std::stoul(args[1]), options);
+    }
+    catch (const std::logic_error &) {
+        // a numeric argument is not a number
+        return usage(argv[0]);
+    }
+}
@@ -0,0 +1,93 @@
+// -----------------------------------------------------------------------------
+// cmdsuzdal_pgnbench: PGN import benchmark of the Commander Suzdal Library
+//
+// Usage:
+//   cmdsuzdal_pgnbench [--threads <n>] [--offset <offset>] <PGN file>
+//      decodes all the games of the file (replaying their moves), with <n>
+//      threads (default: the number of hardware threads; 0 decodes the
+//      file in the main thread), starting from the first game at or after
+//      <offset> (default 0). Reports the number of games, moves and errors
+//      (with the offset of the first invalid game) and the import speed in
+//      games and moves per second. The exit status is not zero if the file
+//      cannot be read
+// -----------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "cmdsuzdal/pgnfile.h"
+
+using namespace cSzd;
+
+namespace
+{
+    int usage(const char *progName)
+    {
+        std::cerr << "Usage: " << progName << " [--threads <n>] [--offset <offset>] <PGN file>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        unsigned int threads = std::max(std::thread::hardware_concurrency(), 1U);
+        std::size_t offset = 0;
+        std::string fileName;
+        for (auto i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if ((arg == "--threads") && (i + 1 < argc))
+                threads = std::stoul(argv[++i]);
+            else if ((arg == "--offset") && (i + 1 < argc))
+                offset = std::stoull(argv[++i]);
+            else if (fileName.empty())
+                fileName = arg;
+            else
+                return usage(argv[0]);
+        }
+        if (fileName.empty())
+            return usage(argv[0]);
+
+        PGNFile file;
+        if (!file.open(fileName)) {
+            std::cerr << "Cannot read " << fileName << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        PGNFileStats stats;
+        if (threads == 0) {
+            stats = file.forEach([](const PGNGame &) {}, offset);
+        }
+        else {
+            ThreadPool pool(threads);
+            stats = file.forEach([](const PGNGame &) {}, pool, offset);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Games:    " << stats.games << std::endl;
+        std::cout << "Moves:    " << stats.moves << std::endl;
+        std::cout << "Errors:   " << stats.errors;
+        if (stats.errors > 0)
+            std::cout << " (first: " << pgnErrorDescription(stats.firstError) << ", offset " << stats.firstErrorOffset << ")";
+        std::cout << std::endl;
+        std::cout << "Size:     " << std::fixed << std::setprecision(1)
+                  << file.contents().size() / (1024.0 * 1024.0) << " MB" << std::endl;
+        std::cout << "Time:     " << std::setprecision(3) << seconds << " s (" << threads << " threads)" << std::endl;
+        if (seconds > 0.0) {
+            std::cout << "Games/s:  " << static_cast<std::uint64_t>(stats.games / seconds) << std::endl;
+            std::cout << "Moves/s:  " << static_cast<std::uint64_t>(stats.moves / seconds) << std::endl;
+        }
+        return EXIT_SUCCESS;
+    }
+    catch (const std::logic_error &) {
+        // a numeric argument is not a number
+        return usage(argv[0]);
+    }
+}